@@ -0,0 +1,21 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local RequireModules = UE.UUnLuaBenchmarkFunctionLibrary.RequireModules
+local RequireModulesFromArchive = UE.UUnLuaBenchmarkFunctionLibrary.RequireModulesFromArchive
+
+--- starting a project of generated modules, from loose files against from a script archive
+---@param NumModules integer @3000 by default
+function M.Run(NumModules)
+	NumModules = NumModules or 3000
+	Start("Archive", 1)
+	-- generates the modules and warms the file cache
+	RequireModules(NumModules, false)
+	RequireModules(NumModules, false)
+	RequireModulesFromArchive(NumModules, false)
+	RequireModulesFromArchive(NumModules, true)
+	Stop()
+end
+
+return M
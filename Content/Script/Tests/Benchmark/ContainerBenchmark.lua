@@ -0,0 +1,136 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+
+local function RunArray(Name, Array, Value, N, Passes)
+	for _ = 1, N do
+		Array:Add(Value)
+	end
+
+	StartTimer(Name .. " TArray Get")
+	for _ = 1, Passes do
+		for i = 1, N do
+			local _ = Array:Get(i)
+		end
+	end
+	StopTimer()
+
+	StartTimer(Name .. " TArray Set")
+	for _ = 1, Passes do
+		for i = 1, N do
+			Array:Set(i, Value)
+		end
+	end
+	StopTimer()
+
+	StartTimer(Name .. " TArray pairs")
+	for _ = 1, Passes do
+		for _, _ in pairs(Array) do
+		end
+	end
+	StopTimer()
+end
+
+local function RunMap(Name, Map, Keys, Value, N, Passes)
+	for i = 1, N do
+		Map:Add(Keys[i], Value)
+	end
+
+	StartTimer(Name .. " TMap Find")
+	for _ = 1, Passes do
+		for i = 1, N do
+			local _ = Map:Find(Keys[i])
+		end
+	end
+	StopTimer()
+
+	StartTimer(Name .. " TMap Add")
+	for _ = 1, Passes do
+		for i = 1, N do
+			Map:Add(Keys[i], Value)
+		end
+	end
+	StopTimer()
+
+	StartTimer(Name .. " TMap pairs")
+	for _ = 1, Passes do
+		for _, _ in pairs(Map) do
+		end
+	end
+	StopTimer()
+end
+
+local function RunSet(Name, Set, Keys, N, Passes)
+	StartTimer(Name .. " TSet Add/Contains")
+	for _ = 1, Passes do
+		for i = 1, N do
+			Set:Add(Keys[i])
+			local _ = Set:Contains(Keys[i])
+		end
+	end
+	StopTimer()
+
+	StartTimer(Name .. " TSet pairs")
+	for _ = 1, Passes do
+		for _, _ in pairs(Set) do
+		end
+	end
+	StopTimer()
+end
+
+--- element reads, writes and enumeration of containers with int, float, bool, name and object elements, and creation of temporary containers
+---@param World UWorld
+---@param N integer @elements per container, 10000 by default
+---@param Passes integer @10 by default
+function M.Run(World, N, Passes)
+	N = N or 10000
+	Passes = Passes or 10
+	Start("Container", N * Passes)
+
+	RunArray("int32", UE.TArray(0), -1, N, Passes)
+	RunArray("float", UE.TArray(0.5), 0.5, N, Passes)
+	RunArray("bool", UE.TArray(true), true, N, Passes)
+	RunArray("UObject", UE.TArray(UE.UObject), World, N, Passes)
+	RunArray("FVector", UE.TArray(UE.FVector), UE.FVector(), N, Passes)
+	RunArray("FName", UE.TArray(UE.FName), "Name", N, Passes)
+
+	local Indices, Names, Objects = {}, {}, {}
+	for i = 1, N do
+		Indices[i] = i
+		Names[i] = "Name" .. i
+		Objects[i] = NewObject(UE.UObject, World)
+	end
+
+	RunMap("int32", UE.TMap(0, 0), Indices, -1, N, Passes)
+	RunMap("UObject", UE.TMap(0, UE.UObject), Indices, World, N, Passes)
+	RunMap("FName key", UE.TMap(UE.FName, 0), Names, -1, N, Passes)
+
+	StartTimer("temporary TArray(FVector)")
+	for _ = 1, Passes do
+		for _ = 1, N do
+			UE.TArray(UE.FVector):Add(UE.FVector())
+		end
+	end
+	StopTimer()
+
+	StartTimer("temporary TMap(int32, FVector)")
+	for _ = 1, Passes do
+		for i = 1, N do
+			UE.TMap(0, UE.FVector):Add(i, UE.FVector())
+		end
+	end
+	StopTimer()
+	collectgarbage("collect")
+
+	RunSet("int32", UE.TSet(0), Indices, N, Passes)
+	RunSet("FName", UE.TSet(UE.FName), Names, N, Passes)
+	RunSet("UObject", UE.TSet(UE.UObject), Objects, N, Passes)
+
+	Stop()
+	collectgarbage("collect")
+end
+
+return M
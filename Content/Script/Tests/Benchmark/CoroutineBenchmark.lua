@@ -0,0 +1,53 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+local Record = UE.UUnLuaBenchmarkFunctionLibrary.Record
+local TickCoroutines = UE.UUnLuaBenchmarkFunctionLibrary.TickCoroutines
+local TickLatentActions = UE.UUnLuaBenchmarkFunctionLibrary.TickLatentActions
+
+--- many coroutines sleeping up to a second, through UnLua.Sleep and then through the Delay latent function
+---@param World UWorld
+---@param N integer @coroutines, 50000 by default
+function M.Run(World, N)
+	N = N or 50000
+	Start("Coroutine", N)
+
+	local Woken = 0
+	local Sleep = UnLua.Sleep
+	StartTimer(string.format("UnLua.Sleep x%d coroutines", N))
+	for i = 1, N do
+		coroutine.wrap(function()
+			Sleep((i % 60 + 1) / 60)
+			Woken = Woken + 1
+		end)()
+	end
+	StopTimer()
+
+	StartTimer("UnLua.Sleep resume")
+	TickCoroutines(World, 70, 1 / 60)
+	StopTimer()
+	Record("UnLua.Sleep woken", Woken)
+
+	Woken = 0
+	local Delay = UE.UKismetSystemLibrary.Delay
+	StartTimer(string.format("Delay x%d coroutines", N))
+	for i = 1, N do
+		coroutine.wrap(function()
+			Delay(World, (i % 60 + 1) / 60)
+			Woken = Woken + 1
+		end)()
+	end
+	StopTimer()
+
+	StartTimer("Delay resume")
+	TickLatentActions(World, 70, 1 / 60)
+	StopTimer()
+	Record("Delay woken", Woken)
+
+	Stop()
+end
+
+return M
@@ -0,0 +1,59 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+
+--- reading a field of every row, through row copies, row references, and a cached column
+---@param World UWorld
+---@param N integer @passes over the table, 10000 by default
+---@param Path string @data table to scan, the test suite table by default
+function M.Run(World, N, Path)
+	N = N or 10000
+	Path = Path or "/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest"
+	local DataTable = UE.UObject.Load(Path)
+	local Names = {}
+	for Name in DataTable:Rows() do
+		Names[#Names + 1] = Name
+	end
+	Start("DataTable", N * #Names)
+
+	local GetRowDataStructure = UE.UDataTableFunctionLibrary.GetRowDataStructure
+	StartTimer(string.format("row copy x%d rows", #Names))
+	for _ = 1, N do
+		for i = 1, #Names do
+			local Level = GetRowDataStructure(DataTable, Names[i]).Level
+		end
+	end
+	StopTimer()
+
+	StartTimer("row reference")
+	for _ = 1, N do
+		for i = 1, #Names do
+			local Level = DataTable:FindRow(Names[i]).Level
+		end
+	end
+	StopTimer()
+
+	StartTimer("row iteration")
+	for _ = 1, N do
+		for Name, Row in DataTable:Rows() do
+			local Level = Row.Level
+		end
+	end
+	StopTimer()
+
+	StartTimer("column")
+	for _ = 1, N do
+		local Levels = DataTable:Column("Level")
+		for i = 1, #Names do
+			local Level = Levels[Names[i]]
+		end
+	end
+	StopTimer()
+
+	Stop()
+end
+
+return M
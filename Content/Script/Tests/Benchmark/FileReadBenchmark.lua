@@ -0,0 +1,73 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+
+local function CreateFile(FilePath, SizeMB)
+	local Line = string.rep("0123456789,", 9) .. "abcdefghi\n" -- 109 bytes, like a csv row
+	local Chunk = string.rep(Line, 1024)
+	local File = UE.File()
+	assert(File:Open(FilePath, "wb"))
+	for _ = 1, math.ceil(SizeMB * 1024 * 1024 / #Chunk) do
+		File:Write(Chunk)
+	end
+	File:Close()
+end
+
+--- reading a large text file through UE.File
+---@param SizeMB integer @size of the generated file, 100 by default
+function M.Run(SizeMB)
+	SizeMB = SizeMB or 100
+	local FilePath = UE.UKismetSystemLibrary.GetProjectSavedDirectory() .. "Benchmark/FileReadBenchmark.csv"
+	CreateFile(FilePath, SizeMB)
+	Start("FileRead", 1)
+
+	local File = UE.File()
+	assert(File:Open(FilePath, "rb"))
+	local Count = 0
+	StartTimer(string.format("Lines() %d MB", SizeMB))
+	for _ in File:Lines() do
+		Count = Count + 1
+	end
+	StopTimer()
+	File:Close()
+
+	assert(File:Open(FilePath, "rb"))
+	StartTimer(string.format("Read('L') %d MB", SizeMB))
+	while File:Read("L") do
+	end
+	StopTimer()
+	File:Close()
+
+	assert(File:Open(FilePath, "rb"))
+	StartTimer(string.format("Read('a') %d MB", SizeMB))
+	local Content = File:Read("a")
+	StopTimer()
+	File:Close()
+	assert(#Content > 0)
+	Content = nil
+
+	assert(File:Open(FilePath, "rb"))
+	StartTimer(string.format("Read(4096) %d MB", SizeMB))
+	while File:Read(4096) do
+	end
+	StopTimer()
+	File:Close()
+
+	assert(File:OpenMapped(FilePath))
+	local MappedCount = 0
+	StartTimer(string.format("mapped Lines() %d MB", SizeMB))
+	for _ in File:Lines() do
+		MappedCount = MappedCount + 1
+	end
+	StopTimer()
+	File:Close()
+	assert(MappedCount == Count)
+
+	Stop()
+	collectgarbage("collect")
+end
+
+return M
@@ -0,0 +1,54 @@
+local socket = require("socket")
+local async = require("socket.async")
+
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+
+--- echo round trips through socket.async against a local blocking echo server
+--- every async call completes on a later tick, so the numbers include the frame time
+---@param N integer @number of round trips
+---@param Size integer @payload size in bytes, has to fit in the socket buffers
+function M.Run(N, Size)
+	N = N or 1000
+	Size = Size or 1024
+
+	local Server = assert(socket.bind("127.0.0.1", 0))
+	local _, Port = Server:getsockname()
+
+	coroutine.wrap(function()
+		Start("LuaSocketAsync", N)
+
+		local Conn = assert(async.connect("127.0.0.1", Port))
+		local Peer = assert(Server:accept())
+		Server:close()
+
+		local Payload = string.rep("x", Size)
+		local Latency, MaxLatency = 0, 0
+		local Begin = socket.gettime()
+		StartTimer(string.format("echo %d x %d bytes", N, Size))
+		for _ = 1, N do
+			local Sent = socket.gettime()
+			assert(Conn:send(Payload))
+			assert(Peer:send(assert(Peer:receive(Size))))
+			assert(#assert(Conn:receive(Size)) == Size)
+			local Elapsed = socket.gettime() - Sent
+			Latency = Latency + Elapsed
+			MaxLatency = math.max(MaxLatency, Elapsed)
+		end
+		StopTimer()
+		local Total = socket.gettime() - Begin
+
+		print(string.format("socket.async echo: avg %.3f ms, max %.3f ms, %.2f KB/s",
+			Latency / N * 1000, MaxLatency * 1000, N * Size * 2 / 1024 / Total))
+
+		Conn:close()
+		Peer:close()
+		Stop()
+	end)()
+end
+
+return M
@@ -0,0 +1,81 @@
+local socket = require("socket")
+
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+
+local function Connect(NumSockets)
+	local Server = assert(socket.bind("127.0.0.1", 0))
+	local _, Port = Server:getsockname()
+	local Clients, Peers = {}, {}
+	for i = 1, NumSockets do
+		local Client = assert(socket.tcp())
+		assert(Client:connect("127.0.0.1", Port))
+		Clients[i] = Client
+		Peers[i] = assert(Server:accept())
+		Peers[i]:settimeout(0)
+	end
+	Server:close()
+	return Clients, Peers
+end
+
+--- loopback benchmark of socket.select versus socket.poller
+---@param NumSockets integer @number of loopback connections, 1000 by default
+---@param N integer @number of rounds
+function M.Run(NumSockets, N)
+	NumSockets = NumSockets or 1000
+	N = N or 1000
+	Start("LuaSocketPoller", N)
+
+	local Clients, Peers = Connect(NumSockets)
+
+	-- select() is capped by FD_SETSIZE, measure it only when the descriptors fit
+	if pcall(socket.select, Peers, nil, 0) then
+		StartTimer(string.format("select %d idle sockets", NumSockets))
+		for _ = 1, N do
+			socket.select(Peers, nil, 0)
+		end
+		StopTimer()
+	end
+
+	local Poller = socket.poller()
+	local Received = 0
+	local function OnReadable(Sock)
+		Sock:receive("*l")
+		Received = Received + 1
+	end
+	for i = 1, NumSockets do
+		Poller:add(Peers[i], "r", OnReadable)
+	end
+
+	StartTimer(string.format("poller:wait %d idle sockets", NumSockets))
+	for _ = 1, N do
+		Poller:wait(0)
+	end
+	StopTimer()
+
+	StartTimer(string.format("poller:dispatch %d active sockets", NumSockets))
+	for _ = 1, N do
+		for i = 1, NumSockets do
+			Clients[i]:send("ping\n")
+		end
+		Received = 0
+		while Received < NumSockets do
+			Poller:dispatch(0.002)
+		end
+	end
+	StopTimer()
+
+	Poller:close()
+	for i = 1, NumSockets do
+		Clients[i]:close()
+		Peers[i]:close()
+	end
+
+	Stop()
+end
+
+return M
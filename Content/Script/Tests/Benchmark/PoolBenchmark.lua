@@ -0,0 +1,64 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+local SpawnActors = UE.UUnLuaBenchmarkFunctionLibrary.SpawnActors
+local DestroyActors = UE.UUnLuaBenchmarkFunctionLibrary.DestroyActors
+
+--- spawn/despawn cycles of bound actors, destroying them against recycling them in a pool
+---@param World UWorld
+---@param N integer @actors per cycle, 1000 by default
+---@param Cycles integer @10 by default
+function M.Run(World, N, Cycles)
+	N = N or 1000
+	Cycles = Cycles or 10
+	local Class = UE.AUnLuaBenchmarkBoundProxy
+	local Initializer = {}
+	Start("Pool", N * Cycles)
+
+	local Actors = UE.TArray(UE.AActor)
+	SpawnActors(World, Class, 1, Actors)
+	DestroyActors(Actors)
+	Actors:Clear()
+	collectgarbage("collect")
+
+	StartTimer("spawn/destroy")
+	for _ = 1, Cycles do
+		SpawnActors(World, Class, N, Actors)
+		for i = 1, N do
+			Actors:Get(i).Spawned = false
+		end
+		DestroyActors(Actors)
+		Actors:Clear()
+	end
+	StopTimer()
+	collectgarbage("collect")
+
+	local Pool = {}
+	SpawnActors(World, Class, N, Actors)
+	for i = 1, N do
+		Pool[i] = Actors:Get(i)
+		UnLua.Recycle(Pool[i])
+	end
+
+	StartTimer("reuse/recycle")
+	for _ = 1, Cycles do
+		for i = 1, N do
+			local Actor = Pool[i]
+			UnLua.Reuse(Actor, Initializer)
+			Actor.Spawned = false
+		end
+		for i = 1, N do
+			UnLua.Recycle(Pool[i])
+		end
+	end
+	StopTimer()
+
+	DestroyActors(Actors)
+	Stop()
+	collectgarbage("collect")
+end
+
+return M
@@ -0,0 +1,19 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local RequireModules = UE.UUnLuaBenchmarkFunctionLibrary.RequireModules
+
+--- starting a project of generated modules, requiring them on the game thread against preloading them on worker threads
+---@param NumModules integer @3000 by default
+function M.Run(NumModules)
+	NumModules = NumModules or 3000
+	Start("Preload", 1)
+	-- generates the modules and warms the file cache
+	RequireModules(NumModules, false)
+	RequireModules(NumModules, false)
+	RequireModules(NumModules, true)
+	Stop()
+end
+
+return M
@@ -0,0 +1,17 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local RequireInEnvs = UE.UUnLuaBenchmarkFunctionLibrary.RequireInEnvs
+
+--- requiring a large config module in several lua envs, as copies or as shared data
+---@param NumEnvs integer @4 by default
+function M.Run(NumEnvs)
+	NumEnvs = NumEnvs or 4
+	Start("SharedData", 1)
+	RequireInEnvs("Tests.Benchmark.SharedDataBenchmarkItems", NumEnvs, false)
+	RequireInEnvs("Tests.Benchmark.SharedDataBenchmarkItems", NumEnvs, true)
+	Stop()
+end
+
+return M
@@ -0,0 +1,17 @@
+-- generated item definitions, the size of a typical config table
+local Qualities = { "Common", "Rare", "Epic", "Legendary" }
+
+local Items = {}
+for i = 1, 20000 do
+	Items[i] = {
+		Id = 100000 + i,
+		Name = "Item_" .. i,
+		Quality = Qualities[i % #Qualities + 1],
+		Price = i * 10,
+		Weight = i * 0.25,
+		Stackable = i % 2 == 0,
+		Tags = { "Loot", Qualities[i % #Qualities + 1] },
+	}
+end
+
+return Items
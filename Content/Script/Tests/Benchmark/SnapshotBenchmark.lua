@@ -0,0 +1,16 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartEnvs = UE.UUnLuaBenchmarkFunctionLibrary.StartEnvs
+
+--- starting lua envs by running the startup module against restoring a snapshot of it
+---@param NumEnvs integer @4 by default
+function M.Run(NumEnvs)
+	NumEnvs = NumEnvs or 4
+	Start("Snapshot", 1)
+	StartEnvs("Tests.Benchmark.SnapshotBenchmarkStartup", NumEnvs)
+	Stop()
+end
+
+return M
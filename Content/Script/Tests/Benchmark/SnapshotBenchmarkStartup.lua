@@ -0,0 +1,28 @@
+-- a startup module doing the kind of work games do on startup: config tables, classes and closures
+local Items = require("Tests.Benchmark.SharedDataBenchmarkItems")
+
+local ItemsById = {}
+local ItemsByQuality = {}
+for _, Item in ipairs(Items) do
+	ItemsById[Item.Id] = Item
+	local List = ItemsByQuality[Item.Quality] or {}
+	List[#List + 1] = Item
+	ItemsByQuality[Item.Quality] = List
+end
+
+local Handlers = {}
+for i = 1, 2000 do
+	local Count = 0
+	Handlers["OnEvent" .. i] = function(Delta)
+		Count = Count + Delta
+		return Count
+	end
+end
+
+_G.Game = {
+	ItemsById = ItemsById,
+	ItemsByQuality = ItemsByQuality,
+	Handlers = Handlers,
+}
+
+return _G.Game
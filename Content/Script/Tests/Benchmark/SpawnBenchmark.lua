@@ -0,0 +1,49 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+local TickCoroutines = UE.UUnLuaBenchmarkFunctionLibrary.TickCoroutines
+local RecordCoroutinePool = UE.UUnLuaBenchmarkFunctionLibrary.RecordCoroutinePool
+
+local function Activate(Ability, Level)
+	UnLua.WaitFrames(1)
+	return Ability + Level
+end
+
+--- short-lived coroutines waiting one frame, started with coroutine.wrap and then with UnLua.Spawn
+---@param World UWorld
+---@param N integer @coroutines per frame, 200 by default
+---@param NumFrames integer @frames, 100 by default
+function M.Run(World, N, NumFrames)
+	N = N or 200
+	NumFrames = NumFrames or 100
+	Start("Spawn", N * NumFrames)
+
+	collectgarbage("collect")
+	StartTimer(string.format("coroutine.wrap x%d per frame", N))
+	for _ = 1, NumFrames do
+		for i = 1, N do
+			coroutine.wrap(Activate)(i, 1)
+		end
+		TickCoroutines(World, 1, 1 / 60)
+	end
+	StopTimer()
+
+	collectgarbage("collect")
+	local Spawn = UnLua.Spawn
+	StartTimer(string.format("UnLua.Spawn x%d per frame", N))
+	for _ = 1, NumFrames do
+		for i = 1, N do
+			Spawn(Activate, i, 1)
+		end
+		TickCoroutines(World, 1, 1 / 60)
+	end
+	StopTimer()
+	RecordCoroutinePool(World)
+
+	Stop()
+end
+
+return M
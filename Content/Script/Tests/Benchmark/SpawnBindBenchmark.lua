@@ -0,0 +1,56 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+local Record = UE.UUnLuaBenchmarkFunctionLibrary.Record
+local SpawnActors = UE.UUnLuaBenchmarkFunctionLibrary.SpawnActors
+local DestroyActors = UE.UUnLuaBenchmarkFunctionLibrary.DestroyActors
+
+--- spawn N actors from C++, the way gameplay code does, and record time and lua memory
+local function Spawn(World, N, Name, SpawnClass)
+	local Actors = UE.TArray(UE.AActor)
+	collectgarbage("collect")
+	local Memory = collectgarbage("count")
+	StartTimer(Name)
+	SpawnActors(World, SpawnClass, N, Actors)
+	StopTimer()
+	collectgarbage("collect")
+	Record(Name .. " lua memory KB", collectgarbage("count") - Memory)
+	return Actors
+end
+
+local function Destroy(Actors)
+	DestroyActors(Actors)
+	Actors:Clear()
+	collectgarbage("collect")
+end
+
+--- spawning many actors of the same class, unbound, bound and lazily bound to a lua module
+---@param World UWorld
+---@param N integer @actors spawned per run, 10000 by default
+function M.Run(World, N)
+	N = N or 10000
+	Start("SpawnBind", 1)
+
+	-- the first binding requires the module and overrides the class functions
+	Destroy(Spawn(World, 1, "warm up", UE.AUnLuaBenchmarkBoundProxy))
+	Destroy(Spawn(World, 1, "warm up lazy", UE.AUnLuaBenchmarkLazyProxy))
+
+	Destroy(Spawn(World, N, string.format("SpawnActor x%d", N), UE.AUnLuaBenchmarkProxy))
+	Destroy(Spawn(World, N, string.format("SpawnActor x%d bound", N), UE.AUnLuaBenchmarkBoundProxy))
+
+	local Actors = Spawn(World, N, string.format("SpawnActor x%d lazy", N), UE.AUnLuaBenchmarkLazyProxy)
+	StartTimer(string.format("first use x%d lazy", N))
+	for i = 1, N do
+		local Actor = Actors:Get(i)
+		assert(Actor.Spawned)
+	end
+	StopTimer()
+	Destroy(Actors)
+
+	Stop()
+end
+
+return M
@@ -0,0 +1,7 @@
+local M = UnLua.Class()
+
+function M:Initialize(Initializer)
+	self.Spawned = true
+end
+
+return M
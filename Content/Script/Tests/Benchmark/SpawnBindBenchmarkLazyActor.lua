@@ -0,0 +1,10 @@
+local M = UnLua.Class()
+
+-- the instance table is created when lua first uses the actor
+M.__LazyBind = true
+
+function M:Initialize(Initializer)
+	self.Spawned = true
+end
+
+return M
@@ -0,0 +1,56 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+local SpawnActors = UE.UUnLuaBenchmarkFunctionLibrary.SpawnActors
+local DestroyActors = UE.UUnLuaBenchmarkFunctionLibrary.DestroyActors
+local TickActors = UE.UUnLuaBenchmarkFunctionLibrary.TickActors
+local TickActorsBatched = UE.UUnLuaBenchmarkFunctionLibrary.TickActorsBatched
+
+local function RunOnce(World, N, NumFrames)
+	local Actors = UE.TArray(UE.AActor)
+	SpawnActors(World, UE.AUnLuaBenchmarkTickProxy, N, Actors)
+	TickActors(Actors, 1)
+
+	StartTimer(string.format("ReceiveTick x%d actors", N))
+	TickActors(Actors, NumFrames)
+	StopTimer()
+
+	DestroyActors(Actors)
+	Actors:Clear()
+
+	SpawnActors(World, UE.AUnLuaBenchmarkBatchTickProxy, N, Actors)
+	TickActorsBatched(World, 1)
+
+	StartTimer(string.format("BatchTick x%d actors", N))
+	TickActorsBatched(World, NumFrames)
+	StopTimer()
+
+	DestroyActors(Actors)
+	Actors:Clear()
+	collectgarbage("collect")
+end
+
+--- calling a lua overridden ReceiveTick on many actors from C++, then the same work through '__TickGroup' batching
+---@param World UWorld
+---@param N integer @actors, runs 1000, 5000 and 20000 actors by default
+---@param NumFrames integer @ticks per actor, 100 by default
+function M.Run(World, N, NumFrames)
+	local Sizes = N and { N } or { 1000, 5000, 20000 }
+	NumFrames = NumFrames or 100
+	local Total = 0
+	for _, Size in ipairs(Sizes) do
+		Total = Total + Size
+	end
+	Start("Tick", Total * NumFrames)
+
+	for _, Size in ipairs(Sizes) do
+		RunOnce(World, Size, NumFrames)
+	end
+
+	Stop()
+end
+
+return M
@@ -0,0 +1,7 @@
+local M = UnLua.Class()
+
+function M:ReceiveTick(DeltaSeconds)
+	self.Elapsed = (self.Elapsed or 0) + DeltaSeconds
+end
+
+return M
@@ -0,0 +1,9 @@
+local M = UnLua.Class()
+
+M.__TickGroup = "PrePhysics"
+
+function M:BatchTick(DeltaSeconds)
+	self.Elapsed = (self.Elapsed or 0) + DeltaSeconds
+end
+
+return M
@@ -0,0 +1,87 @@
+local M = {}
+
+local Start = UE.UUnLuaBenchmarkFunctionLibrary.Start
+local Stop = UE.UUnLuaBenchmarkFunctionLibrary.Stop
+local StartTimer = UE.UUnLuaBenchmarkFunctionLibrary.StartTimer
+local StopTimer = UE.UUnLuaBenchmarkFunctionLibrary.StopTimer
+local Record = UE.UUnLuaBenchmarkFunctionLibrary.Record
+local TickPropertyWatchers = UE.UUnLuaBenchmarkFunctionLibrary.TickPropertyWatchers
+
+--- many watched properties, with none and then a tenth of them changing every frame, against polling them from Lua
+---@param World UWorld
+---@param N integer @watched objects, 10000 by default
+---@param Frames integer @60 by default
+function M.Run(World, N, Frames)
+	N = N or 10000
+	Frames = Frames or 60
+	Start("Watch", N * Frames)
+
+	local Stubs = {}
+	for i = 1, N do
+		Stubs[i] = NewObject(UE.UUnLuaTestStub)
+	end
+
+	local Called = 0
+	local function OnChanged(Object, Value)
+		Called = Called + 1
+	end
+	local Ids = {}
+	StartTimer(string.format("UnLua.Watch x%d", N))
+	for i = 1, N do
+		Ids[i] = UnLua.Watch(Stubs[i], "Counter", OnChanged)
+	end
+	StopTimer()
+
+	StartTimer("watch unchanged")
+	TickPropertyWatchers(World, Frames)
+	StopTimer()
+
+	StartTimer("watch 10% changed")
+	for _ = 1, Frames do
+		for i = 1, N, 10 do
+			Stubs[i]:AddCount()
+		end
+		TickPropertyWatchers(World, 1)
+	end
+	StopTimer()
+	Record("watch callbacks", Called)
+
+	for i = 1, N do
+		UnLua.Unwatch(Ids[i])
+	end
+
+	Called = 0
+	local Last = {}
+	for i = 1, N do
+		Last[i] = Stubs[i].Counter
+	end
+	local function Poll()
+		for i = 1, N do
+			local Value = Stubs[i].Counter
+			if Value ~= Last[i] then
+				Last[i] = Value
+				OnChanged(Stubs[i], Value)
+			end
+		end
+	end
+
+	StartTimer("poll unchanged")
+	for _ = 1, Frames do
+		Poll()
+	end
+	StopTimer()
+
+	StartTimer("poll 10% changed")
+	for _ = 1, Frames do
+		for i = 1, N, 10 do
+			Stubs[i]:AddCount()
+		end
+		Poll()
+	end
+	StopTimer()
+	Record("poll callbacks", Called)
+
+	Stop()
+end
+
+return M
@@ -0,0 +1,13 @@
+local M = UnLua.Class()
+
+M.__LazyBind = false
+
+function M:Initialize()
+	_G.NumInitialized = (_G.NumInitialized or 0) + 1
+end
+
+function M:GetAnswer()
+	return 42
+end
+
+return M
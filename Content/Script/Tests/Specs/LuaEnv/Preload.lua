@@ -0,0 +1,10 @@
+local Count = 0
+
+local M = {}
+
+function M.Inc()
+	Count = Count + 1
+	return Count
+end
+
+return M
@@ -0,0 +1,7 @@
+local M = UnLua.Class()
+
+function M:GetId()
+	return self.Id
+end
+
+return M
@@ -0,0 +1,9 @@
+local Item = { Id = 2, Name = "Sword" }
+
+return {
+	Name = "Items",
+	Scale = 0.5,
+	Enabled = true,
+	List = { { Id = 1, Name = "Shield" }, Item },
+	ById = { [1001] = Item },
+}
@@ -0,0 +1,18 @@
+local Counter = 0
+
+local function Inc()
+	Counter = Counter + 1
+	return Counter
+end
+
+local function Get()
+	return Counter
+end
+
+local Node = { Name = "Root" }
+Node.Self = Node
+
+local Lazy = setmetatable({}, { __index = function(t, k) return k .. "!" end })
+
+_G.SnapshotTest = { Inc = Inc, Get = Get, Node = Node, Lazy = Lazy, ActorClass = UE.AActor, Print = print }
+return _G.SnapshotTest
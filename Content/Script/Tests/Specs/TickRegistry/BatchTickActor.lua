@@ -0,0 +1,14 @@
+local M = UnLua.Class()
+
+M.__TickGroup = "PrePhysics"
+
+function M:BatchTick(DeltaSeconds)
+	_G.TickCount = (_G.TickCount or 0) + 1
+	local Victim = _G.Victim
+	if Victim and Victim ~= self then
+		_G.Victim = nil
+		Victim:K2_DestroyActor()
+	end
+end
+
+return M
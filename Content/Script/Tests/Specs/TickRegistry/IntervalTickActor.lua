@@ -0,0 +1,11 @@
+local M = UnLua.Class()
+
+M.__TickGroup = true
+M.__TickInterval = 0.25
+
+function M:BatchTick(DeltaSeconds)
+	_G.TickCount = (_G.TickCount or 0) + 1
+	_G.LastDeltaSeconds = DeltaSeconds
+end
+
+return M
@@ -0,0 +1,10 @@
+local M = UnLua.Class()
+
+M.__LazyBind = true
+M.__TickGroup = "PrePhysics"
+
+function M:BatchTick(DeltaSeconds)
+	_G.TickCount = (_G.TickCount or 0) + 1
+end
+
+return M
@@ -0,0 +1,17 @@
+local M = UnLua.Class()
+
+M.Count = 0
+
+function M:Initialize(Initializer)
+	self.Count = Initializer and Initializer.Count or self.Count
+end
+
+function M:OnRecycle()
+	_G.RecycledCount = self.Count
+end
+
+function M:OnReuse(Initializer)
+	self.Reused = true
+end
+
+return M
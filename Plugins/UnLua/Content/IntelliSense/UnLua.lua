@@ -28,6 +28,73 @@ end
 function UnLua.Unref(Object)
 end
 
+---Return a pooled object's lua instance to the module defaults, calling its OnRecycle first. The instance table and its references are kept.
+---@param Object UObject
+---@return boolean @false if the object has no lua instance
+function UnLua.Recycle(Object)
+end
+
+---Take a recycled object out of a pool, calling its Initialize and OnReuse with the initializer table.
+---@param Object UObject
+---@param Initializer table @[opt]
+---@return boolean @false if the object has no lua instance
+function UnLua.Reuse(Object, Initializer)
+end
+
+---Suspend the calling coroutine for some seconds without an engine latent action. The wait is dropped if the owner is destroyed.
+---@param Seconds number
+---@param Owner UObject @[opt]
+---@return boolean @true once the time has passed
+function UnLua.Sleep(Seconds, Owner)
+end
+
+---Suspend the calling coroutine for some frames. The wait is dropped if the owner is destroyed.
+---@param NumFrames integer @[opt]1 by default
+---@param Owner UObject @[opt]
+---@return boolean @true once the frames have passed
+function UnLua.WaitFrames(NumFrames, Owner)
+end
+
+---Suspend the calling coroutine until the event is signalled. The wait is dropped if the owner is destroyed.
+---@param Event string
+---@param Owner UObject @[opt]
+---@return any @the values passed to UnLua.Signal
+function UnLua.WaitEvent(Event, Owner)
+end
+
+---Wake up every coroutine waiting for the event, they are resumed with the values in the next frame.
+---@param Event string
+---@return integer @number of coroutines woken up
+function UnLua.Signal(Event, ...)
+end
+
+---Drop the wait of a coroutine suspended by UnLua.Sleep/WaitFrames/WaitEvent, it is never resumed by UnLua.
+---@param Co thread
+---@return boolean @false if the coroutine was not waiting
+function UnLua.Cancel(Co)
+end
+
+---Run a function in a coroutine taken from a pool. The coroutine goes back to the pool when the function returns, so do not keep it past that.
+---A kept handle then aliases the pooled thread: once another UnLua.Spawn reuses it, coroutine.status, UnLua.Cancel and resuming it act on that other function.
+---@param Function function
+---@return thread @the coroutine if the function is suspended, nil if it has finished
+function UnLua.Spawn(Function, ...)
+end
+
+---Call back with the object and the new value when a property of the object changes, checked once per frame. The watch is dropped when the object is destroyed.
+---@param Object UObject
+---@param PropertyName string
+---@param Callback fun(Object:UObject, Value:any)
+---@return integer @id for UnLua.Unwatch
+function UnLua.Watch(Object, PropertyName, Callback)
+end
+
+---Stop a watch started by UnLua.Watch.
+---@param Id integer
+---@return boolean @false if the watch was already dropped
+function UnLua.Unwatch(Id)
+end
+
 _G.UnLua = UnLua
 
 ---@class TArray<TElement>
@@ -60,7 +60,7 @@ static int TArray_Enumerable(lua_State* L)
     if (Array->IsValidIndex((*Enumerator)->Index))
     {
         UnLua::Push(L, (*Enumerator)->Index + 1);
-        Array->Inner->ReadValue(L, Array->GetData((*Enumerator)->Index), false);
+        Array->InnerAccessor.Read(L, Array->GetData((*Enumerator)->Index), false);
         (*Enumerator)->Index += 1;
         return 2;
     }
@@ -123,7 +123,7 @@ static int32 TArray_Add(lua_State* L)
 
     int32 Index = Array->AddDefaulted();
     uint8* Data = Array->GetData(Index);
-    Array->Inner->WriteValue_InContainer(L, Data, 2);
+    Array->InnerAccessor.WriteInContainer(L, Data, 2);
     ++Index;
     lua_pushinteger(L, Index);
     return 1;
@@ -142,7 +142,7 @@ static int32 TArray_AddUnique(lua_State* L)
     TArray_Guard(L, Array);
 
     Array->Inner->Initialize(Array->ElementCache);
-    Array->Inner->WriteValue_InContainer(L, Array->ElementCache, 2);
+    Array->InnerAccessor.WriteInContainer(L, Array->ElementCache, 2);
     int32 Index = Array->AddUnique(Array->ElementCache);
     Array->Inner->Destruct(Array->ElementCache);
     ++Index;
@@ -163,7 +163,7 @@ static int32 TArray_Find(lua_State* L)
     TArray_Guard(L, Array);
 
     Array->Inner->Initialize(Array->ElementCache);
-    Array->Inner->WriteValue_InContainer(L, Array->ElementCache, 2);
+    Array->InnerAccessor.WriteInContainer(L, Array->ElementCache, 2);
     int32 Index = Array->Find(Array->ElementCache);
     Array->Inner->Destruct(Array->ElementCache);
     ++Index;
@@ -184,7 +184,7 @@ static int32 TArray_Insert(lua_State* L)
     TArray_Guard(L, Array);
 
     Array->Inner->Initialize(Array->ElementCache);
-    Array->Inner->WriteValue_InContainer(L, Array->ElementCache, 2);
+    Array->InnerAccessor.WriteInContainer(L, Array->ElementCache, 2);
     int32 Index = lua_tointeger(L, 3);
     --Index;
     Array->Insert(Array->ElementCache, Index);
@@ -223,7 +223,7 @@ static int32 TArray_RemoveItem(lua_State* L)
     TArray_Guard(L, Array);
 
     Array->Inner->Initialize(Array->ElementCache);
-    Array->Inner->WriteValue_InContainer(L, Array->ElementCache, 2);
+    Array->InnerAccessor.WriteInContainer(L, Array->ElementCache, 2);
     int32 N = Array->RemoveItem(Array->ElementCache);
     Array->Inner->Destruct(Array->ElementCache);
     lua_pushinteger(L, N);
@@ -324,7 +324,7 @@ static int32 TArray_Get(lua_State* L)
 
     Array->Inner->Initialize(Array->ElementCache);
     Array->Get(Index, Array->ElementCache);
-    Array->Inner->ReadValue(L, Array->ElementCache, true);
+    Array->InnerAccessor.Read(L, Array->ElementCache, true);
     Array->Inner->Destruct(Array->ElementCache);
     return 1;
 }
@@ -350,7 +350,7 @@ static int32 TArray_GetRef(lua_State* L)
     }
 
     const void* Element = Array->GetData(Index);
-    Array->Inner->ReadValue(L, Element, false);
+    Array->InnerAccessor.Read(L, Element, false);
     return 1;
 }
 
@@ -375,7 +375,7 @@ static int32 TArray_Set(lua_State* L)
     }
 
     Array->Inner->Initialize(Array->ElementCache);
-    Array->Inner->WriteValue_InContainer(L, Array->ElementCache, 3);
+    Array->InnerAccessor.WriteInContainer(L, Array->ElementCache, 3);
     Array->Set(Index, Array->ElementCache);
     Array->Inner->Destruct(Array->ElementCache);
     return 0;
@@ -466,7 +466,7 @@ static int32 TArray_Contains(lua_State* L)
     TArray_Guard(L, Array);
 
     Array->Inner->Initialize(Array->ElementCache);
-    Array->Inner->WriteValue_InContainer(L, Array->ElementCache, 2);
+    Array->InnerAccessor.WriteInContainer(L, Array->ElementCache, 2);
     int32 N = Array->Num();
     int32 Index = Array->Find(Array->ElementCache);
     Array->Inner->Destruct(Array->ElementCache);
@@ -532,7 +532,7 @@ static int32 TArray_ToTable(lua_State* L)
     {
         lua_pushinteger(L, i + 1);
         Array->Get(i, Array->ElementCache);
-        Array->Inner->ReadValue(L, Array->ElementCache, true);
+        Array->InnerAccessor.Read(L, Array->ElementCache, true);
         lua_rawset(L, -3);
     }
     Array->Inner->Destruct(Array->ElementCache);
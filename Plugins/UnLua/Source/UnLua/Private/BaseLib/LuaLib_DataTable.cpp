@@ -14,10 +14,30 @@
 
 #include "UnLuaEx.h"
 #include "LuaCore.h"
+#include "LuaEnv.h"
 #include "Kismet/DataTableFunctionLibrary.h"
 
 namespace UnLua
 {
+    static UDataTable* CheckRowArgs(lua_State* L, FName& OutRowName)
+    {
+        UDataTable* Table = Cast<UDataTable>(UnLua::GetUObject(L, 1));
+        if (!Table)
+        {
+            luaL_error(L, "invalid UDataTable");
+            return nullptr;
+        }
+
+        if (!IsType(L, 2, TType<FName>()))
+        {
+            luaL_error(L, "invalid row name");
+            return nullptr;
+        }
+
+        OutRowName = UnLua::Get(L, 2, TType<FName>());
+        return Table;
+    }
+
     /**
      * Get row data with structure.
      */
@@ -27,43 +47,51 @@ namespace UnLua
         if (NumParams != 2)
             return luaL_error(L, "invalid parameters");
 
+        FName RowName;
+        UDataTable* Table = CheckRowArgs(L, RowName);
+        FLuaEnv::FindEnvChecked(L).GetDataTableRegistry()->PushRowCopy(L, Table, RowName);
+        return 1;
+    }
+
+    /**
+     * Get a read-only reference to a row, its fields are read from the table without copying the row.
+     */
+    static int32 UDataTable_FindRow(lua_State* L)
+    {
+        int32 NumParams = lua_gettop(L);
+        if (NumParams != 2)
+            return luaL_error(L, "invalid parameters");
+
+        FName RowName;
+        UDataTable* Table = CheckRowArgs(L, RowName);
+        FLuaEnv::FindEnvChecked(L).GetDataTableRegistry()->PushRow(L, Table, RowName);
+        return 1;
+    }
+
+    /**
+     * Iterate over the names and read-only references of all rows.
+     */
+    static int32 UDataTable_Rows(lua_State* L)
+    {
         UDataTable* Table = Cast<UDataTable>(UnLua::GetUObject(L, 1));
         if (!Table)
             return luaL_error(L, "invalid UDataTable");
 
-        if (!IsType(L, 2, TType<FName>()))
-            return luaL_error(L, "invalid row name");
+        FLuaEnv::FindEnvChecked(L).GetDataTableRegistry()->PushRows(L, Table);
+        return 1;
+    }
 
-        FName RowName = UnLua::Get(L, 2, TType<FName>());
-        void* RowPtr = Table->FindRowUnchecked(RowName);
+    /**
+     * Get a table of row name to the value of a column, cached until the table changes.
+     */
+    static int32 UDataTable_Column(lua_State* L)
+    {
+        UDataTable* Table = Cast<UDataTable>(UnLua::GetUObject(L, 1));
+        if (!Table)
+            return luaL_error(L, "invalid UDataTable");
 
-        if (RowPtr == nullptr)
-        {
-            lua_pushnil(L);
-        }
-        else
-        {
-            const UScriptStruct* StructType = Table->GetRowStruct();
-
-            if (StructType != nullptr)
-            {
-                FString Name = FString("F" + StructType->GetName());
-                uint8 StructPadding = StructType->GetMinAlignment();
-                uint8 Padding = StructPadding < 8 ? 8 : StructPadding;
-                void* Userdata = NewUserdataWithPadding(L, StructType->GetStructureSize(), TCHAR_TO_UTF8(*Name), Padding);
-                if (Userdata != nullptr)
-                {
-                    if (StructType->StructFlags & STRUCT_CopyNative)
-                    {
-                        //Do ScriptStruct Construct
-                        UScriptStruct::ICppStructOps* TheCppStructOps = StructType->GetCppStructOps();
-                        TheCppStructOps->Construct(Userdata);
-                    }
-                    StructType->InitializeStruct(Userdata);
-                    StructType->CopyScriptStruct(Userdata, RowPtr);
-                }
-            }
-        }
+        const char* ColumnName = luaL_checkstring(L, 2);
+        FLuaEnv::FindEnvChecked(L).GetDataTableRegistry()->PushColumn(L, Table, ColumnName);
         return 1;
     }
 
@@ -80,4 +108,18 @@ namespace UnLua
     END_EXPORT_CLASS()
 
     IMPLEMENT_EXPORTED_CLASS(UDataTableFunctionLibrary)
+
+    static const luaL_Reg UDataTableRowLib[] =
+    {
+        {"FindRow", UDataTable_FindRow},
+        {"Rows", UDataTable_Rows},
+        {"Column", UDataTable_Column},
+        {nullptr, nullptr}
+    };
+
+    BEGIN_EXPORT_REFLECTED_CLASS(UDataTable)
+        ADD_LIB(UDataTableRowLib)
+    END_EXPORT_CLASS()
+
+    IMPLEMENT_EXPORTED_CLASS(UDataTable)
 }
@@ -1,5 +1,10 @@
 #include "UnLuaEx.h"
+#include "LuaEnv.h"
 #include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/Async.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
 
 class UE4File
 {
@@ -9,11 +14,13 @@ public:
 		this->bWirte = false;
 		this->Flags = 0x00;
 		this->FilePath = TEXT("");
+		this->BufferSize = DefaultBufferSize;
+		this->ResetReadBuffer();
 	}
 
 	~UE4File()
 	{
-		FILE.Reset();
+		this->Close();
 	}
 public:
 
@@ -23,7 +30,7 @@ public:
 		
 		if (this->HelperCheckFileMode(Mode, this->Flags, this->bWirte))
 		{
-			FILE.Reset();
+			this->Close();
 			if (this->bWirte)
 			{
 				FArchive* FilePtr = IFileManager::Get().CreateFileWriter(*InFilePath, this->Flags);
@@ -53,22 +60,81 @@ public:
 		return Ret;
 	}
 
+	/**
+	 * Open a file read only through a memory mapping, reads become plain memory copies.
+	 * Falls back to the buffered reader when the platform (or the pak the file lives in) can't map it.
+	 */
+	bool OpenMapped(const FString& InFilePath)
+	{
+		this->Close();
+		IMappedFileHandle* Handle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*InFilePath);
+		if (nullptr == Handle)
+		{
+			return this->Open(InFilePath, TEXT("rb"));
+		}
+
+		MappedHandle.Reset(Handle);
+		this->bWirte = false;
+		this->Flags = FILEREAD_None;
+		if (0 < Handle->GetFileSize())
+		{
+			MappedRegion.Reset(Handle->MapRegion());
+			if (!MappedRegion.IsValid())
+			{
+				MappedHandle.Reset();
+				return this->Open(InFilePath, TEXT("rb"));
+			}
+			ReadData = MappedRegion->GetMappedPtr();
+			ReadEnd = MappedRegion->GetMappedSize();
+		}
+		return true;
+	}
+
+	/** Size of the read buffer, takes effect the next time the buffer is refilled */
+	void SetBufferSize(int32 Size)
+	{
+		this->BufferSize = FMath::Max(Size, 64);
+	}
+
 	void Close()
 	{
 		FILE.Reset();
+		MappedRegion.Reset();
+		MappedHandle.Reset();
+		ResetReadBuffer();
 	}
+
 	void  Seek(const FString& Mode, int32 Offset)
 	{
-		if (FILE.IsValid())
+		static const FString modenames[] = { TEXT("set"), TEXT("cur"), TEXT("end")};
+		if (MappedHandle.IsValid())
 		{
-			static const FString modenames[] = { TEXT("set"), TEXT("cur"), TEXT("end")};
+			int64 NewPos = ReadPos;
+			if (Mode.Equals(modenames[0]))
+			{
+				NewPos = Offset;
+			}
+			else if (Mode.Equals(modenames[1]))
+			{
+				NewPos = ReadPos + Offset;
+			}
+			else if (Mode.Equals(modenames[2]))
+			{
+				NewPos = ReadEnd - Offset;
+			}
+			ReadPos = FMath::Clamp<int64>(NewPos, 0, ReadEnd);
+		}
+		else if (FILE.IsValid())
+		{
+			int64 CurPos = this->Tell();
+			ResetReadBuffer();
 			if (Mode.Equals(modenames[0]))
 			{
 				FILE->Seek(Offset);
 			}
 			else if (Mode.Equals(modenames[1]))
 			{
-				FILE->Seek(FILE->Tell() + Offset);
+				FILE->Seek(CurPos + Offset);
 			}
 			else if (Mode.Equals(modenames[2]))
 			{
@@ -82,6 +148,10 @@ public:
 
 	int32 TotalSize()
 	{
+		if (MappedHandle.IsValid())
+		{
+			return (int32)MappedHandle->GetFileSize();
+		}
 		if (FILE.IsValid())
 		{
 			return FILE->TotalSize();
@@ -91,7 +161,7 @@ public:
 
 	bool IsValid()
 	{
-		return FILE.IsValid();
+		return FILE.IsValid() || MappedHandle.IsValid();
 	}
 
 
@@ -103,6 +173,26 @@ public:
 		}
 	}
 
+	/** Position seen by Lua, the archive itself is ahead by the buffered bytes */
+	int64 Tell()
+	{
+		if (MappedHandle.IsValid())
+		{
+			return ReadPos;
+		}
+		return FILE.IsValid() ? FILE->Tell() - (ReadEnd - ReadPos) : 0;
+	}
+
+	/** Give the archive back its logical position before writing to it */
+	void SyncForWrite()
+	{
+		if (FILE.IsValid() && ReadPos < ReadEnd)
+		{
+			FILE->Seek(this->Tell());
+		}
+		ResetReadBuffer();
+	}
+
 
 	TSharedPtr <FArchive> GetFArchive()
 	{
@@ -112,7 +202,7 @@ public:
 
 	bool IsReadable()
 	{
-		return (this->FILE.IsValid() && (false == this->bWirte || this->Flags & FILEWRITE_AllowRead));
+		return MappedHandle.IsValid() || (this->FILE.IsValid() && (false == this->bWirte || this->Flags & FILEWRITE_AllowRead));
 	}
 
 
@@ -123,80 +213,60 @@ public:
 
 
 	//////////FUNCTIONS FOR LUA LIB//////////////////////
-		/**
-	 *
-	 @param Size is Size is Zero Means Read All From Current Offset,else means read SizeBytes from current Offset
-	 */
-	FORCEINLINE  int ReadSize(TArray<uint8>& Buffer, uint32 Size = 0)
+	/** Read buffer is empty and nothing is left in the file */
+	FORCEINLINE bool AtEnd()
 	{
-		TArray<uint8> DataBuffer;
-		static const int64 DataBufferSize = 10 * 1024;
-		//when file is valid and is read mode or FILEWRITE_AllowRead flag is set
-		if (this->IsReadable())
-		{
-			DataBuffer.AddUninitialized(DataBufferSize);//10K
-			//get file size
-			int64 FileSize = FILE->TotalSize();
-			//get current offset
-			int64 CurPos = FILE->Tell();
-			//compute readable target size(size left to be read from current offset)
-			int64 TargetSize = FileSize - CurPos;
-			int64 ReadSize = 0;
-			if (0 < Size)
-			{
-				TargetSize = FMath::Min(TargetSize, (int64)Size);
-			}
-			while (TargetSize)
-			{
-				CurPos = FILE->Tell();
-				FILE->Serialize(DataBuffer.GetData(), FMath::Min(TargetSize, DataBufferSize));
-				ReadSize = FILE->Tell() - CurPos;
-				TargetSize -= ReadSize;
-				Buffer.Append(DataBuffer.GetData(), ReadSize);
-			}
-		}
-		return Buffer.Num();
+		return ReadPos >= ReadEnd && !this->FillBuffer();
 	}
 
 	//ReadLine
 	FORCEINLINE void ReadLine(lua_State *L, bool bWithNewLineCh = false)
 	{
-		if (FILE->AtEnd())
+		if (this->AtEnd())
 		{
 			lua_pushnil(L);
+			return;
 		}
-		else
+
+		// fast path, the whole line is in the buffer
+		const uint8* Begin = ReadData + ReadPos;
+		const uint8* NewLine = (const uint8*)memchr(Begin, '\n', ReadEnd - ReadPos);
+		if (NewLine)
 		{
-			TArray<uint8> Buffer;
-			uint8 Ch;
-			while (!FILE->AtEnd())
+			const int64 Length = NewLine - Begin;
+			lua_pushlstring(L, (const char*)Begin, Length + (bWithNewLineCh ? 1 : 0));
+			ReadPos += Length + 1;
+			return;
+		}
+
+		luaL_Buffer Buffer;
+		luaL_buffinit(L, &Buffer);
+		while (!this->AtEnd())
+		{
+			Begin = ReadData + ReadPos;
+			NewLine = (const uint8*)memchr(Begin, '\n', ReadEnd - ReadPos);
+			const int64 Length = NewLine ? NewLine - Begin : ReadEnd - ReadPos;
+			luaL_addlstring(&Buffer, (const char*)Begin, Length + (NewLine && bWithNewLineCh ? 1 : 0));
+			ReadPos += Length;
+			if (NewLine)
 			{
-				FILE->SerializeBits(&Ch, sizeof(uint8) * 8);
-				if (Ch == '\n')
-				{
-					if (bWithNewLineCh)
-					{
-						Buffer.Add(Ch);
-					}
-					break;
-				}
-				Buffer.Add(Ch);
+				ReadPos++;
+				break;
 			}
-			lua_pushlstring(L, (const char*)Buffer.GetData(), Buffer.Num());
 		}
+		luaL_pushresult(&Buffer);
 	}
 
 
 	FORCEINLINE  void ReadNumber(lua_State *L)
 	{
-		if (FILE->AtEnd())
+		lua_Number Number = 0;
+		if (sizeof(lua_Number) != this->ReadRaw((uint8*)&Number, sizeof(lua_Number)))
 		{
 			lua_pushnumber(L, 0);
 		}
 		else
 		{
-			lua_Number Number = 0;
-			FILE->SerializeBits(&Number, sizeof(lua_Number) * 8);
 			lua_Integer IntegerNumber = (lua_Integer)floor((double)Number);
 			if (Number - IntegerNumber > 0)
 			{
@@ -212,42 +282,34 @@ public:
 
 	FORCEINLINE void ReadBytes(lua_State* L, int32 TryReadNumber)
 	{
-		if (0 >= TryReadNumber)
+		//if current is the end of file
+		if (this->AtEnd())
 		{
-			//if current is the end of file
-			if (FILE->AtEnd())
-			{
-				lua_pushnil(L);
-			}
-			else
-			{//return an empty lua_string
-				lua_pushliteral(L, "");
-			}
+			lua_pushnil(L);
+		}
+		else if (0 >= TryReadNumber)
+		{//return an empty lua_string
+			lua_pushliteral(L, "");
 		}
 		else
 		{
-			//if current is the end of file
-			if (FILE->AtEnd())
-			{
-				lua_pushnil(L);
-			}
-			else
-			{
-				//try read number of bytes (string buffer)
-				TArray<uint8> Buffer;
-				int32 ReadNumber = this->ReadSize(Buffer, TryReadNumber);
-				if (0 >= ReadNumber)
-				{
-					lua_pushnil(L);
-				}
-				else
-				{
-					lua_pushlstring(L, (const char*)Buffer.GetData(), ReadNumber);
-				}
-
-			}
+			const int64 Remaining = this->TotalSize() - this->Tell();
+			const int64 Size = FMath::Min<int64>(TryReadNumber, Remaining);
+			luaL_Buffer Buffer;
+			char* Dest = luaL_buffinitsize(L, &Buffer, Size);
+			luaL_pushresultsize(&Buffer, this->ReadRaw((uint8*)Dest, Size));
 		}
 	}
+
+	/** Read everything from the current offset, an empty string at the end of the file */
+	FORCEINLINE void ReadAll(lua_State* L)
+	{
+		const int64 Size = FMath::Max<int64>(this->TotalSize() - this->Tell(), 0);
+		luaL_Buffer Buffer;
+		char* Dest = luaL_buffinitsize(L, &Buffer, Size);
+		luaL_pushresultsize(&Buffer, this->ReadRaw((uint8*)Dest, Size));
+	}
+
 private:
 	bool HelperCheckFileMode(const FString& Mode, uint32& OutFlags, bool& OutIsWrite)
 	{
@@ -309,7 +371,70 @@ private:
 		return Ret;
 	}
 
+	void ResetReadBuffer()
+	{
+		this->ReadData = nullptr;
+		this->ReadPos = 0;
+		this->ReadEnd = 0;
+	}
+
+	/** Refill the read buffer from the archive, false at the end of the file */
+	bool FillBuffer()
+	{
+		if (MappedHandle.IsValid() || !FILE.IsValid() || !this->IsReadable())
+		{
+			return false;
+		}
+
+		const int64 Size = FMath::Min<int64>(FILE->TotalSize() - FILE->Tell(), this->BufferSize);
+		if (Size <= 0)
+		{
+			return false;
+		}
+
+		if (ReadBuffer.Num() < Size)
+		{
+			ReadBuffer.SetNumUninitialized(Size);
+		}
+		FILE->Serialize(ReadBuffer.GetData(), Size);
+		ReadData = ReadBuffer.GetData();
+		ReadPos = 0;
+		ReadEnd = Size;
+		return true;
+	}
+
+	/** Copy up to Size bytes, reading large blocks straight from the archive instead of through the buffer */
+	int64 ReadRaw(uint8* Dest, int64 Size)
+	{
+		int64 Done = FMath::Min(Size, ReadEnd - ReadPos);
+		if (Done > 0)
+		{
+			FMemory::Memcpy(Dest, ReadData + ReadPos, Done);
+			ReadPos += Done;
+		}
+
+		if (Done < Size && FILE.IsValid() && !MappedHandle.IsValid() && this->IsReadable())
+		{
+			const int64 Direct = FMath::Min(Size - Done, FILE->TotalSize() - FILE->Tell());
+			if (Direct > 0)
+			{
+				FILE->Serialize(Dest + Done, Direct);
+				Done += Direct;
+			}
+		}
+		return Done;
+	}
+
+	static constexpr int32 DefaultBufferSize = 64 * 1024;
+
 	TSharedPtr <FArchive> FILE;
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> ReadBuffer;
+	const uint8* ReadData; // ReadBuffer, or the whole file when it is mapped
+	int64 ReadPos;
+	int64 ReadEnd;
+	int32 BufferSize;
 	bool bWirte;
 	uint32 Flags;
 	FString FilePath;
@@ -327,22 +452,10 @@ static int32 UE4File_ReadFile(lua_State *L)
 		return 0;
 	}
 
-	TSharedPtr<FArchive> fileArchive = File->GetFArchive();
 	if (nargs < 1)
 	{
 		//read line
-		TArray<uint8> Buffer;
-		uint8 Ch;
-		while (!fileArchive->AtEnd())
-		{
-			fileArchive->SerializeBits(&Ch, sizeof(uint8) * 8);
-			if (Ch == '\n')
-			{
-				break;
-			}
-			Buffer.Add(Ch);
-		}
-		lua_pushlstring(L, (const char*)Buffer.GetData(), Buffer.Num());
+		File->ReadLine(L, false);
 		return 1;
 	}
 	else
@@ -377,16 +490,7 @@ static int32 UE4File_ReadFile(lua_State *L)
 				}
 				case 'a':
 				{
-					TArray<uint8> Buffer;
-					int32 ReadNumber = File->ReadSize(Buffer);
-					if (0 >= ReadNumber)
-					{
-						lua_pushliteral(L, "");
-					}
-					else
-					{
-						lua_pushlstring(L, (const char*)Buffer.GetData(), ReadNumber);
-					}
+					File->ReadAll(L);
 					break;
 				}
 				default:
@@ -420,6 +524,7 @@ static int32 UE4File_WriteFile(lua_State *L)
 	{
 		return 0;
 	}
+	File->SyncForWrite();
 	TSharedPtr<FArchive> fileArchive = File->GetFArchive();
 	for (; nargs--; arg++)
 	{
@@ -449,6 +554,226 @@ static int32 UE4File_WriteFile(lua_State *L)
 }
 
 
+static int32 UE4File_LinesIterator(lua_State *L)
+{
+	UE4File *File = (UE4File*)lua_touserdata(L, lua_upvalueindex(1));
+	if (!File || !File->IsValid() || !File->IsReadable())
+	{
+		return 0;
+	}
+	File->ReadLine(L, lua_toboolean(L, lua_upvalueindex(2)) != 0);
+	return 1;
+}
+
+/**
+ * for Line in File:Lines(["l"|"L"]) do ... end
+ */
+static int32 UE4File_Lines(lua_State *L)
+{
+	UE4File *File = (UE4File*)lua_touserdata(L, 1);
+	if (!File || !File->IsValid() || !File->IsReadable())
+	{
+		return 0;
+	}
+
+	const char *p = luaL_optstring(L, 2, "l");
+	if (*p == '*') p++;  /* skip optional '*' (for compatibility) */
+	luaL_argcheck(L, *p == 'l' || *p == 'L', 2, "invalid format");
+	lua_pushvalue(L, 1);
+	lua_pushboolean(L, *p == 'L');
+	lua_pushcclosure(L, UE4File_LinesIterator, 2);
+	return 1;
+}
+
+/**
+ * State shared by an async file request and the pool thread doing the work.
+ * Everything but bCancelled is only touched on the game thread.
+ */
+struct FLuaAsyncFileRequest
+{
+	UnLua::FLuaEnv* Env = nullptr;
+	int32 ThreadRef = LUA_NOREF;
+	TAtomic<bool> bCancelled { false };
+	bool bDone = false;
+	bool bWrite = false;
+	bool bSucceeded = false;
+	TArray<uint8> Data;
+	FString Error;
+};
+
+typedef TSharedPtr<FLuaAsyncFileRequest, ESPMode::ThreadSafe> FLuaAsyncFileRequestPtr;
+
+static const char* const AsyncFileRequestMetatableName = "UE.File.AsyncRequest";
+
+static FLuaAsyncFileRequestPtr& UE4FileAsync_CheckRequest(lua_State *L)
+{
+	return *(FLuaAsyncFileRequestPtr*)luaL_checkudata(L, 1, AsyncFileRequestMetatableName);
+}
+
+/** (Data) for a read, (true) for a write, (nil, Error) on failure */
+static int32 UE4FileAsync_PushResult(lua_State *L, const FLuaAsyncFileRequest& Request)
+{
+	if (!Request.bSucceeded)
+	{
+		lua_pushnil(L);
+		lua_pushstring(L, TCHAR_TO_UTF8(*Request.Error));
+		return 2;
+	}
+	if (Request.bWrite)
+	{
+		lua_pushboolean(L, true);
+		return 1;
+	}
+	lua_pushlstring(L, (const char*)Request.Data.GetData(), Request.Data.Num());
+	return 1;
+}
+
+/** Called on the game thread once the request is done or cancelled, wakes up the awaiting coroutine */
+static void UE4FileAsync_Complete(const FLuaAsyncFileRequestPtr& Request)
+{
+	Request->bDone = true;
+	const int32 ThreadRef = Request->ThreadRef;
+	Request->ThreadRef = LUA_NOREF;
+	if (Request->Env && ThreadRef != LUA_NOREF)
+	{
+		Request->Env->ResumeThread(ThreadRef, [&Request](lua_State* L) { return UE4FileAsync_PushResult(L, *Request); });
+	}
+}
+
+/** Suspend the calling coroutine until the request is done, returns at once if it already is */
+static int32 UE4FileAsync_Await(lua_State *L)
+{
+	FLuaAsyncFileRequestPtr& Request = UE4FileAsync_CheckRequest(L);
+	if (Request->bDone)
+	{
+		return UE4FileAsync_PushResult(L, *Request);
+	}
+	if (!lua_isyieldable(L))
+	{
+		return luaL_error(L, "Await must be called from a coroutine");
+	}
+	if (Request->ThreadRef != LUA_NOREF)
+	{
+		return luaL_error(L, "request is already awaited by another coroutine");
+	}
+	if (!Request->Env)
+	{
+		return luaL_error(L, "Await needs a lua state owned by UnLua");
+	}
+	Request->ThreadRef = Request->Env->FindOrAddThread(L);
+	return lua_yield(L, 0);
+}
+
+/** Drop the result of a pending request, an awaiting coroutine gets (nil, "cancelled") */
+static int32 UE4FileAsync_Cancel(lua_State *L)
+{
+	FLuaAsyncFileRequestPtr& Request = UE4FileAsync_CheckRequest(L);
+	if (!Request->bDone)
+	{
+		Request->bCancelled = true;
+		Request->bSucceeded = false;
+		Request->Error = TEXT("cancelled");
+		FLuaAsyncFileRequestPtr Pinned = Request;
+		UE4FileAsync_Complete(Pinned);
+	}
+	return 0;
+}
+
+static int32 UE4FileAsync_IsDone(lua_State *L)
+{
+	lua_pushboolean(L, UE4FileAsync_CheckRequest(L)->bDone);
+	return 1;
+}
+
+static int32 UE4FileAsync_Delete(lua_State *L)
+{
+	FLuaAsyncFileRequestPtr& Request = UE4FileAsync_CheckRequest(L);
+	// nobody can observe the result anymore, also happens for every pending request when the env closes
+	Request->bCancelled = true;
+	Request->Env = nullptr;
+	Request.~FLuaAsyncFileRequestPtr();
+	return 0;
+}
+
+static const luaL_Reg UE4FileAsyncRequestLib[] =
+{
+	{"Await", UE4FileAsync_Await},
+	{"Cancel", UE4FileAsync_Cancel},
+	{"IsDone", UE4FileAsync_IsDone},
+	{"__gc", UE4FileAsync_Delete},
+	{ nullptr, nullptr }
+};
+
+static int32 UE4FileAsync_Start(lua_State *L, const FString& Path, bool bWrite, TArray<uint8>&& Data)
+{
+	FLuaAsyncFileRequestPtr Request = MakeShared<FLuaAsyncFileRequest, ESPMode::ThreadSafe>();
+	Request->Env = UnLua::FLuaEnv::FindEnv(L);
+	Request->bWrite = bWrite;
+
+	void* Userdata = lua_newuserdata(L, sizeof(FLuaAsyncFileRequestPtr));
+	new(Userdata) FLuaAsyncFileRequestPtr(Request);
+	if (luaL_newmetatable(L, AsyncFileRequestMetatableName))
+	{
+		luaL_setfuncs(L, UE4FileAsyncRequestLib, 0);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, -2, "__index");
+	}
+	lua_setmetatable(L, -2);
+
+	Async(EAsyncExecution::ThreadPool, [Request, Path, Data = MoveTemp(Data)]() mutable
+	{
+		if (Request->bCancelled)
+		{
+			// requests cancelled while queued never touch the disk
+			return;
+		}
+		const bool bSucceeded = Request->bWrite
+			? FFileHelper::SaveArrayToFile(Data, *Path)
+			: FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent);
+		if (Request->bWrite)
+		{
+			Data.Empty();
+		}
+		AsyncTask(ENamedThreads::GameThread, [Request, Path, bSucceeded, Data = MoveTemp(Data)]() mutable
+		{
+			if (Request->bCancelled)
+			{
+				return;
+			}
+			Request->bSucceeded = bSucceeded;
+			Request->Data = MoveTemp(Data);
+			if (!bSucceeded)
+			{
+				Request->Error = FString::Printf(TEXT("%s: cannot %s file"), *Path, Request->bWrite ? TEXT("write") : TEXT("read"));
+			}
+			UE4FileAsync_Complete(Request);
+		});
+	});
+	return 1;
+}
+
+/**
+ * local Request = UE.File.ReadAsync(Path)
+ * local Data, Error = Request:Await()
+ */
+static int32 UE4File_ReadAsync(lua_State *L)
+{
+	const char* Path = luaL_checkstring(L, 1);
+	return UE4FileAsync_Start(L, UTF8_TO_TCHAR(Path), false, TArray<uint8>());
+}
+
+/**
+ * local Request = UE.File.WriteAsync(Path, Data)
+ * local Ok, Error = Request:Await()
+ */
+static int32 UE4File_WriteAsync(lua_State *L)
+{
+	const char* Path = luaL_checkstring(L, 1);
+	size_t Size = 0;
+	const char* Buffer = luaL_checklstring(L, 2, &Size);
+	return UE4FileAsync_Start(L, UTF8_TO_TCHAR(Path), true, TArray<uint8>((const uint8*)Buffer, (int32)Size));
+}
+
 static int32 UE4File_Delete(lua_State *L)
 {
 	int32 NumParams = lua_gettop(L);
@@ -471,6 +796,9 @@ static const luaL_Reg UE4FileLib[] =
 {
 	{"Read", UE4File_ReadFile },
 	{"Write",UE4File_WriteFile},
+	{"Lines",UE4File_Lines},
+	{"ReadAsync",UE4File_ReadAsync},
+	{"WriteAsync",UE4File_WriteAsync},
 	{"__gc",UE4File_Delete},
 	{ nullptr, nullptr }
 };
@@ -479,6 +807,8 @@ static const luaL_Reg UE4FileLib[] =
 BEGIN_EXPORT_NAMED_CLASS(File,UE4File)
 ADD_LIB(UE4FileLib)
 ADD_FUNCTION(Open)
+ADD_FUNCTION(OpenMapped)
+ADD_FUNCTION(SetBufferSize)
 ADD_FUNCTION(Close)
 ADD_FUNCTION(Seek)
 ADD_FUNCTION(TotalSize)
@@ -71,8 +71,8 @@ static int TMap_Enumerable(lua_State* L)
         }
         else
         {
-            Map->KeyInterface->ReadValue(L, Map->GetData((*Enumerator)->Index), false);
-            Map->ValueInterface->ReadValue(L, Map->GetData((*Enumerator)->Index) + Map->MapLayout.ValueOffset, false);
+            Map->KeyAccessor.Read(L, Map->GetData((*Enumerator)->Index), false);
+            Map->ValueAccessor.Read(L, Map->GetData((*Enumerator)->Index) + Map->MapLayout.ValueOffset, false);
             ++(*Enumerator)->Index;
             return 2;
         }
@@ -137,8 +137,8 @@ static int32 TMap_Add(lua_State* L)
     void* ValueCache = (uint8*)Map->ElementCache + Map->MapLayout.ValueOffset;
     Map->KeyInterface->Initialize(Map->ElementCache);
     Map->ValueInterface->Initialize(ValueCache);
-    Map->KeyInterface->WriteValue_InContainer(L, Map->ElementCache, 2);
-    Map->ValueInterface->WriteValue_InContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, 3);
+    Map->KeyAccessor.WriteInContainer(L, Map->ElementCache, 2);
+    Map->ValueAccessor.WriteInContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, 3);
     Map->Add(Map->ElementCache, ValueCache);
     Map->KeyInterface->Destruct(Map->ElementCache);
     Map->ValueInterface->Destruct(ValueCache);
@@ -158,7 +158,7 @@ static int32 TMap_Remove(lua_State* L)
     TMap_Guard(L, Map);
 
     Map->KeyInterface->Initialize(Map->ElementCache);
-    Map->KeyInterface->WriteValue_InContainer(L, Map->ElementCache, 2);
+    Map->KeyAccessor.WriteInContainer(L, Map->ElementCache, 2);
     bool bSuccess = Map->Remove(Map->ElementCache);
     Map->KeyInterface->Destruct(Map->ElementCache);
     lua_pushboolean(L, bSuccess);
@@ -180,11 +180,11 @@ static int32 TMap_Find(lua_State* L)
     void* ValueCache = (uint8*)Map->ElementCache + Map->MapLayout.ValueOffset;
     Map->KeyInterface->Initialize(Map->ElementCache);
     Map->ValueInterface->Initialize(ValueCache);
-    Map->KeyInterface->WriteValue_InContainer(L, Map->ElementCache, 2);
+    Map->KeyAccessor.WriteInContainer(L, Map->ElementCache, 2);
     bool bSuccess = Map->Find(Map->ElementCache, ValueCache);
     if (bSuccess)
     {
-        Map->ValueInterface->ReadValue_InContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, true);
+        Map->ValueAccessor.ReadInContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, true);
     }
     else
     {
@@ -208,11 +208,11 @@ static int32 TMap_FindRef(lua_State* L)
     TMap_Guard(L, Map);
 
     Map->KeyInterface->Initialize(Map->ElementCache);
-    Map->KeyInterface->WriteValue_InContainer(L, Map->ElementCache, 2);
+    Map->KeyAccessor.WriteInContainer(L, Map->ElementCache, 2);
     void* Value = Map->Find(Map->ElementCache);
     if (Value)
     {
-        Map->ValueInterface->ReadValue(L, Value, false);
+        Map->ValueAccessor.Read(L, Value, false);
     }
     else
     {
@@ -311,14 +311,14 @@ static int32 TMap_ToTable(lua_State* L)
     for (int32 i = 0; i < Keys->Num(); ++i)
     {
         Keys->Get(i, Keys->ElementCache);
-        Keys->Inner->ReadValue_InContainer(L, Keys->ElementCache, true);
+        Keys->InnerAccessor.ReadInContainer(L, Keys->ElementCache, true);
 
         void* ValueCache = (uint8*)Map->ElementCache + Map->MapLayout.ValueOffset;
         Map->ValueInterface->Initialize(ValueCache);
         bool bSuccess = Map->Find(Keys->ElementCache, ValueCache);
         if (bSuccess)
         {
-            Map->ValueInterface->ReadValue_InContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, true);
+            Map->ValueAccessor.ReadInContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, true);
         }
         else
         {
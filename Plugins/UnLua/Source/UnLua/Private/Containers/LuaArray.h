@@ -190,6 +190,7 @@
 #pragma once
 
 #include "LuaContainerInterface.h"
+#include "LuaContainerElement.h"
 
 #if ENGINE_MAJOR_VERSION >=5
 #define ALIGNMENT_PLACEHOLDER ,__STDCPP_DEFAULT_NEW_ALIGNMENT__ 
@@ -230,22 +231,36 @@ public:
     };
 
     FLuaArray(const FScriptArray* InScriptArray, TSharedPtr<UnLua::ITypeInterface> InInnerInterface, EScriptArrayFlag Flag = OwnedByOther)
-        : ScriptArray((FScriptArray*)InScriptArray), Inner(InInnerInterface), ElementCache(nullptr), ElementSize(Inner->GetSize()), ScriptArrayFlag(Flag)
+        : ScriptArray((FScriptArray*)InScriptArray), Inner(InInnerInterface), InnerAccessor(InInnerInterface), ElementCache(nullptr), ElementSize(Inner->GetSize()), ScriptArrayFlag(Flag), bInlineStorage(false)
     {
         // allocate cache for a single element
         ElementCache = FMemory::Malloc(ElementSize, Inner->GetAlignment());
         UNLUA_STAT_MEMORY_ALLOC(ElementCache, ContainerElementCache);
     }
 
+    /**
+     * Create an empty array owned by self, with the script array and the element cache in memory owned by the caller
+     */
+    FLuaArray(const UnLua::FContainerType& Type, void* ScriptArrayStorage, void* ElementCacheStorage)
+        : ScriptArray(new(ScriptArrayStorage) FScriptArray), Inner(Type.Inner), InnerAccessor(Type.InnerAccessor), ElementCache(ElementCacheStorage), ElementSize(Type.ElementCacheSize), ScriptArrayFlag(OwnedBySelf), bInlineStorage(true)
+    {
+    }
+
     ~FLuaArray()
     {
         if (ScriptArrayFlag == OwnedBySelf)
         {
             Clear();
-            delete ScriptArray;
+            if (bInlineStorage)
+                ScriptArray->~FScriptArray();
+            else
+                delete ScriptArray;
+        }
+        if (!bInlineStorage)
+        {
+            UNLUA_STAT_MEMORY_FREE(ElementCache, ContainerElementCache);
+            FMemory::Free(ElementCache);
         }
-        UNLUA_STAT_MEMORY_FREE(ElementCache, ContainerElementCache);
-        FMemory::Free(ElementCache);
     }
 
     FORCEINLINE FScriptArray* GetContainerPtr() const { return ScriptArray; }
@@ -559,9 +574,11 @@ public:
 
     FScriptArray* ScriptArray;
     TSharedPtr<UnLua::ITypeInterface> Inner;
+    UnLua::FContainerElementAccessor InnerAccessor;
     void* ElementCache;            // can only hold one element...
     int32 ElementSize;
     EScriptArrayFlag ScriptArrayFlag;
+    bool bInlineStorage;
 
 private:
     /**
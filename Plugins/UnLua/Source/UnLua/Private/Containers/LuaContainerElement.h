@@ -0,0 +1,206 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "LuaCore.h"
+#include "UnLuaBase.h"
+#include "LowLevel.h"
+
+namespace UnLua
+{
+    /**
+     * Reads and writes the elements of a container.
+     *
+     * The kind of element is resolved once when the container is created. Plain numbers, bools, names and objects are then
+     * read and written inline; every other kind goes through the virtual type interface, which also validates the
+     * property on each call.
+     */
+    class FContainerElementAccessor
+    {
+    public:
+        enum class EKind : uint8
+        {
+            Generic,
+            Int8,
+            Int16,
+            Int32,
+            Int64,
+            UInt8,
+            UInt16,
+            UInt32,
+            Float,
+            Double,
+            Bool,
+            Name,
+            Object,
+        };
+
+        FContainerElementAccessor()
+            : Interface(nullptr), Offset(0), Kind(EKind::Generic)
+        {
+        }
+
+        explicit FContainerElementAccessor(const TSharedPtr<ITypeInterface>& InInterface)
+            : Interface(InInterface.Get()), Offset(0), Kind(EKind::Generic)
+        {
+            const FProperty* Property = Interface ? Interface->GetUProperty() : nullptr;
+            if (!Property || Property->ArrayDim != 1)
+                return;
+
+            Kind = ResolveKind(Property);
+            if (Kind != EKind::Generic)
+                Offset = Interface->GetOffset();
+        }
+
+        FORCEINLINE EKind GetKind() const { return Kind; }
+
+        /** @see ITypeOps::ReadValue */
+        FORCEINLINE void Read(lua_State* L, const void* ValuePtr, bool bCreateCopy) const
+        {
+            switch (Kind)
+            {
+            case EKind::Int8: lua_pushinteger(L, *(const int8*)ValuePtr); break;
+            case EKind::Int16: lua_pushinteger(L, *(const int16*)ValuePtr); break;
+            case EKind::Int32: lua_pushinteger(L, *(const int32*)ValuePtr); break;
+            case EKind::Int64: lua_pushinteger(L, *(const int64*)ValuePtr); break;
+            case EKind::UInt8: lua_pushinteger(L, *(const uint8*)ValuePtr); break;
+            case EKind::UInt16: lua_pushinteger(L, *(const uint16*)ValuePtr); break;
+            case EKind::UInt32: lua_pushinteger(L, *(const uint32*)ValuePtr); break;
+            case EKind::Float: lua_pushnumber(L, *(const float*)ValuePtr); break;
+            case EKind::Double: lua_pushnumber(L, *(const double*)ValuePtr); break;
+            case EKind::Bool: lua_pushboolean(L, *(const bool*)ValuePtr); break;
+            case EKind::Name: lua_pushstring(L, TCHAR_TO_UTF8(*((const FName*)ValuePtr)->ToString())); break;
+            case EKind::Object: PushUObject(L, GetObject(ValuePtr)); break;
+            default: Interface->ReadValue(L, ValuePtr, bCreateCopy); break;
+            }
+        }
+
+        /** @see ITypeOps::ReadValue_InContainer */
+        FORCEINLINE void ReadInContainer(lua_State* L, const void* ContainerPtr, bool bCreateCopy) const
+        {
+            if (Kind == EKind::Generic)
+                Interface->ReadValue_InContainer(L, ContainerPtr, bCreateCopy);
+            else
+                Read(L, (const uint8*)ContainerPtr + Offset, bCreateCopy);
+        }
+
+        /** @see ITypeOps::WriteValue_InContainer */
+        FORCEINLINE bool WriteInContainer(lua_State* L, void* ContainerPtr, int32 IndexInStack) const
+        {
+            void* ValuePtr = (uint8*)ContainerPtr + Offset;
+            switch (Kind)
+            {
+            case EKind::Int8: *(int8*)ValuePtr = (int8)lua_tointeger(L, IndexInStack); return false;
+            case EKind::Int16: *(int16*)ValuePtr = (int16)lua_tointeger(L, IndexInStack); return false;
+            case EKind::Int32: *(int32*)ValuePtr = (int32)lua_tointeger(L, IndexInStack); return false;
+            case EKind::Int64: *(int64*)ValuePtr = (int64)lua_tointeger(L, IndexInStack); return false;
+            case EKind::UInt8: *(uint8*)ValuePtr = (uint8)lua_tointeger(L, IndexInStack); return false;
+            case EKind::UInt16: *(uint16*)ValuePtr = (uint16)lua_tointeger(L, IndexInStack); return false;
+            case EKind::UInt32: *(uint32*)ValuePtr = (uint32)lua_tointeger(L, IndexInStack); return false;
+            case EKind::Float: *(float*)ValuePtr = (float)lua_tonumber(L, IndexInStack); return false;
+            case EKind::Double: *(double*)ValuePtr = (double)lua_tonumber(L, IndexInStack); return false;
+            case EKind::Bool: *(bool*)ValuePtr = lua_toboolean(L, IndexInStack) != 0; return false;
+            case EKind::Name: *(FName*)ValuePtr = FName(UTF8_TO_TCHAR(lua_tostring(L, IndexInStack))); return true;
+            case EKind::Object: return WriteObject(L, ValuePtr, IndexInStack);
+            default: return Interface->WriteValue_InContainer(L, ContainerPtr, IndexInStack);
+            }
+        }
+
+    private:
+        static EKind ResolveKind(const FProperty* Property)
+        {
+            const FFieldClass* Class = Property->GetClass();
+            if (Class == FIntProperty::StaticClass())
+                return EKind::Int32;
+            if (Class == FFloatProperty::StaticClass())
+                return EKind::Float;
+            if (Class == FNameProperty::StaticClass())
+                return EKind::Name;
+            if (Class == FObjectProperty::StaticClass())
+            {
+                // class, soft and weak references keep their own checks
+                const bool bClass = ((const FObjectProperty*)Property)->PropertyClass->IsChildOf(UClass::StaticClass());
+                return bClass ? EKind::Generic : EKind::Object;
+            }
+            if (Class == FBoolProperty::StaticClass())
+                return ((const FBoolProperty*)Property)->IsNativeBool() ? EKind::Bool : EKind::Generic;
+            if (Class == FInt64Property::StaticClass())
+                return EKind::Int64;
+            if (Class == FDoubleProperty::StaticClass())
+                return EKind::Double;
+            if (Class == FByteProperty::StaticClass())
+                return EKind::UInt8;
+            if (Class == FInt8Property::StaticClass())
+                return EKind::Int8;
+            if (Class == FInt16Property::StaticClass())
+                return EKind::Int16;
+            if (Class == FUInt16Property::StaticClass())
+                return EKind::UInt16;
+            if (Class == FUInt32Property::StaticClass())
+                return EKind::UInt32;
+            return EKind::Generic;
+        }
+
+        static FORCEINLINE UObject* GetObject(const void* ValuePtr)
+        {
+#if ENGINE_MAJOR_VERSION >= 5
+            return ((const FObjectPtr*)ValuePtr)->Get();
+#else
+            return *(UObject* const*)ValuePtr;
+#endif
+        }
+
+        bool WriteObject(lua_State* L, void* ValuePtr, int32 IndexInStack) const
+        {
+            UObject* Object = GetUObject(L, IndexInStack, false);
+            if (LowLevel::IsReleasedPtr(Object))
+            {
+                UNLUA_LOGWARNING(L, LogUnLua, Warning, TEXT("attempt to set property %s with released object"), *Interface->GetName());
+                Object = nullptr;
+            }
+#if ENABLE_TYPE_CHECK == 1
+            if (Object)
+            {
+                const UClass* PropertyClass = ((const FObjectProperty*)Interface->GetUProperty())->PropertyClass;
+                if (!Object->GetClass()->IsChildOf(PropertyClass))
+                    UNLUA_LOGERROR(L, LogUnLua, Warning, TEXT("Invalid value type : property.type=%s, value.type=%s"), *PropertyClass->GetName(), *Object->GetClass()->GetName());
+            }
+#endif
+#if ENGINE_MAJOR_VERSION >= 5
+            *(FObjectPtr*)ValuePtr = Object;
+#else
+            *(UObject**)ValuePtr = Object;
+#endif
+            return true;
+        }
+
+        ITypeInterface* Interface;
+        int32 Offset;
+        EKind Kind;
+    };
+
+    /**
+     * What every container of the same element types shares, built once by FContainerRegistry and never changed.
+     */
+    struct FContainerType
+    {
+        TSharedPtr<ITypeInterface> Inner; // element of arrays and sets, key of maps
+        TSharedPtr<ITypeInterface> Extra; // value of maps
+        FContainerElementAccessor InnerAccessor;
+        FContainerElementAccessor ExtraAccessor;
+        int32 ElementCacheSize; // a single element, or a key-value pair with alignment
+        int32 ElementCacheAlignment;
+    };
+}
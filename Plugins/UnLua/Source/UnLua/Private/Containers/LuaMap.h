@@ -51,7 +51,7 @@ public:
 
     FLuaMap(const FScriptMap *InScriptMap, TSharedPtr<UnLua::ITypeInterface> InKeyInterface, TSharedPtr<UnLua::ITypeInterface> InValueInterface, FScriptMapFlag Flag = OwnedByOther)
         : Map((FScriptMap*)InScriptMap), MapLayout(FScriptMap::GetScriptLayout(InKeyInterface->GetSize(), InKeyInterface->GetAlignment(), InValueInterface->GetSize(), InValueInterface->GetAlignment()))
-        , KeyInterface(InKeyInterface), ValueInterface(InValueInterface), Interface(nullptr), ElementCache(nullptr), ScriptMapFlag(Flag)
+        , KeyInterface(InKeyInterface), ValueInterface(InValueInterface), KeyAccessor(InKeyInterface), ValueAccessor(InValueInterface), Interface(nullptr), ElementCache(nullptr), ScriptMapFlag(Flag), bInlineStorage(false)
     {
         FStructBuilder StructBuilder;
         StructBuilder.AddMember(InKeyInterface->GetSize(), InKeyInterface->GetAlignment());
@@ -62,12 +62,14 @@ public:
     }
 
     FLuaMap(const FScriptMap *InScriptMap, TLuaContainerInterface<FLuaMap> *InMapInterface, FScriptMapFlag Flag = OwnedByOther)
-        : Map((FScriptMap*)InScriptMap), Interface(InMapInterface), ElementCache(nullptr), ScriptMapFlag(Flag)
+        : Map((FScriptMap*)InScriptMap), Interface(InMapInterface), ElementCache(nullptr), ScriptMapFlag(Flag), bInlineStorage(false)
     {
         if (Interface)
         {
             KeyInterface = Interface->GetInnerInterface();
             ValueInterface = Interface->GetExtraInterface();
+            KeyAccessor = UnLua::FContainerElementAccessor(KeyInterface);
+            ValueAccessor = UnLua::FContainerElementAccessor(ValueInterface);
             MapLayout = FScriptMap::GetScriptLayout(KeyInterface->GetSize(), KeyInterface->GetAlignment(), ValueInterface->GetSize(), ValueInterface->GetAlignment());
 
             FStructBuilder StructBuilder;
@@ -79,15 +81,30 @@ public:
         }
     }
 
+    /**
+     * Create an empty map owned by self, with the script map and the key-value cache in memory owned by the caller
+     */
+    FLuaMap(const UnLua::FContainerType& Type, void* ScriptMapStorage, void* ElementCacheStorage)
+        : Map(new(ScriptMapStorage) FScriptMap), MapLayout(FScriptMap::GetScriptLayout(Type.Inner->GetSize(), Type.Inner->GetAlignment(), Type.Extra->GetSize(), Type.Extra->GetAlignment()))
+        , KeyInterface(Type.Inner), ValueInterface(Type.Extra), KeyAccessor(Type.InnerAccessor), ValueAccessor(Type.ExtraAccessor), Interface(nullptr), ElementCache(ElementCacheStorage), ScriptMapFlag(OwnedBySelf), bInlineStorage(true)
+    {
+    }
+
     ~FLuaMap()
     {
         if (ScriptMapFlag == OwnedBySelf)
         {
             Clear();
-            delete Map;
+            if (bInlineStorage)
+                Map->~FScriptMap();
+            else
+                delete Map;
+        }
+        if (!bInlineStorage)
+        {
+            UNLUA_STAT_MEMORY_FREE(ElementCache, ContainerElementCache);
+            FMemory::Free(ElementCache);
         }
-        UNLUA_STAT_MEMORY_FREE(ElementCache, ContainerElementCache);
-        FMemory::Free(ElementCache);
     }
 
     FORCEINLINE FScriptMap* GetContainerPtr() const { return Map; }
@@ -362,10 +379,13 @@ public:
     FScriptMapLayout MapLayout;
     TSharedPtr<UnLua::ITypeInterface> KeyInterface;
     TSharedPtr<UnLua::ITypeInterface> ValueInterface;
+    UnLua::FContainerElementAccessor KeyAccessor;
+    UnLua::FContainerElementAccessor ValueAccessor;
     TLuaContainerInterface<FLuaMap> *Interface;
     //FScriptMapHelper MapHelper;
     void *ElementCache;             // can only hold a key-value pair
     FScriptMapFlag ScriptMapFlag;
+    bool bInlineStorage;
 
 private:
     void DestructItems(int32 Index, int32 Count)
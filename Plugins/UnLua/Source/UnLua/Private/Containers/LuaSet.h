@@ -27,7 +27,7 @@ public:
 
     FLuaSet(const FScriptSet *InScriptSet, TSharedPtr<UnLua::ITypeInterface> InElementInterface, FScriptSetFlag Flag = OwnedByOther)
         : Set((FScriptSet*)InScriptSet), SetLayout(FScriptSet::GetScriptLayout(InElementInterface->GetSize(), InElementInterface->GetAlignment()))
-        , ElementInterface(InElementInterface), ElementCache(nullptr), ScriptSetFlag(Flag)
+        , ElementInterface(InElementInterface), ElementAccessor(InElementInterface), ElementCache(nullptr), ScriptSetFlag(Flag), bInlineStorage(false)
     {
         // allocate cache for a single element
         ElementCache = FMemory::Malloc(ElementInterface->GetSize(), ElementInterface->GetAlignment());
@@ -35,9 +35,10 @@ public:
     }
 
     FLuaSet(const FScriptSet *InScriptSet, TLuaContainerInterface<FLuaSet> *Interface, FScriptSetFlag Flag = OwnedByOther)
-        : Set((FScriptSet*)InScriptSet), ElementCache(nullptr), ScriptSetFlag(Flag)
+        : Set((FScriptSet*)InScriptSet), ElementCache(nullptr), ScriptSetFlag(Flag), bInlineStorage(false)
     {
         ElementInterface = Interface->GetInnerInterface();
+        ElementAccessor = UnLua::FContainerElementAccessor(ElementInterface);
         SetLayout = FScriptSet::GetScriptLayout(ElementInterface->GetSize(), ElementInterface->GetAlignment());
 
         // allocate cache for a single element
@@ -45,15 +46,30 @@ public:
         UNLUA_STAT_MEMORY_ALLOC(ElementCache, ContainerElementCache);
     }
 
+    /**
+     * Create an empty set owned by self, with the script set and the element cache in memory owned by the caller
+     */
+    FLuaSet(const UnLua::FContainerType& Type, void* ScriptSetStorage, void* ElementCacheStorage)
+        : Set(new(ScriptSetStorage) FScriptSet), SetLayout(FScriptSet::GetScriptLayout(Type.ElementCacheSize, Type.ElementCacheAlignment))
+        , ElementInterface(Type.Inner), ElementAccessor(Type.InnerAccessor), Interface(nullptr), ElementCache(ElementCacheStorage), ScriptSetFlag(OwnedBySelf), bInlineStorage(true)
+    {
+    }
+
     ~FLuaSet()
     {
         if (ScriptSetFlag == OwnedBySelf)
         {
             Clear();
-            delete Set;
+            if (bInlineStorage)
+                Set->~FScriptSet();
+            else
+                delete Set;
+        }
+        if (!bInlineStorage)
+        {
+            UNLUA_STAT_MEMORY_FREE(ElementCache, ContainerElementCache);
+            FMemory::Free(ElementCache);
         }
-        UNLUA_STAT_MEMORY_FREE(ElementCache, ContainerElementCache);
-        FMemory::Free(ElementCache);
     }
 
     FORCEINLINE FScriptSet* GetContainerPtr() const { return Set; }
@@ -230,10 +246,12 @@ public:
     FScriptSet *Set;
     FScriptSetLayout SetLayout;
     TSharedPtr<UnLua::ITypeInterface> ElementInterface;
+    UnLua::FContainerElementAccessor ElementAccessor;
     TLuaContainerInterface<FLuaSet> *Interface;
     //FScriptSetHelper SetHelper;
     void *ElementCache;            // can only hold one element...
     FScriptSetFlag ScriptSetFlag;
+    bool bInlineStorage;
 
 private:
     void DestructItems(int32 Index, int32 Count)
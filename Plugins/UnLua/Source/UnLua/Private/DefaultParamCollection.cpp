@@ -4,39 +4,29 @@
 
 // ### **1. 核心数据结构**
 // ```cpp
-// TMap<FName, FFunctionCollection> GDefaultParamCollection;
+// static constexpr FDefaultParamClassEntry GDefaultParamClasses[] = { ... };
+// static constexpr FDefaultParamFunctionEntry GDefaultParamFunctions[] = { ... };
+// static constexpr FDefaultParamSlot GDefaultParamSlots[] = { ... };
 // ```
-// - **功能**：全局注册表，存储所有需要默认参数的 UE 函数信息
-// - **键**：函数全名（`FName` 格式，如 "GameFramework.Actor.ReceiveBeginPlay"）
-// - **值**：`FFunctionCollection` 结构，保存该函数各参数的默认值
+// - **功能**：由 `DefaultParamTable.inl` 生成的常量表，类 → 函数 → 参数槽位
+// - **排序**：类名和函数名按字符顺序排列，查找时二分
+// - **槽位**：参数序号、参数名、类型和字面值（数字、数学结构的分量或字符串）
 
 // ---
 
-// ### **2. 初始化机制**
+// ### **2. 按需构建**
 // ```cpp
-// void CreateDefaultParamCollection() {
-//     static bool CollectionCreated = false;
-//     if (!CollectionCreated) {
-//         CollectionCreated = true;
-//         #include "DefaultParamCollection.inl"
-//     }
-// }
+// FFunctionCollection* FindDefaultParamCollection(const TCHAR* ClassName);
 // ```
-// - **一次性初始化**：通过静态变量确保仅执行一次
-// - **内联文件**：`DefaultParamCollection.inl` 包含实际数据填充逻辑（由构建时生成）
+// - **首次使用**：类描述创建时查找该类，把槽位构建成 `FDefaultParameter`，之后直接返回缓存
+// - **内存**：默认值内联存放在参数数组里，每个函数只分配一次，没有每个值一次的堆分配
+// - **统计**：`Build Default Parameters` 记录构建耗时，`Default Parameter Memory` 记录构建出的内存
 
 // ---
 
-// ### **3. 编译器优化控制**
-// ```cpp
-// #if UE_VERSION_OLDER_THAN(5, 2, 0)
-// PRAGMA_DISABLE_OPTIMIZATION
-// #else
-// UE_DISABLE_OPTIMIZATION
-// #endif
-// ```
-// - **作用**：禁用编译器优化，确保复杂初始化逻辑的正确性
-// - **跨版本支持**：适配 UE5.2 前后不同的优化指令宏
+// ### **3. 启动开销**
+// - 启动时 `CreateDefaultParamCollection` 只输出表的大小，不再执行成千上万条 `new` 和 `TMap::Add`
+// - 生成的只是数据，不再需要关闭编译优化
 
 // ---
 
@@ -44,16 +34,14 @@
 // 1. **数据生成**（构建时）：
 //    - 扫描项目及引擎的反射数据
 //    - 提取所有带默认参数的 `UFunction`
-//    - 生成 `DefaultParamCollection.inl` 文件，包含类似：
+//    - 排序后生成 `DefaultParamTable.inl`，包含类似：
 //      ```cpp
-//      GDefaultParamCollection.Add(
-//          TEXT("GameFramework.Actor.ReceiveBeginPlay"),
-//          FFunctionCollection{/* 参数默认值 */});
+//      { 1, TEXT("Location"), EDefaultParamType::Vector, { 0.0, 0.0, 100.0 }, nullptr },
 //      ```
      
 // 2. **运行时加载**：
-//    - 引擎启动时调用 `CreateDefaultParamCollection`
-//    - 加载预生成的默认参数到全局映射表
+//    - 类描述创建时调用 `FindDefaultParamCollection`
+//    - 函数描述按参数序号取出默认值
 
 // ---
 
@@ -63,7 +51,7 @@
 // -- 示例：C++ 函数 void Spawn(TSubclassOf<AActor> Class, FVector Location = FVector::ZeroVector)
 // UE.Actor.Spawn(MyClass) -- 自动填充 Location 参数
 // ```
-// - UnLua 生成绑定代码时，查询 `GDefaultParamCollection`
+// - UnLua 注册类时，查询 `FindDefaultParamCollection`
 // - 为有默认值的参数生成可选参数逻辑
 
 // #### **性能优化**
@@ -112,30 +100,133 @@
 // See the License for the specific language governing permissions and limitations under the License.
 
 #include "DefaultParamCollection.h"
-#include "Misc/EngineVersionComparison.h"
+#include "Algo/BinarySearch.h"
 #include "CoreUObject.h"
+#include "UnLuaBase.h"
+#include "UnLuaPrivate.h"
 
-TMap<FName, FFunctionCollection> GDefaultParamCollection;
+#include "DefaultParamTable.inl"
 
-#if UE_VERSION_OLDER_THAN(5, 2, 0)
-PRAGMA_DISABLE_OPTIMIZATION
-#else
-UE_DISABLE_OPTIMIZATION
-#endif
+UNLUA_DEFINE_STAT(DefaultParam_Memory);
+UNLUA_DECLARE_CYCLE_STAT("Build Default Parameters", UnLua_BuildDefaultParams);
 
-void CreateDefaultParamCollection()
+// the generated arrays end with an empty entry so none of them is ever empty
+static constexpr int32 NumDefaultParamClasses = UE_ARRAY_COUNT(GDefaultParamClasses) - 1;
+static constexpr int32 NumDefaultParamFunctions = UE_ARRAY_COUNT(GDefaultParamFunctions) - 1;
+static constexpr int32 NumDefaultParamSlots = UE_ARRAY_COUNT(GDefaultParamSlots) - 1;
+
+static TMap<FName, TUniquePtr<FFunctionCollection>> GDefaultParamCollection; // classes built so far
+
+static void BuildDefaultParamValue(const FDefaultParamSlot& Slot, FDefaultParamValue& Value)
 {
-    static bool CollectionCreated = false;
-    if (!CollectionCreated)
+    const double* N = Slot.Numbers;
+    switch (Slot.Type)
     {
-        CollectionCreated = true;
+    case EDefaultParamType::Bool:
+        new(&Value.Bool) bool(N[0] != 0);
+        break;
+    case EDefaultParamType::Byte:
+        new(&Value.Byte) uint8((uint8)N[0]);
+        break;
+    case EDefaultParamType::Int:
+        new(&Value.Int) int32((int32)N[0]);
+        break;
+    case EDefaultParamType::Enum:
+        new(&Value.Enum) int64((int64)N[0]);
+        break;
+    case EDefaultParamType::RuntimeEnum:
+        {
+            const UEnum* Enum = FindFirstObject<UEnum>(Slot.String);
+            new(&Value.Enum) int64(Enum ? Enum->GetValueByIndex((int32)N[0]) : 0);
+        }
+        break;
+    case EDefaultParamType::Float:
+        new(&Value.Float) float((float)N[0]);
+        break;
+    case EDefaultParamType::Double:
+        new(&Value.Double) double(N[0]);
+        break;
+    case EDefaultParamType::Name:
+        new(&Value.Name) FName(Slot.String);
+        break;
+    case EDefaultParamType::Text:
+        new(&Value.Text) FText(FText::FromString(Slot.String));
+        break;
+    case EDefaultParamType::InvariantText:
+        new(&Value.Text) FText(FText::AsCultureInvariant(Slot.String));
+        break;
+    case EDefaultParamType::String:
+        new(&Value.String) FString(Slot.String);
+        break;
+    case EDefaultParamType::Vector:
+        new(&Value.Vector) FVector(N[0], N[1], N[2]);
+        break;
+    case EDefaultParamType::Vector2D:
+        new(&Value.Vector2D) FVector2D(N[0], N[1]);
+        break;
+    case EDefaultParamType::Rotator:
+        new(&Value.Rotator) FRotator(N[0], N[1], N[2]);
+        break;
+    case EDefaultParamType::LinearColor:
+        new(&Value.LinearColor) FLinearColor(N[0], N[1], N[2], N[3]);
+        break;
+    case EDefaultParamType::Color:
+        new(&Value.Color) FColor((uint8)N[0], (uint8)N[1], (uint8)N[2], (uint8)N[3]);
+        break;
+    case EDefaultParamType::ScriptArray:
+        new(&Value.ScriptArray) FScriptArray();
+        break;
+    case EDefaultParamType::ScriptDelegate:
+        new(&Value.ScriptDelegate) FScriptDelegate();
+        break;
+    case EDefaultParamType::MulticastScriptDelegate:
+        new(&Value.MulticastScriptDelegate) FMulticastScriptDelegate();
+        break;
+    default:
+        checkNoEntry();
+    }
+}
 
-#include "DefaultParamCollection.inl"
+FFunctionCollection* FindDefaultParamCollection(const TCHAR* ClassName)
+{
+    const FName Key(ClassName);
+    if (const TUniquePtr<FFunctionCollection>* Built = GDefaultParamCollection.Find(Key))
+        return Built->Get();
+
+    const TArrayView<const FDefaultParamClassEntry> Classes(GDefaultParamClasses, NumDefaultParamClasses);
+    const int32 ClassIndex = Algo::BinarySearchBy(Classes, ClassName, &FDefaultParamClassEntry::Name, [](const TCHAR* A, const TCHAR* B) { return FCString::Strcmp(A, B) < 0; });
+    if (ClassIndex == INDEX_NONE)
+        return nullptr;
+
+    UNLUA_SCOPE_CYCLE_COUNTER(UnLua_BuildDefaultParams);
+
+    const FDefaultParamClassEntry& Class = Classes[ClassIndex];
+    TUniquePtr<FFunctionCollection> Collection = MakeUnique<FFunctionCollection>();
+    Collection->Functions.Reserve(Class.NumFunctions);
+    SIZE_T AllocatedSize = Collection->Functions.GetAllocatedSize();
+    for (int32 i = Class.FirstFunction; i < Class.FirstFunction + Class.NumFunctions; i++)
+    {
+        const FDefaultParamFunctionEntry& Function = GDefaultParamFunctions[i];
+        TArray<FDefaultParameter>& Parameters = Collection->Functions.Add(Function.Name).Parameters;
+        Parameters.SetNum(Function.NumSlots); // sized once, the values are built in place and never move
+        for (int32 j = 0; j < Function.NumSlots; j++)
+        {
+            const FDefaultParamSlot& Slot = GDefaultParamSlots[Function.FirstSlot + j];
+            Parameters[j].Index = Slot.Index;
+            Parameters[j].Name = Slot.Name;
+            BuildDefaultParamValue(Slot, Parameters[j].Value);
+        }
+        AllocatedSize += Parameters.GetAllocatedSize();
     }
+    INC_MEMORY_STAT_BY(STAT_UnLua_DefaultParam_Memory, AllocatedSize);
+
+    return GDefaultParamCollection.Add(Key, MoveTemp(Collection)).Get();
 }
 
-#if UE_VERSION_OLDER_THAN(5, 2, 0)
-PRAGMA_ENABLE_OPTIMIZATION
-#else
-UE_ENABLE_OPTIMIZATION
-#endif
+void CreateDefaultParamCollection()
+{
+    // nothing is built at startup any more, the classes are built when they are first registered
+    UE_LOG(LogUnLua, Log, TEXT("Default parameter table: %d classes, %d functions, %d parameters in %d bytes"),
+           NumDefaultParamClasses, NumDefaultParamFunctions, NumDefaultParamSlots,
+           (int32)(sizeof(GDefaultParamClasses) + sizeof(GDefaultParamFunctions) + sizeof(GDefaultParamSlots)));
+}
@@ -17,90 +17,91 @@
 #include "CoreMinimal.h"
 #include "UnLuaCompatibility.h"
 
-class IParamValue
+/** How the literal of a default parameter slot is turned into a value */
+enum class EDefaultParamType : uint8
 {
-public:
-    virtual ~IParamValue()
-    {
-    }
-
-    virtual const void* GetValue() = 0;
+    Bool,
+    Byte,
+    Int,
+    Enum,
+    RuntimeEnum, // String is the cpp type of the enum, Numbers[0] the index of the value
+    Float,
+    Double,
+    Name,
+    Text,
+    InvariantText,
+    String,
+    Vector,
+    Vector2D,
+    Rotator,
+    LinearColor,
+    Color,
+    ScriptArray,
+    ScriptDelegate,
+    MulticastScriptDelegate,
 };
 
-template <typename T>
-class TParamValue : public IParamValue
+/** A default parameter as generated, literals only so the whole table is constant data */
+struct FDefaultParamSlot
 {
-public:
-    explicit TParamValue(const T& InValue)
-        : Value(InValue)
-    {
-    }
-
-    virtual const void* GetValue() override { return &Value; }
-
-private:
-    T Value;
+    int32 Index; // position among the parameters of the function, the return value excluded
+    const TCHAR* Name;
+    EDefaultParamType Type;
+    double Numbers[4]; // the number, or the components of a math struct
+    const TCHAR* String; // names, strings and texts
 };
 
-class FRuntimeEnumParamValue : public IParamValue
+/** Default parameters of a function, a range of slots */
+struct FDefaultParamFunctionEntry
 {
-public:
-    explicit FRuntimeEnumParamValue(const FString& InCppType, int32 InIndex)
-        : bInitialized(false), TypeName(InCppType), Index(InIndex)
-    {
-    }
-
-    virtual const void* GetValue() override
-    {
-        if (!bInitialized)
-        {
-            UEnum* Enum = FindFirstObject<UEnum>(*TypeName);
-            Value = Enum->GetValueByIndex(Index);
-            bInitialized = true;
-        }
-        return &Value;
-    }
-
-private:
-    bool bInitialized;
-    FString TypeName;
-    int32 Index;
-    int64 Value;
+    const TCHAR* Name;
+    int32 FirstSlot;
+    int32 NumSlots;
 };
 
-class FScriptArrayParamValue : public IParamValue
+/** Functions of a class that have default parameters, a range of function entries sorted by name */
+struct FDefaultParamClassEntry
 {
-public:
-    explicit FScriptArrayParamValue()
-    {
-    }
-
-    virtual const void* GetValue() override { return &Value; }
+    const TCHAR* Name;
+    int32 FirstFunction;
+    int32 NumFunctions;
+};
 
-private:
-    FScriptArray Value;
+/** A default value built from its slot, stored inline so building a class allocates once per function */
+union FDefaultParamValue
+{
+    FDefaultParamValue() {}
+    ~FDefaultParamValue() {}
+
+    bool Bool;
+    uint8 Byte;
+    int32 Int;
+    int64 Enum;
+    float Float;
+    double Double;
+    FName Name;
+    FText Text;
+    FString String;
+    FVector Vector;
+    FVector2D Vector2D;
+    FRotator Rotator;
+    FLinearColor LinearColor;
+    FColor Color;
+    FScriptArray ScriptArray;
+    FScriptDelegate ScriptDelegate;
+    FMulticastScriptDelegate MulticastScriptDelegate;
 };
 
-typedef TParamValue<bool> FBoolParamValue;
-typedef TParamValue<uint8> FByteParamValue;
-typedef TParamValue<int32> FIntParamValue;
-typedef TParamValue<int64> FEnumParamValue;
-typedef TParamValue<float> FFloatParamValue;
-typedef TParamValue<double> FDoubleParamValue;
-typedef TParamValue<FName> FNameParamValue;
-typedef TParamValue<FText> FTextParamValue;
-typedef TParamValue<FString> FStringParamValue;
-typedef TParamValue<FVector> FVectorParamValue;
-typedef TParamValue<FVector2D> FVector2DParamValue;
-typedef TParamValue<FRotator> FRotatorParamValue;
-typedef TParamValue<FLinearColor> FLinearColorParamValue;
-typedef TParamValue<FColor> FColorParamValue;
-typedef TParamValue<FScriptDelegate> FScriptDelegateParamValue;
-typedef TParamValue<FMulticastScriptDelegate> FMulticastScriptDelegateParamValue;
+struct FDefaultParameter
+{
+    int32 Index; // position among the parameters of the function, the return value excluded
+    FName Name;
+    FDefaultParamValue Value; // never destroyed, built values live as long as the module
+};
 
 struct FParameterCollection
 {
-    TMap<FName, IParamValue*> Parameters;
+    TArray<FDefaultParameter> Parameters;
 };
 
 struct FFunctionCollection
@@ -108,6 +109,10 @@ struct FFunctionCollection
     TMap<FName, FParameterCollection> Functions;
 };
 
-extern TMap<FName, FFunctionCollection> GDefaultParamCollection;
+/**
+ * Find the default parameters of a class, building its values from the generated table on first use.
+ * @return nullptr if no function of the class has default parameters
+ */
+extern FFunctionCollection* FindDefaultParamCollection(const TCHAR* ClassName);
 
 extern void CreateDefaultParamCollection();
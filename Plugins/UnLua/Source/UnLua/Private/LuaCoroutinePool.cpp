@@ -0,0 +1,129 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "LuaCoroutinePool.h"
+#include "LuaEnv.h"
+#include "UnLuaPrivate.h"
+
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Coroutine Pool Hits", UnLua_CoroutinePoolHits);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Coroutine Pool Misses", UnLua_CoroutinePoolMisses);
+
+namespace UnLua
+{
+    static const char* TRAMPOLINE_CHUNK = R"(
+local Release = ...
+return function(Function, ...)
+    Function(...)
+    return Release()
+end
+)";
+
+    FCoroutinePool::FCoroutinePool(FLuaEnv* Env, const int32 MaxSize)
+        : MaxSize(MaxSize)
+    {
+        const auto L = Env->GetMainState();
+        lua_createtable(L, MaxSize, 0);
+        PoolRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        luaL_loadbuffer(L, TRAMPOLINE_CHUNK, FCStringAnsi::Strlen(TRAMPOLINE_CHUNK), "Spawn");
+        lua_pushlightuserdata(L, this);
+        lua_pushcclosure(L, Release, 1);
+        lua_call(L, 1, 1);
+        TrampolineRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+
+    int FCoroutinePool::Spawn(lua_State* L)
+    {
+        luaL_checktype(L, 1, LUA_TFUNCTION);
+        const int32 NumArgs = lua_gettop(L);
+        lua_State* Thread = Acquire(L);
+        if (!lua_checkstack(Thread, NumArgs + 1))
+            return luaL_error(L, "too many arguments to spawn");
+
+        lua_rawgeti(Thread, LUA_REGISTRYINDEX, TrampolineRef);
+        for (int32 i = 1; i <= NumArgs; i++)
+            lua_pushvalue(L, i);
+        lua_xmove(L, Thread, NumArgs);
+
+#if 504 == LUA_VERSION_NUM
+        int NumResults = 0;
+        const int32 Status = lua_resume(Thread, L, NumArgs, &NumResults);
+#else
+        const int32 Status = lua_resume(Thread, L, NumArgs);
+#endif
+        if (Status == LUA_YIELD)
+            return 1;
+
+        if (Status != LUA_OK)
+        {
+            const auto ErrMsg = lua_tostring(Thread, -1);
+            UE_LOG(LogUnLua, Error, TEXT("%s"), UTF8_TO_TCHAR(ErrMsg));
+#if 504 == LUA_VERSION_NUM
+            lua_resetthread(Thread);
+            Recycle(Thread);
+#endif
+        }
+        // finished, the thread is back in the pool already
+        return 0;
+    }
+
+    lua_State* FCoroutinePool::Acquire(lua_State* L)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, PoolRef);
+        while (NumFree > 0)
+        {
+            lua_rawgeti(L, -1, NumFree);
+            lua_pushnil(L);
+            lua_rawseti(L, -3, NumFree);
+            NumFree--;
+
+            // released threads are dead by now, unless a finalizer spawned right between Release and the return
+            lua_State* Thread = lua_tothread(L, -1);
+            lua_Debug Ar;
+            if (lua_status(Thread) == LUA_OK && lua_getstack(Thread, 0, &Ar) == 0)
+            {
+                lua_remove(L, -2);
+                lua_settop(Thread, 0);
+                FLuaEnv::ClearThreadRef(Thread);
+                NumHits++;
+                UNLUA_INC_DWORD_STAT(UnLua_CoroutinePoolHits);
+                return Thread;
+            }
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+
+        NumMisses++;
+        UNLUA_INC_DWORD_STAT(UnLua_CoroutinePoolMisses);
+        return lua_newthread(L);
+    }
+
+    void FCoroutinePool::Recycle(lua_State* Thread)
+    {
+        if (NumFree >= MaxSize)
+            return;
+
+        lua_rawgeti(Thread, LUA_REGISTRYINDEX, PoolRef);
+        lua_pushthread(Thread);
+        lua_rawseti(Thread, -2, ++NumFree);
+        lua_pop(Thread, 1);
+    }
+
+    int FCoroutinePool::Release(lua_State* L)
+    {
+        const auto Pool = (FCoroutinePool*)lua_touserdata(L, lua_upvalueindex(1));
+        Pool->Recycle(L);
+        return 0;
+    }
+}
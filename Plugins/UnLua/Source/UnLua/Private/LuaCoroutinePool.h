@@ -0,0 +1,60 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "lua.hpp"
+
+namespace UnLua
+{
+    class FLuaEnv;
+
+    /**
+     * Lua threads reused by UnLua.Spawn.
+     *
+     * A spawned function runs in a thread taken from the pool, and the thread goes back to the pool when the function returns,
+     * whoever resumed it last. Threads that stopped on an error are reset first when Spawn itself resumed them, otherwise left to the GC.
+     * Free threads are kept in one lua array, no registry reference is taken per coroutine.
+     */
+    class FCoroutinePool
+    {
+    public:
+        FCoroutinePool(FLuaEnv* Env, int32 MaxSize);
+
+        /** UnLua.Spawn(Function, ...), runs Function(...) in a pooled coroutine and returns the coroutine if it is suspended */
+        int Spawn(lua_State* L);
+
+        FORCEINLINE int32 GetNumFree() const { return NumFree; }
+
+        FORCEINLINE int64 GetNumHits() const { return NumHits; }
+
+        FORCEINLINE int64 GetNumMisses() const { return NumMisses; }
+
+    private:
+        /** Pushes a thread ready to start onto L */
+        lua_State* Acquire(lua_State* L);
+
+        void Recycle(lua_State* Thread);
+
+        static int Release(lua_State* L);
+
+        int32 MaxSize;
+        int32 PoolRef;
+        int32 TrampolineRef;
+        int32 NumFree = 0;
+        int64 NumHits = 0;
+        int64 NumMisses = 0;
+    };
+}
@@ -0,0 +1,300 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "LuaCoroutineScheduler.h"
+#include "LuaEnv.h"
+#include "UnLuaPrivate.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Waiting Coroutines"), STAT_UnLua_WaitingCoroutines, STATGROUP_UnLua);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Resumed Coroutines", UnLua_ResumedCoroutines);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Cancelled Coroutines", UnLua_CancelledCoroutines);
+
+namespace UnLua
+{
+    void FCoroutineScheduler::FTimerWheel::Add(const FWheelEntry& Entry)
+    {
+        uint64 Slot = FMath::Max(Entry.Expire, Now + 1);
+        const uint64 Delta = Slot - Now;
+        int32 Level = 0;
+        while (Level < NumLevels - 1 && Delta >= 1ull << (SlotBits * (Level + 1)))
+            Level++;
+
+        // beyond the last level, park it in the furthest slot and place it again from there
+        const uint64 Range = 1ull << (SlotBits * NumLevels);
+        if (Delta >= Range)
+            Slot = Now + Range - 1;
+
+        Slots[Level][(Slot >> (SlotBits * Level)) & (NumSlots - 1)].Add(Entry);
+    }
+
+    void FCoroutineScheduler::FTimerWheel::Advance(const uint64 To, TArray<FWheelEntry>& OutExpired)
+    {
+        while (Now < To)
+        {
+            Now++;
+            for (int32 Level = 1; Level < NumLevels; Level++)
+            {
+                if ((Now & ((1ull << (SlotBits * Level)) - 1)) != 0)
+                    break;
+
+                // entries due right now would otherwise be placed again one tick late
+                TArray<FWheelEntry> Entries = MoveTemp(Slots[Level][(Now >> (SlotBits * Level)) & (NumSlots - 1)]);
+                for (const auto& Entry : Entries)
+                {
+                    if (Entry.Expire <= Now)
+                        OutExpired.Add(Entry);
+                    else
+                        Add(Entry);
+                }
+            }
+
+            auto& Slot = Slots[0][Now & (NumSlots - 1)];
+            if (Slot.Num() > 0)
+            {
+                OutExpired.Append(Slot);
+                Slot.Reset();
+            }
+        }
+    }
+
+    FCoroutineScheduler::FCoroutineScheduler(FLuaEnv* Env)
+        : Env(Env)
+    {
+#if ENGINE_MAJOR_VERSION >= 5
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCoroutineScheduler::OnTicker));
+#else
+        TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCoroutineScheduler::OnTicker));
+#endif
+    }
+
+    FCoroutineScheduler::~FCoroutineScheduler()
+    {
+        // the lua state is already closed, along with the threads it referenced
+#if ENGINE_MAJOR_VERSION >= 5
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+        FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+    }
+
+    int FCoroutineScheduler::Sleep(lua_State* L, const double Seconds, UObject* Owner)
+    {
+        const int32 Index = AddWaiter(L, Owner);
+        const uint64 Expire = (uint64)FMath::CeilToDouble((Time + FMath::Max(Seconds, 0.0)) * 1000);
+        TimeWheel.Add({Expire, Index, Waiters[Index].Serial});
+        return lua_yield(L, 0);
+    }
+
+    int FCoroutineScheduler::WaitFrames(lua_State* L, const int32 NumFrames, UObject* Owner)
+    {
+        const int32 Index = AddWaiter(L, Owner);
+        FrameWheel.Add({FrameWheel.Now + FMath::Max(NumFrames, 1), Index, Waiters[Index].Serial});
+        return lua_yield(L, 0);
+    }
+
+    int FCoroutineScheduler::WaitEvent(lua_State* L, const FName Event, UObject* Owner)
+    {
+        const int32 Index = AddWaiter(L, Owner);
+        Waiters[Index].Event = Event;
+        auto& Entries = EventWaiters.FindOrAdd(Event);
+        if (Entries.Num() >= 16 && FMath::IsPowerOfTwo(Entries.Num()))
+            Entries.RemoveAllSwap([this](const FWheelEntry& Entry) { return !IsCurrent(Entry); });
+        Entries.Add({0, Index, Waiters[Index].Serial});
+        return lua_yield(L, 0);
+    }
+
+    int32 FCoroutineScheduler::Signal(lua_State* L, const FName Event, const int32 FirstArg)
+    {
+        TArray<FWheelEntry> Entries;
+        if (!EventWaiters.RemoveAndCopyValue(Event, Entries))
+            return 0;
+
+        const int32 NumArgs = FMath::Max(lua_gettop(L) - FirstArg + 1, 0);
+        lua_createtable(L, NumArgs, 1);
+        for (int32 i = 0; i < NumArgs; i++)
+        {
+            lua_pushvalue(L, FirstArg + i);
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_pushinteger(L, NumArgs);
+        lua_setfield(L, -2, "n");
+        const int32 ArgsRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        SignalArgRefs.Add(ArgsRef);
+
+        int32 NumSignalled = 0;
+        for (const auto& Entry : Entries)
+        {
+            if (!IsCurrent(Entry))
+                continue;
+            auto& Waiter = Waiters[Entry.Waiter];
+            Waiter.Event = NAME_None;
+            Waiter.ArgsRef = ArgsRef;
+            Signalled.Add(Entry);
+            NumSignalled++;
+        }
+        return NumSignalled;
+    }
+
+    bool FCoroutineScheduler::Cancel(lua_State* Thread)
+    {
+        const int32* Index = WaiterOfThread.Find(Thread);
+        if (!Index)
+            return false;
+        FreeWaiter(*Index);
+        UNLUA_INC_DWORD_STAT(UnLua_CancelledCoroutines);
+        return true;
+    }
+
+    void FCoroutineScheduler::Tick(const float DeltaSeconds)
+    {
+        Time += DeltaSeconds;
+        Batch.Reset();
+        TimeWheel.Advance((uint64)(Time * 1000), Batch);
+        FrameWheel.Advance(FrameWheel.Now + 1, Batch);
+        Batch.Append(Signalled);
+        Signalled.Reset();
+
+        // resumed coroutines may wait again, signal or even tick, none of which touches the batch being resumed
+        TArray<FWheelEntry> Due = MoveTemp(Batch);
+        TArray<int32> ArgRefs = MoveTemp(SignalArgRefs);
+        for (const auto& Entry : Due)
+            Resume(Entry);
+        Batch = MoveTemp(Due);
+
+        const auto L = Env->GetMainState();
+        for (const int32 ArgsRef : ArgRefs)
+            luaL_unref(L, LUA_REGISTRYINDEX, ArgsRef);
+
+        SET_DWORD_STAT(STAT_UnLua_WaitingCoroutines, WaiterOfThread.Num());
+    }
+
+    void FCoroutineScheduler::NotifyUObjectDeleted(const UObject* Object)
+    {
+        TArray<int32> Indexes;
+        OwnedWaiters.MultiFind(Object, Indexes);
+        for (const int32 Index : Indexes)
+        {
+            FreeWaiter(Index);
+            UNLUA_INC_DWORD_STAT(UnLua_CancelledCoroutines);
+        }
+    }
+
+    int32 FCoroutineScheduler::AddWaiter(lua_State* L, UObject* Owner)
+    {
+        if (!lua_isyieldable(L))
+            luaL_error(L, "can only wait in a coroutine");
+        if (WaiterOfThread.Contains(L))
+            luaL_error(L, "coroutine is already waiting");
+
+        int32 Index;
+        if (FreeWaiters.Num() > 0)
+            Index = FreeWaiters.Pop(false);
+        else
+            Index = Waiters.AddDefaulted();
+
+        auto& Waiter = Waiters[Index];
+        Waiter.Thread = L;
+        lua_pushthread(L);
+        Waiter.ThreadRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        WaiterOfThread.Add(L, Index);
+        if (Owner)
+        {
+            Waiter.Owner = Owner;
+            Waiter.OwnerKey = Owner;
+            OwnedWaiters.Add(Owner, Index);
+            Env->MarkObjectTracked(Owner);
+        }
+        return Index;
+    }
+
+    void FCoroutineScheduler::FreeWaiter(const int32 Index)
+    {
+        auto& Waiter = Waiters[Index];
+        luaL_unref(Env->GetMainState(), LUA_REGISTRYINDEX, Waiter.ThreadRef);
+        WaiterOfThread.Remove(Waiter.Thread);
+        if (Waiter.OwnerKey)
+            OwnedWaiters.RemoveSingle(Waiter.OwnerKey, Index);
+
+        // event waits are left in their list and skipped as stale, like the wheel entries
+        const uint32 Serial = Waiter.Serial + 1;
+        Waiter = FWaiter();
+        Waiter.Serial = Serial;
+        FreeWaiters.Add(Index);
+    }
+
+    bool FCoroutineScheduler::IsCurrent(const FWheelEntry& Entry) const
+    {
+        return Waiters[Entry.Waiter].Serial == Entry.Serial;
+    }
+
+    void FCoroutineScheduler::Resume(const FWheelEntry& Entry)
+    {
+        if (!IsCurrent(Entry))
+            return;
+
+        auto& Waiter = Waiters[Entry.Waiter];
+        lua_State* Thread = Waiter.Thread;
+        const int32 ThreadRef = Waiter.ThreadRef;
+        const int32 ArgsRef = Waiter.ArgsRef;
+        const bool bOwnerGone = Waiter.OwnerKey && !Waiter.Owner.IsValid();
+        Waiter.ThreadRef = LUA_NOREF; // kept alive by ThreadRef until it has run
+        FreeWaiter(Entry.Waiter);
+
+        const auto L = Env->GetMainState();
+        if (bOwnerGone || lua_status(Thread) != LUA_YIELD)
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, ThreadRef);
+            UNLUA_INC_DWORD_STAT(UnLua_CancelledCoroutines);
+            return;
+        }
+
+        int32 NumArgs = 1;
+        if (ArgsRef == LUA_NOREF)
+        {
+            lua_pushboolean(Thread, true);
+        }
+        else
+        {
+            lua_rawgeti(Thread, LUA_REGISTRYINDEX, ArgsRef);
+            lua_getfield(Thread, -1, "n");
+            NumArgs = (int32)lua_tointeger(Thread, -1);
+            lua_pop(Thread, 1);
+            if (!lua_checkstack(Thread, NumArgs))
+                NumArgs = 0;
+            for (int32 i = 1; i <= NumArgs; i++)
+                lua_rawgeti(Thread, -i, i);
+            lua_remove(Thread, -NumArgs - 1);
+        }
+
+        UNLUA_INC_DWORD_STAT(UnLua_ResumedCoroutines);
+#if 504 == LUA_VERSION_NUM
+        int NumResults = 0;
+        const int32 Status = lua_resume(Thread, L, NumArgs, &NumResults);
+#else
+        const int32 Status = lua_resume(Thread, L, NumArgs);
+#endif
+        if (Status != LUA_OK && Status != LUA_YIELD)
+        {
+            const auto ErrMsg = lua_tostring(Thread, -1);
+            UE_LOG(LogUnLua, Error, TEXT("%s"), UTF8_TO_TCHAR(ErrMsg));
+        }
+        luaL_unref(L, LUA_REGISTRYINDEX, ThreadRef);
+    }
+
+    bool FCoroutineScheduler::OnTicker(const float DeltaSeconds)
+    {
+        Tick(DeltaSeconds);
+        return true;
+    }
+}
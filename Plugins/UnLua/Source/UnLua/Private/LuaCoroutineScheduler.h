@@ -0,0 +1,126 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "UObject/WeakObjectPtr.h"
+#include "lua.hpp"
+
+namespace UnLua
+{
+    class FLuaEnv;
+
+    /**
+     * Coroutine waits that never go through the engine's latent actions.
+     *
+     * UnLua.Sleep/WaitFrames/WaitEvent suspend the calling coroutine, the scheduler resumes everything due once per frame.
+     * Sleeps and frame waits live in hierarchical timer wheels, so adding and expiring a wait costs the same for 10 or 100k of them.
+     * A wait with an owner is cancelled when the owner is destroyed, the coroutine is dropped without being resumed.
+     * Time advances by the engine frame delta, it does not stop for a paused world.
+     */
+    class FCoroutineScheduler
+    {
+    public:
+        explicit FCoroutineScheduler(FLuaEnv* Env);
+
+        ~FCoroutineScheduler();
+
+        /** Suspend the calling coroutine for Seconds, it is resumed with true */
+        int Sleep(lua_State* L, double Seconds, UObject* Owner);
+
+        /** Suspend the calling coroutine for NumFrames ticks, it is resumed with true */
+        int WaitFrames(lua_State* L, int32 NumFrames, UObject* Owner);
+
+        /** Suspend the calling coroutine until Event is signalled, it is resumed with the values passed to Signal */
+        int WaitEvent(lua_State* L, FName Event, UObject* Owner);
+
+        /** Wake up every coroutine waiting for Event with the values from FirstArg to the top of the stack, they are resumed in the next tick */
+        int32 Signal(lua_State* L, FName Event, int32 FirstArg);
+
+        /** Drop the wait of a suspended coroutine, it stays suspended and is never resumed by the scheduler */
+        bool Cancel(lua_State* Thread);
+
+        /** Advance time and resume everything due, the core ticker calls it every frame */
+        void Tick(float DeltaSeconds);
+
+        void NotifyUObjectDeleted(const UObject* Object);
+
+        FORCEINLINE int32 GetNumWaiting() const { return WaiterOfThread.Num(); }
+
+    private:
+        struct FWheelEntry
+        {
+            uint64 Expire;
+            int32 Waiter;
+            uint32 Serial;
+        };
+
+        /** 4 levels of 64 slots, a level's slot is spread over the level below when time reaches it */
+        struct FTimerWheel
+        {
+            static constexpr int32 SlotBits = 6;
+            static constexpr int32 NumSlots = 1 << SlotBits;
+            static constexpr int32 NumLevels = 4;
+
+            uint64 Now = 0;
+            TArray<FWheelEntry> Slots[NumLevels][NumSlots];
+
+            void Add(const FWheelEntry& Entry);
+
+            void Advance(uint64 To, TArray<FWheelEntry>& OutExpired);
+        };
+
+        struct FWaiter
+        {
+            lua_State* Thread = nullptr;
+            int32 ThreadRef = LUA_NOREF;
+            int32 ArgsRef = LUA_NOREF; // values from Signal, shared by all the waiters it woke up
+            TWeakObjectPtr<UObject> Owner;
+            const UObject* OwnerKey = nullptr;
+            FName Event;
+            uint32 Serial = 0; // changes every time the waiter is freed, entries still pointing at it are stale
+        };
+
+        int32 AddWaiter(lua_State* L, UObject* Owner);
+
+        void FreeWaiter(int32 Index);
+
+        bool IsCurrent(const FWheelEntry& Entry) const;
+
+        void Resume(const FWheelEntry& Entry);
+
+        bool OnTicker(float DeltaSeconds);
+
+        FLuaEnv* Env;
+        TArray<FWaiter> Waiters;
+        TArray<int32> FreeWaiters;
+        TMap<lua_State*, int32> WaiterOfThread;
+        TMultiMap<const UObject*, int32> OwnedWaiters;
+        TMap<FName, TArray<FWheelEntry>> EventWaiters;
+        TArray<FWheelEntry> Signalled; // resumed in the next tick
+        TArray<int32> SignalArgRefs; // released once the signalled waiters are resumed
+        TArray<FWheelEntry> Batch;
+        FTimerWheel TimeWheel; // in milliseconds
+        FTimerWheel FrameWheel;
+        double Time = 0;
+#if ENGINE_MAJOR_VERSION >= 5
+        FTSTicker::FDelegateHandle TickerHandle;
+#else
+        FDelegateHandle TickerHandle;
+#endif
+    };
+}
@@ -202,9 +202,13 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
 // See the License for the specific language governing permissions and limitations under the License.
 
+#include "Async/Async.h"
 #include "Engine/World.h"
 #include "Components/InputComponent.h"
 #include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "UObject/UObjectIterator.h"
 #include "LuaEnv.h"
 #include "Binding.h"
 #include "LowLevel.h"
@@ -212,6 +216,8 @@
 #include "Registries/ClassRegistry.h"
 #include "LuaCore.h"
 #include "LuaDynamicBinding.h"
+#include "LuaScriptArchive.h"
+#include "LuaSharedData.h"
 #include "UELib.h"
 #include "ObjectReferencer.h"
 #include "UnLuaDelegates.h"
@@ -219,8 +225,17 @@
 #include "UnLuaLegacy.h"
 #include "UnLuaLib.h"
 #include "UnLuaSettings.h"
+#include "UnLuaPrivate.h"
 #include "lstate.h"
 
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Objects Filtered", UnLua_ObjectsFiltered);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Objects Bound", UnLua_ObjectsBound);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Bind Decision Cache Misses", UnLua_BindDecisionMisses);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Deletions Filtered", UnLua_DeletionsFiltered);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Preloaded Modules Loaded", UnLua_PreloadHits);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("File System Requires", UnLua_FileSystemRequires);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("File System Probes", UnLua_FileSystemProbes);
+
 namespace UnLua
 {
     constexpr EInternalObjectFlags AsyncObjectFlags = EInternalObjectFlags::AsyncLoading | EInternalObjectFlags::Async;
@@ -282,12 +297,20 @@ namespace UnLua
 #endif
 
         AllEnvs.Add(L, this);
+        ClearThreadRef(L); // copied into every new thread
 
         luaL_openlibs(L);
 
         AddSearcher(LoadFromCustomLoader, 2);
         AddSearcher(LoadFromFileSystem, 3);
         AddSearcher(LoadFromBuiltinLibs, 4);
+        AddSearcher(FLuaSharedData::Searcher, 2);
+
+        for (const auto& ArchivePath : Settings->ScriptArchives)
+        {
+            if (const auto Archive = FLuaScriptArchive::Mount(FPaths::ProjectDir() / ArchivePath))
+                AddArchive(Archive);
+        }
 
         UELib::Open(L);
 
@@ -301,6 +324,11 @@ namespace UnLua
         PropertyRegistry = new FPropertyRegistry(this);
         EnumRegistry = new FEnumRegistry(this);
         EnumRegistry->Initialize();
+        TickRegistry = new FTickRegistry(this);
+        DataTableRegistry = new FDataTableRegistry(this);
+        CoroutineScheduler = new FCoroutineScheduler(this);
+        CoroutinePool = new FCoroutinePool(this, Settings->CoroutinePoolSize);
+        PropertyWatcher = new FPropertyWatcher(this);
 
         DanglingCheck = new FDanglingCheck(this);
         DeadLoopCheck = new FDeadLoopCheck(this);
@@ -374,6 +402,11 @@ namespace UnLua
         delete ContainerRegistry;
         delete EnumRegistry;
         delete PropertyRegistry;
+        delete TickRegistry;
+        delete DataTableRegistry;
+        delete CoroutineScheduler;
+        delete CoroutinePool;
+        delete PropertyWatcher;
         delete DanglingCheck;
         delete DeadLoopCheck;
 
@@ -422,6 +455,22 @@ namespace UnLua
         if (bStarted)
             return;
 
+        const auto& Settings = *GetDefault<UUnLuaSettings>();
+        TArray<FString> ModulesToPreload = Settings.PreloadModules;
+        if (Settings.bPreloadBoundModules && ModuleLocator)
+        {
+            static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
+            for (const auto Class : TObjectRange<UClass>())
+            {
+                if (!Class->ImplementsInterface(InterfaceClass) || Class->GetName().Contains(TEXT("SKEL_")))
+                    continue;
+                const auto ModuleName = ModuleLocator->Locate(Class);
+                if (!ModuleName.IsEmpty())
+                    ModulesToPreload.AddUnique(ModuleName);
+            }
+        }
+        PreloadModules(ModulesToPreload);
+
         if (StartupModuleName.IsEmpty())
         {
             bStarted = true;
@@ -454,14 +503,29 @@ namespace UnLua
 
     void FLuaEnv::NotifyUObjectDeleted(const UObjectBase* ObjectBase, int32 Index)
     {
+        const int32 Word = Index >> 5;
+        const uint32 Bit = 1u << (Index & 31);
+        if (Word >= TrackedObjects.Num() || !(TrackedObjects[Word] & Bit))
+        {
+            UNLUA_INC_DWORD_STAT(UnLua_DeletionsFiltered);
+            return;
+        }
+        TrackedObjects[Word] &= ~Bit;
+
         UObject* Object = (UObject*)ObjectBase;
         PropertyRegistry->NotifyUObjectDeleted(Object);
+        ContainerRegistry->NotifyUObjectDeleted(Object);
         FunctionRegistry->NotifyUObjectDeleted(Object);
         if (Manager)
             Manager->NotifyUObjectDeleted(Object);
         ObjectRegistry->NotifyUObjectDeleted(Object);
         ClassRegistry->NotifyUObjectDeleted(Object);
         EnumRegistry->NotifyUObjectDeleted(Object);
+        DataTableRegistry->NotifyUObjectDeleted(Object);
+        CoroutineScheduler->NotifyUObjectDeleted(Object);
+        PropertyWatcher->NotifyUObjectDeleted(Object);
+
+        BindDecisions.Remove((UClass*)Object);
 
         if (CandidateInputComponents.Num() <= 0)
             return;
@@ -479,8 +543,11 @@ namespace UnLua
 
     bool FLuaEnv::TryReplaceInputs(UObject* Object)
     {
-        if (Object->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject)
-            || !Object->IsA<UInputComponent>())
+        if (Object->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+            return false;
+
+        const FClassBindDecision* Decision = IsInGameThread() ? BindDecisions.Find(Object->GetClass()) : nullptr;
+        if (Decision ? !Decision->bInputComponent : !Object->IsA<UInputComponent>())
             return false;
 
         AActor* Actor = Cast<APlayerController>(Object->GetOuter());
@@ -491,12 +558,47 @@ namespace UnLua
             return false;
 
         CandidateInputComponents.AddUnique((UInputComponent*)Object);
+        MarkObjectTracked(Object);
         if (OnWorldTickStartHandle.IsValid())
             FWorldDelegates::OnWorldTickStart.Remove(OnWorldTickStartHandle);
         OnWorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddRaw(this, &FLuaEnv::OnWorldTickStart);
         return true;
     }
 
+    static void CallInstanceFunction(lua_State* L, UObject* Object, const char* FunctionName, int32 InitializerTableRef)
+    {
+        const int32 FunctionRef = PushFunction(L, Object, FunctionName);
+        if (FunctionRef == LUA_NOREF)
+            return;
+
+        if (InitializerTableRef != LUA_NOREF)
+            lua_rawgeti(L, LUA_REGISTRYINDEX, InitializerTableRef);
+        else
+            lua_pushnil(L);
+        if (!CallFunction(L, 2, 0))
+            UE_LOG(LogUnLua, Warning, TEXT("Failed to call '%s' function!"), UTF8_TO_TCHAR(FunctionName));
+        luaL_unref(L, LUA_REGISTRYINDEX, FunctionRef);
+    }
+
+    bool FLuaEnv::RecycleObject(UObject* Object)
+    {
+        if (!ObjectRegistry->IsBound(Object))
+            return false;
+
+        CallInstanceFunction(L, Object, "OnRecycle", LUA_NOREF);
+        return ObjectRegistry->ResetInstance(Object);
+    }
+
+    bool FLuaEnv::ReuseObject(UObject* Object, int32 InitializerTableRef)
+    {
+        if (!ObjectRegistry->IsBound(Object))
+            return false;
+
+        CallInstanceFunction(L, Object, "Initialize", InitializerTableRef);
+        CallInstanceFunction(L, Object, "OnReuse", InitializerTableRef);
+        return true;
+    }
+
     void FLuaEnv::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaTime)
     {
         if (!Manager)
@@ -532,50 +634,106 @@ namespace UnLua
             return false;
         }
 
-        static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
-        const bool bImplUnluaInterface = Class->ImplementsInterface(InterfaceClass);
-
         if (IsInAsyncLoadingThread())
         {
             // avoid adding too many objects, affecting performance.
-            if (bImplUnluaInterface || (!bImplUnluaInterface && GLuaDynamicBinding.IsValid(Class)))
+            static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
+            if (Class->ImplementsInterface(InterfaceClass) || GLuaDynamicBinding.IsValid(Class))
             {
                 // all bind operation should be in game thread, include dynamic bind
                 FScopeLock Lock(&CandidatesLock);
                 Candidates.AddUnique(Object);
-                return false;
             }
+            return false;
+        }
+
+        FClassBindDecision Uncached;
+        const FClassBindDecision* Decision = IsInGameThread() ? FindOrAddBindDecision(Class, Object) : nullptr;
+        if (!Decision)
+        {
+            MakeBindDecision(Class, Object, Uncached);
+            Decision = &Uncached;
         }
 
-        if (!bImplUnluaInterface)
+        bool bBound;
+        if (!Decision->bImplUnluaInterface)
         {
             // dynamic binding
-            if (!GLuaDynamicBinding.IsValid(Class))
-                return false;
+            bBound = GLuaDynamicBinding.IsValid(Class) && GetManager()->Bind(Object, *GLuaDynamicBinding.ModuleName, GLuaDynamicBinding.InitializerTableRef);
+        }
+        else if (Decision->ModuleName.IsEmpty())
+        {
+            bBound = false;
+        }
+        else
+        {
+#if !UE_BUILD_SHIPPING
+            if (GLuaDynamicBinding.IsValid(Class) && GLuaDynamicBinding.ModuleName != Decision->ModuleName)
+            {
+                UE_LOG(LogUnLua, Warning, TEXT("Dynamic binding '%s' ignored as it conflicts static binding '%s'."), *GLuaDynamicBinding.ModuleName, *Decision->ModuleName);
+            }
+#endif
+            bBound = GetManager()->Bind(Object, *Decision->ModuleName, GLuaDynamicBinding.InitializerTableRef);
+        }
 
-            return GetManager()->Bind(Object, *GLuaDynamicBinding.ModuleName, GLuaDynamicBinding.InitializerTableRef);
+        if (bBound)
+        {
+            UNLUA_INC_DWORD_STAT(UnLua_ObjectsBound);
         }
+        else
+        {
+            UNLUA_INC_DWORD_STAT(UnLua_ObjectsFiltered);
+        }
+        return bBound;
+    }
 
-        if (Class->GetName().Contains(TEXT("SKEL_")))
-            return false;
+    bool FLuaEnv::MakeBindDecision(UClass* Class, UObject* Object, FClassBindDecision& OutDecision) const
+    {
+        static UClass* InterfaceClass = UUnLuaInterface::StaticClass();
+        OutDecision.bImplUnluaInterface = Class->ImplementsInterface(InterfaceClass);
+        OutDecision.bInputComponent = Class->IsChildOf(UInputComponent::StaticClass());
+        OutDecision.ModuleName.Reset();
+
+        if (!OutDecision.bImplUnluaInterface || Class->GetName().Contains(TEXT("SKEL_")))
+            return true;
 
         if (!ensureMsgf(ModuleLocator, TEXT("Invalid lua module locator, lua binding will not work properly. please check unlua runtime settings.")))
-            return false;
+            return true;
 
-        const auto ModuleName = ModuleLocator->Locate(Object);
-        if (ModuleName.IsEmpty())
-            return false;
+        OutDecision.ModuleName = ModuleLocator->Locate(Object);
+        if (!OutDecision.ModuleName.IsEmpty())
+            return true;
 
-#if !UE_BUILD_SHIPPING
-        if (GLuaDynamicBinding.IsValid(Class) && GLuaDynamicBinding.ModuleName != ModuleName)
-        {
-            UE_LOG(LogUnLua, Warning, TEXT("Dynamic binding '%s' ignored as it conflicts static binding '%s'."), *GLuaDynamicBinding.ModuleName, *ModuleName);
-        }
-#endif
+        // the locator can't tell before the CDO is initialized, ask again next time
+        const UObject* CDO = Class->GetDefaultObject(false);
+        return CDO && !CDO->HasAnyFlags(RF_NeedInitialization);
+    }
+
+    const FLuaEnv::FClassBindDecision* FLuaEnv::FindOrAddBindDecision(UClass* Class, UObject* Object)
+    {
+        // the module depends on the instance, decide for every object
+        if (ModuleLocator && !ModuleLocator->IsClassBased())
+            return nullptr;
+
+        if (const FClassBindDecision* Decision = BindDecisions.Find(Class))
+            return Decision;
 
-        return GetManager()->Bind(Object, *ModuleName, GLuaDynamicBinding.InitializerTableRef);
+        UNLUA_INC_DWORD_STAT(UnLua_BindDecisionMisses);
+        FClassBindDecision Decision;
+        if (!MakeBindDecision(Class, Object, Decision))
+            return nullptr;
+        MarkObjectTracked(Class);
+        return &BindDecisions.Add(Class, MoveTemp(Decision));
     }
 
+#if WITH_EDITOR
+    void FLuaEnv::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacedObjects)
+    {
+        // blueprint recompile or hot reload, module names may have changed
+        BindDecisions.Empty();
+    }
+#endif
+
     bool FLuaEnv::DoString(const FString& Chunk, const FString& ChunkName)
     {
         const FTCHARToUTF8 ChunkUTF8(*Chunk);
@@ -637,27 +795,38 @@ namespace UnLua
 
     void FLuaEnv::HotReload()
     {
+        BindDecisions.Empty();
+        PreloadedChunks.Empty();
+        ResetModuleFileIndex();
         DoString("UnLua.HotReload()");
     }
 
     int32 FLuaEnv::FindThread(const lua_State* Thread)
     {
-        int32* ThreadRefPtr = ThreadToRef.Find(Thread);
-        return ThreadRefPtr ? *ThreadRefPtr : LUA_REFNIL;
+        // the reference lives in the thread's extra space, 0 when it has none
+        const int32 ThreadRef = *(int32*)lua_getextraspace(const_cast<lua_State*>(Thread));
+        return ThreadRef ? ThreadRef : LUA_REFNIL;
     }
 
     void FLuaEnv::ResumeThread(int32 ThreadRef)
     {
-        lua_State** ThreadPtr = RefToThread.Find(ThreadRef);
-        if (!ThreadPtr)
+        ResumeThread(ThreadRef, [](lua_State*) { return 0; });
+    }
+
+    void FLuaEnv::ResumeThread(int32 ThreadRef, TFunctionRef<int32(lua_State*)> PushArgs)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ThreadRef);
+        lua_State* Thread = lua_tothread(L, -1);
+        lua_pop(L, 1);
+        if (!Thread || FindThread(Thread) != ThreadRef)
             return;
 
-        lua_State* Thread = *ThreadPtr;
+        const int32 NArgs = PushArgs(Thread);
 #if 504 == LUA_VERSION_NUM
         int NResults = 0;
-        int32 Status = lua_resume(Thread, L, 0, &NResults);
+        int32 Status = lua_resume(Thread, L, NArgs, &NResults);
 #else
-        int32 Status = lua_resume(Thread, L, 0);
+        int32 Status = lua_resume(Thread, L, NArgs);
 #endif
         if (Status == LUA_YIELD)
             return;
@@ -668,8 +837,7 @@ namespace UnLua
             UE_LOG(LogUnLua, Error, TEXT("%s"), UTF8_TO_TCHAR(ErrMsg));
         }
 
-        ThreadToRef.Remove(Thread);
-        RefToThread.Remove(ThreadRef);
+        ClearThreadRef(Thread);
         luaL_unref(L, LUA_REGISTRYINDEX, ThreadRef); // remove the reference if the coroutine finishes its execution
     }
 
@@ -686,8 +854,7 @@ namespace UnLua
 
     void FLuaEnv::AddThread(lua_State* Thread, int32 ThreadRef)
     {
-        ThreadToRef.Add(Thread, ThreadRef);
-        RefToThread.Add(ThreadRef, Thread);
+        *(int32*)lua_getextraspace(Thread) = ThreadRef;
     }
 
     int32 FLuaEnv::FindOrAddThread(lua_State* Thread)
@@ -723,6 +890,12 @@ namespace UnLua
         BuiltinLoaders.Add(InName, Loader);
     }
 
+    void FLuaEnv::AddArchive(const TSharedPtr<FLuaScriptArchive, ESPMode::ThreadSafe>& Archive)
+    {
+        if (Archive.IsValid())
+            Archives.AddUnique(Archive);
+    }
+
     void FLuaEnv::AddManualObjectReference(UObject* Object)
     {
         ManualObjectReference.Add(Object);
@@ -760,11 +933,11 @@ namespace UnLua
 
                 return luaL_error(L, "file loading from custom loader error");
             }
-            return 0;
+            return Env.LoadFromArchives(L);
         }
 
         if (Env.CustomLoaders.Num() == 0)
-            return 0;
+            return Env.LoadFromArchives(L);
 
         const FString FileName(UTF8_TO_TCHAR(lua_tostring(L, 1)));
 
@@ -776,18 +949,38 @@ namespace UnLua
                 continue;
 
             if (Env.LoadString(L, Data, ChunkName))
-                break;
+                return 1;
 
             return luaL_error(L, "file loading from custom loader error");
         }
 
-        return 1;
+        return Env.LoadFromArchives(L);
+    }
+
+    int FLuaEnv::LoadFromArchives(lua_State* InL)
+    {
+        const char* ModuleName = lua_tostring(InL, 1);
+        TArray<uint8> Scratch;
+        for (int32 i = Archives.Num() - 1; i >= 0; i--)
+        {
+            const char* Data = nullptr;
+            int32 Size = 0;
+            if (!Archives[i]->GetData(ModuleName, Data, Size, Scratch))
+                continue;
+
+            // bytecode keeps the chunk name it was compiled with
+            if (LoadBuffer(InL, Data, Size, ModuleName))
+                return 1;
+
+            const auto Msg = FString::Printf(TEXT("file loading from script archive error.\narchive:%s"), *Archives[i]->GetFilePath());
+            return luaL_error(InL, TCHAR_TO_UTF8(*Msg));
+        }
+        return 0;
     }
 
     int FLuaEnv::LoadFromFileSystem(lua_State* L)
     {
-        FString FileName(UTF8_TO_TCHAR(lua_tostring(L, 1)));
-        FileName.ReplaceInline(TEXT("."), TEXT("/"));
+        const FString ModuleName(UTF8_TO_TCHAR(lua_tostring(L, 1)));
 
         auto& Env = *(FLuaEnv*)lua_touserdata(L, lua_upvalueindex(1));
         TArray<uint8> Data;
@@ -805,30 +998,207 @@ namespace UnLua
         if (PackagePath.IsEmpty())
             return 0;
 
+        UNLUA_INC_DWORD_STAT(UnLua_FileSystemRequires);
+
+        if (const auto Preloaded = Env.PreloadedChunks.Find(ModuleName))
+        {
+            auto Future = MoveTemp(*Preloaded);
+            Env.PreloadedChunks.Remove(ModuleName);
+            if (PackagePath == Env.PreloadedPackagePath)
+            {
+                // waits only if the worker is still on it, the future was taken out of the map so its result can be moved from
+                FPreloadedChunk& Chunk = const_cast<FPreloadedChunk&>(Future.Get());
+                if (!Chunk.FullPath.IsEmpty())
+                {
+                    FullPath = MoveTemp(Chunk.FullPath);
+                    Data = MoveTemp(Chunk.Data);
+                    UNLUA_INC_DWORD_STAT(UnLua_PreloadHits);
+                    return LoadIt();
+                }
+            }
+        }
+
+        if (!Env.LocateModuleFile(PackagePath, ModuleName, FullPath))
+            return 0;
+
+        if (FullPath.IsEmpty() ? FindModuleFile(PackagePath, ModuleName, Data, FullPath) : ReadModuleFile(FullPath, Data))
+            return LoadIt();
+
+        return 0;
+    }
+
+    bool FLuaEnv::ReadModuleFile(const FString& FullPath, TArray<uint8>& OutData)
+    {
+        UNLUA_INC_DWORD_STAT(UnLua_FileSystemProbes);
+        return FFileHelper::LoadFileToArray(OutData, *FullPath, FILEREAD_Silent);
+    }
+
+    bool FLuaEnv::LocateModuleFile(const FString& PackagePath, const FString& ModuleName, FString& OutFullPath)
+    {
+        OutFullPath.Reset();
+
+        if (!bModuleFileIndexBuilt || PackagePath != ModuleFileIndexPackagePath)
+        {
+            ModuleFileIndex.Reset();
+            ModuleFileIndexPackagePath = PackagePath;
+            bModuleFileIndexBuilt = true;
+            bModuleFileIndexUsable = false;
+
+            // every pattern needs a directory in front of a single '?', otherwise requires keep probing each pattern
+            TArray<FString> Patterns;
+            PackagePath.ParseIntoArray(Patterns, TEXT(";"), false);
+            bool bIndexable = Patterns.Num() > 0;
+            for (const auto& Pattern : Patterns)
+            {
+                const int32 Index = Pattern.Find(TEXT("?"));
+                if (Index <= 0 || Pattern[Index - 1] != TEXT('/') || Pattern.Find(TEXT("?"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index + 1) != INDEX_NONE)
+                {
+                    bIndexable = false;
+                    break;
+                }
+            }
+
+            if (bIndexable)
+            {
+                // same priority as FindModuleFile: the download directory first, then the project directory
+                for (const auto& BaseDir : {FPaths::ProjectPersistentDownloadDir(), FPaths::ProjectDir()})
+                {
+                    for (const auto& Pattern : Patterns)
+                    {
+                        const int32 Index = Pattern.Find(TEXT("?"));
+                        const FString Suffix = Pattern.Mid(Index + 1);
+                        FString Root = FPaths::ConvertRelativePathToFull(FPaths::Combine(BaseDir, Pattern.Left(Index)));
+                        FPaths::NormalizeDirectoryName(Root);
+
+                        TArray<FString> Files;
+                        IFileManager::Get().FindFilesRecursive(Files, *Root, *(TEXT("*") + FPaths::GetExtension(Suffix, true)), true, false);
+                        for (const auto& File : Files)
+                        {
+                            if (!File.EndsWith(Suffix))
+                                continue;
+                            const auto FileName = File.Mid(Root.Len() + 1).LeftChop(Suffix.Len());
+                            if (!ModuleFileIndex.Contains(FileName))
+                                ModuleFileIndex.Add(FileName, File);
+                        }
+                    }
+                }
+                bModuleFileIndexUsable = true;
+            }
+        }
+
+        if (!bModuleFileIndexUsable)
+            return true;
+
+        const auto FullPath = ModuleFileIndex.Find(ModuleName.Replace(TEXT("."), TEXT("/")));
+        if (!FullPath)
+            return false;
+        OutFullPath = *FullPath;
+        return true;
+    }
+
+    void FLuaEnv::ResetModuleFileIndex()
+    {
+        ModuleFileIndex.Empty();
+        bModuleFileIndexBuilt = false;
+    }
+
+    bool FLuaEnv::FindModuleFile(const FString& PackagePath, const FString& ModuleName, TArray<uint8>& OutData, FString& OutFullPath)
+    {
+        const FString FileName = ModuleName.Replace(TEXT("."), TEXT("/"));
+
         TArray<FString> Patterns;
         if (PackagePath.ParseIntoArray(Patterns, TEXT(";"), false) == 0)
-            return 0;
+            return false;
 
         // 优先加载下载目录下的单文件
         for (auto& Pattern : Patterns)
         {
             Pattern.ReplaceInline(TEXT("?"), *FileName);
             const auto PathWithPersistentDir = FPaths::Combine(FPaths::ProjectPersistentDownloadDir(), Pattern);
-            FullPath = FPaths::ConvertRelativePathToFull(PathWithPersistentDir);
-            if (FFileHelper::LoadFileToArray(Data, *FullPath, FILEREAD_Silent))
-                return LoadIt();
+            OutFullPath = FPaths::ConvertRelativePathToFull(PathWithPersistentDir);
+            if (ReadModuleFile(OutFullPath, OutData))
+                return true;
         }
 
         // 其次是打包目录下的文件
         for (auto& Pattern : Patterns)
         {
             const auto PathWithProjectDir = FPaths::Combine(FPaths::ProjectDir(), Pattern);
-            FullPath = FPaths::ConvertRelativePathToFull(PathWithProjectDir);
-            if (FFileHelper::LoadFileToArray(Data, *FullPath, FILEREAD_Silent))
-                return LoadIt();
+            OutFullPath = FPaths::ConvertRelativePathToFull(PathWithProjectDir);
+            if (ReadModuleFile(OutFullPath, OutData))
+                return true;
         }
 
-        return 0;
+        return false;
+    }
+
+    FLuaEnv::FPreloadedChunk FLuaEnv::PreloadChunk(const FString& PackagePath, const FString& ModuleName, const FString& FullPath)
+    {
+        FPreloadedChunk Chunk;
+        Chunk.FullPath = FullPath;
+        if (FullPath.IsEmpty() ? !FindModuleFile(PackagePath, ModuleName, Chunk.Data, Chunk.FullPath) : !ReadModuleFile(FullPath, Chunk.Data))
+        {
+            Chunk.FullPath.Reset();
+            return Chunk;
+        }
+
+        // files with a BOM or syntax errors stay as source, LoadBuffer reports them on the game thread as usual
+        const auto Source = (const char*)Chunk.Data.GetData();
+        const auto Size = Chunk.Data.Num();
+        if (Size > 3 && Source[0] == static_cast<char>(0xEF) && Source[1] == static_cast<char>(0xBB) && Source[2] == static_cast<char>(0xBF))
+            return Chunk;
+
+        lua_State* L = luaL_newstate();
+        if (luaL_loadbufferx(L, Source, Size, TCHAR_TO_UTF8(*Chunk.FullPath), "t") == LUA_OK)
+        {
+            TArray<uint8> Bytecode;
+            lua_dump(L, [](lua_State*, const void* Data, size_t Size, void* UserData)
+            {
+                ((TArray<uint8>*)UserData)->Append((const uint8*)Data, Size);
+                return 0;
+            }, &Bytecode, 0);
+            Chunk.Data = MoveTemp(Bytecode);
+        }
+        lua_close(L);
+        return Chunk;
+    }
+
+    void FLuaEnv::PreloadModules(const TArray<FString>& ModuleNames)
+    {
+        if (ModuleNames.Num() == 0)
+            return;
+
+        const auto PackagePath = UnLuaLib::GetPackagePath(L);
+        if (PackagePath != PreloadedPackagePath)
+        {
+            PreloadedChunks.Empty();
+            PreloadedPackagePath = PackagePath;
+        }
+
+        lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+        for (const auto& ModuleName : ModuleNames)
+        {
+            if (PreloadedChunks.Contains(ModuleName))
+                continue;
+
+            // already required
+            if (lua_getfield(L, -1, TCHAR_TO_UTF8(*ModuleName)) != LUA_TNIL)
+            {
+                lua_pop(L, 1);
+                continue;
+            }
+            lua_pop(L, 1);
+
+            FString FullPath;
+            if (!LocateModuleFile(PackagePath, ModuleName, FullPath))
+                continue;
+
+            PreloadedChunks.Add(ModuleName, Async(EAsyncExecution::TaskGraph, [PackagePath, ModuleName, FullPath]
+            {
+                return PreloadChunk(PackagePath, ModuleName, FullPath);
+            }));
+        }
+        lua_pop(L, 1);
     }
 
     void FLuaEnv::AddSearcher(lua_CFunction Searcher, int Index) const
@@ -913,11 +1283,17 @@ namespace UnLua
         OnAsyncLoadingFlushUpdateHandle = FCoreDelegates::OnAsyncLoadingFlushUpdate.AddRaw(this, &FLuaEnv::OnAsyncLoadingFlushUpdate);
         GUObjectArray.AddUObjectDeleteListener(this);
         bObjectArrayListenerRegistered = true;
+#if WITH_EDITOR
+        OnObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FLuaEnv::OnObjectsReplaced);
+#endif
     }
 
     FORCEINLINE void FLuaEnv::UnRegisterDelegates()
     {
         FCoreDelegates::OnAsyncLoadingFlushUpdate.Remove(OnAsyncLoadingFlushUpdateHandle);
+#if WITH_EDITOR
+        FCoreUObjectDelegates::OnObjectsReplaced.Remove(OnObjectsReplacedHandle);
+#endif
         if (!bObjectArrayListenerRegistered)
             return;
         GUObjectArray.RemoveUObjectDeleteListener(this);
@@ -0,0 +1,741 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "LuaEnvSnapshot.h"
+#include "LuaEnv.h"
+#include "UnLuaBase.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace UnLua
+{
+    static constexpr uint32 SNAPSHOT_MAGIC = 0x53534C55; // "ULSS"
+    static constexpr int32 SNAPSHOT_VERSION = 1;
+
+    enum class ESnapshotTag : uint8
+    {
+        End,
+        Nil,
+        False,
+        True,
+        Integer,
+        Number,
+        String,
+        Ref,
+        Permanent,
+        UObject,
+        Table,
+        Function,
+    };
+
+    /**
+     * Pushes a table naming every table, function and full userdata reachable by string keys from the registry,
+     * breadth first with sorted keys so two fresh envs give the same names. bByName selects name -> value instead of value -> name.
+     */
+    static void PushPermanents(lua_State* L, const bool bByName, const bool bRegistryOnly = false)
+    {
+        lua_newtable(L);
+        const int Names = lua_gettop(L);
+        lua_newtable(L); // value -> name while walking
+        const int Seen = lua_gettop(L);
+        lua_newtable(L); // tables left to walk
+        const int Queue = lua_gettop(L);
+        TArray<FString> QueueNames;
+
+        // names the value on the top of the stack and pops it
+        auto Visit = [&](const FString& Name)
+        {
+            const int Type = lua_type(L, -1);
+            if (Type != LUA_TTABLE && Type != LUA_TFUNCTION && Type != LUA_TUSERDATA)
+            {
+                lua_pop(L, 1);
+                return;
+            }
+            lua_pushvalue(L, -1);
+            if (lua_rawget(L, Seen) != LUA_TNIL)
+            {
+                lua_pop(L, 2);
+                return;
+            }
+            lua_pop(L, 1);
+
+            const FTCHARToUTF8 Utf8(*Name);
+            lua_pushvalue(L, -1);
+            lua_pushlstring(L, Utf8.Get(), Utf8.Length());
+            lua_rawset(L, Seen);
+            if (bByName)
+            {
+                lua_pushlstring(L, Utf8.Get(), Utf8.Length());
+                lua_pushvalue(L, -2);
+                lua_rawset(L, Names);
+            }
+
+            if (Type == LUA_TTABLE && !bRegistryOnly)
+            {
+                QueueNames.Add(Name);
+                lua_rawseti(L, Queue, QueueNames.Num());
+            }
+            else
+            {
+                lua_pop(L, 1);
+            }
+        };
+
+        auto VisitFields = [&](const int Table, const FString& Prefix)
+        {
+            TArray<FString> Keys;
+            lua_pushnil(L);
+            while (lua_next(L, Table))
+            {
+                lua_pop(L, 1);
+                if (lua_type(L, -1) == LUA_TSTRING)
+                    Keys.Add(UTF8_TO_TCHAR(lua_tostring(L, -1)));
+            }
+            Keys.Sort();
+            for (const auto& Key : Keys)
+            {
+                lua_pushstring(L, TCHAR_TO_UTF8(*Key));
+                lua_rawget(L, Table);
+                Visit(Prefix + Key);
+            }
+        };
+
+        lua_pushliteral(L, "");
+        if (lua_getmetatable(L, -1))
+            Visit(TEXT("#string"));
+        lua_pop(L, 1);
+
+        VisitFields(LUA_REGISTRYINDEX, TEXT("@"));
+
+        for (int32 i = 0; i < QueueNames.Num(); i++)
+        {
+            lua_checkstack(L, 8);
+            lua_rawgeti(L, Queue, i + 1);
+            const int Table = lua_gettop(L);
+            const FString Prefix = QueueNames[i] + TEXT(".");
+            VisitFields(Table, Prefix);
+            if (lua_getmetatable(L, Table))
+                Visit(QueueNames[i] + TEXT("#mt"));
+            lua_pop(L, 1);
+        }
+
+        lua_pop(L, 1);
+        if (bByName)
+            lua_pop(L, 1);
+        else
+            lua_remove(L, Names);
+    }
+
+    class FSnapshotWriter
+    {
+    public:
+        FSnapshotWriter(lua_State* L, const int Names, FArchive& Ar)
+            : L(L), Names(Names), Ar(Ar)
+        {
+            lua_newtable(L);
+            Ids = lua_gettop(L);
+        }
+
+        /** Writes the string keyed entries of a table followed by an end tag */
+        bool WriteFields(const int Table)
+        {
+            lua_pushnil(L);
+            while (lua_next(L, Table))
+            {
+                if (lua_type(L, -2) != LUA_TSTRING)
+                {
+                    lua_pop(L, 1);
+                    continue;
+                }
+                Path.Push(UTF8_TO_TCHAR(lua_tostring(L, -2)));
+                lua_pushvalue(L, -2);
+                const bool bWritten = Write() && Write();
+                Path.Pop();
+                if (!bWritten)
+                    return false;
+            }
+            WriteTag(ESnapshotTag::End);
+            return true;
+        }
+
+        FString Error;
+
+    private:
+        /** Writes and pops the value on the top of the stack */
+        bool Write()
+        {
+            if (!lua_checkstack(L, 8))
+                return Fail(TEXT("values nested too deep"));
+
+            const int Type = lua_type(L, -1);
+            switch (Type)
+            {
+            case LUA_TNIL:
+                WriteTag(ESnapshotTag::Nil);
+                lua_pop(L, 1);
+                return true;
+            case LUA_TBOOLEAN:
+                WriteTag(lua_toboolean(L, -1) ? ESnapshotTag::True : ESnapshotTag::False);
+                lua_pop(L, 1);
+                return true;
+            case LUA_TNUMBER:
+                if (lua_isinteger(L, -1))
+                {
+                    WriteTag(ESnapshotTag::Integer);
+                    int64 Value = lua_tointeger(L, -1);
+                    Ar << Value;
+                }
+                else
+                {
+                    WriteTag(ESnapshotTag::Number);
+                    double Value = lua_tonumber(L, -1);
+                    Ar << Value;
+                }
+                lua_pop(L, 1);
+                return true;
+            case LUA_TSTRING:
+                {
+                    size_t Len;
+                    const char* String = lua_tolstring(L, -1, &Len);
+                    WriteTag(ESnapshotTag::String);
+                    WriteBytes(String, Len);
+                    lua_pop(L, 1);
+                    return true;
+                }
+            default:
+                break;
+            }
+
+            lua_pushvalue(L, -1);
+            if (lua_rawget(L, Ids) != LUA_TNIL)
+            {
+                WriteTag(ESnapshotTag::Ref);
+                int32 Id = (int32)lua_tointeger(L, -1);
+                Ar << Id;
+                lua_pop(L, 2);
+                return true;
+            }
+            lua_pop(L, 1);
+
+            lua_pushvalue(L, -1);
+            if (lua_rawget(L, Names) != LUA_TNIL)
+            {
+                WriteTag(ESnapshotTag::Permanent);
+                size_t Len;
+                const char* Name = lua_tolstring(L, -1, &Len);
+                WriteBytes(Name, Len);
+                lua_pop(L, 2);
+                return true;
+            }
+            lua_pop(L, 1);
+
+            if (Type == LUA_TUSERDATA)
+            {
+                const auto Object = UnLua::GetUObject(L, -1);
+                if (!Object)
+                    return Fail(TEXT("userdata"));
+                WriteTag(ESnapshotTag::UObject);
+                FString ObjectPath = Object->GetPathName();
+                Ar << ObjectPath;
+                lua_pop(L, 1);
+                return true;
+            }
+
+            if (Type == LUA_TTABLE)
+            {
+                WriteTag(ESnapshotTag::Table);
+                AddId();
+                const int Table = lua_gettop(L);
+                if (!WriteTable(Table))
+                    return false;
+                lua_pop(L, 1);
+                return true;
+            }
+
+            if (Type == LUA_TFUNCTION && !lua_iscfunction(L, -1))
+            {
+                WriteTag(ESnapshotTag::Function);
+                const int32 Id = AddId();
+                const int Function = lua_gettop(L);
+                if (!WriteFunction(Function, Id))
+                    return false;
+                lua_pop(L, 1);
+                return true;
+            }
+
+            return Fail(UTF8_TO_TCHAR(lua_typename(L, Type)));
+        }
+
+        bool WriteTable(const int Table)
+        {
+            lua_pushnil(L);
+            while (lua_next(L, Table))
+            {
+                Path.Push(lua_type(L, -2) == LUA_TSTRING ? FString(UTF8_TO_TCHAR(lua_tostring(L, -2))) : TEXT("[]"));
+                lua_pushvalue(L, -2);
+                const bool bWritten = Write() && Write();
+                Path.Pop();
+                if (!bWritten)
+                    return false;
+            }
+            WriteTag(ESnapshotTag::End);
+
+            Path.Push(TEXT("#mt"));
+            if (!lua_getmetatable(L, Table))
+                lua_pushnil(L);
+            const bool bWritten = Write();
+            Path.Pop();
+            return bWritten;
+        }
+
+        bool WriteFunction(const int Function, const int32 Id)
+        {
+            TArray<uint8> Bytecode;
+            lua_pushvalue(L, Function);
+            lua_dump(L, [](lua_State*, const void* Data, size_t Size, void* UserData)
+            {
+                ((TArray<uint8>*)UserData)->Append((const uint8*)Data, Size);
+                return 0;
+            }, &Bytecode, 0);
+            lua_pop(L, 1);
+            WriteBytes(Bytecode.GetData(), Bytecode.Num());
+
+            lua_Debug Debug;
+            lua_pushvalue(L, Function);
+            lua_getinfo(L, ">u", &Debug);
+            int32 NumUpvalues = Debug.nups;
+            Ar << NumUpvalues;
+            for (int32 i = 1; i <= NumUpvalues; i++)
+            {
+                // upvalues shared by several closures are written once, later closures join them
+                const void* UpvalueId = lua_upvalueid(L, Function, i);
+                if (const auto Shared = Upvalues.Find(UpvalueId))
+                {
+                    int32 Owner = Shared->Key;
+                    int32 Index = Shared->Value;
+                    Ar << Owner << Index;
+                    continue;
+                }
+
+                int32 NotShared = INDEX_NONE;
+                Ar << NotShared;
+                Upvalues.Add(UpvalueId, TPair<int32, int32>(Id, i));
+                const char* Name = lua_getupvalue(L, Function, i);
+                Path.Push(FString::Printf(TEXT("<upvalue %s>"), Name ? UTF8_TO_TCHAR(Name) : TEXT("?")));
+                const bool bWritten = Write();
+                Path.Pop();
+                if (!bWritten)
+                    return false;
+            }
+            return true;
+        }
+
+        int32 AddId()
+        {
+            lua_pushvalue(L, -1);
+            lua_pushinteger(L, ++NumIds);
+            lua_rawset(L, Ids);
+            return NumIds;
+        }
+
+        void WriteTag(const ESnapshotTag Tag)
+        {
+            uint8 Value = (uint8)Tag;
+            Ar << Value;
+        }
+
+        void WriteBytes(const void* Data, const size_t Len)
+        {
+            int32 Num = (int32)Len;
+            Ar << Num;
+            Ar.Serialize(const_cast<void*>(Data), Num);
+        }
+
+        bool Fail(const TCHAR* What)
+        {
+            Error = FString::Printf(TEXT("can't snapshot %s at %s"), What, *FString::Join(Path, TEXT(".")));
+            return false;
+        }
+
+        lua_State* L;
+        int Names;
+        int Ids;
+        int32 NumIds = 0;
+        FArchive& Ar;
+        TArray<FString> Path;
+        TMap<const void*, TPair<int32, int32>> Upvalues;
+    };
+
+    class FSnapshotReader
+    {
+    public:
+        FSnapshotReader(lua_State* L, const int Names, FArchive& Ar)
+            : L(L), Names(Names), Ar(Ar)
+        {
+            lua_newtable(L);
+            Ids = lua_gettop(L);
+        }
+
+        /** Reads entries up to an end tag into the table on the top of the stack */
+        bool ReadFields()
+        {
+            const int Table = lua_gettop(L);
+            while (true)
+            {
+                ESnapshotTag Tag;
+                if (!Read(Tag))
+                    return false;
+                if (Tag == ESnapshotTag::End)
+                    return true;
+                if (!Read())
+                    return false;
+                lua_rawset(L, Table);
+            }
+        }
+
+        FString Error;
+
+    private:
+        bool ReadTag(ESnapshotTag& Tag)
+        {
+            uint8 Value = 0;
+            Ar << Value;
+            Tag = (ESnapshotTag)Value;
+            return !Ar.IsError();
+        }
+
+        /** Reads the value of an already read tag and pushes it */
+        bool Read(ESnapshotTag& Tag)
+        {
+            if (!ReadTag(Tag))
+                return Fail(TEXT("truncated snapshot"));
+            if (Tag == ESnapshotTag::End)
+                return true;
+            return ReadValue(Tag);
+        }
+
+        bool Read()
+        {
+            ESnapshotTag Tag;
+            if (!Read(Tag))
+                return false;
+            return Tag != ESnapshotTag::End || Fail(TEXT("unexpected end tag"));
+        }
+
+        bool ReadValue(const ESnapshotTag Tag)
+        {
+            if (!lua_checkstack(L, 8))
+                return Fail(TEXT("values nested too deep"));
+
+            switch (Tag)
+            {
+            case ESnapshotTag::Nil:
+                lua_pushnil(L);
+                return true;
+            case ESnapshotTag::False:
+            case ESnapshotTag::True:
+                lua_pushboolean(L, Tag == ESnapshotTag::True);
+                return true;
+            case ESnapshotTag::Integer:
+                {
+                    int64 Value = 0;
+                    Ar << Value;
+                    lua_pushinteger(L, (lua_Integer)Value);
+                    return true;
+                }
+            case ESnapshotTag::Number:
+                {
+                    double Value = 0;
+                    Ar << Value;
+                    lua_pushnumber(L, (lua_Number)Value);
+                    return true;
+                }
+            case ESnapshotTag::String:
+                {
+                    TArray<uint8> Bytes;
+                    if (!ReadBytes(Bytes))
+                        return false;
+                    lua_pushlstring(L, (const char*)Bytes.GetData(), Bytes.Num());
+                    return true;
+                }
+            case ESnapshotTag::Ref:
+                {
+                    int32 Id = 0;
+                    Ar << Id;
+                    if (lua_rawgeti(L, Ids, Id) == LUA_TNIL)
+                        return Fail(TEXT("invalid reference"));
+                    return true;
+                }
+            case ESnapshotTag::Permanent:
+                return ReadPermanent();
+            case ESnapshotTag::UObject:
+                {
+                    FString ObjectPath;
+                    Ar << ObjectPath;
+                    UObject* Object = StaticFindObject(UObject::StaticClass(), nullptr, *ObjectPath);
+                    if (!Object)
+                        Object = StaticLoadObject(UObject::StaticClass(), nullptr, *ObjectPath, nullptr, LOAD_NoWarn);
+                    if (!Object)
+                        UE_LOG(LogUnLua, Warning, TEXT("snapshot object %s not found, restored as nil"), *ObjectPath);
+                    PushUObject(L, Object);
+                    return true;
+                }
+            case ESnapshotTag::Table:
+                return ReadTable();
+            case ESnapshotTag::Function:
+                return ReadFunction();
+            default:
+                return Fail(TEXT("invalid tag"));
+            }
+        }
+
+        bool ReadPermanent()
+        {
+            TArray<uint8> Bytes;
+            if (!ReadBytes(Bytes))
+                return false;
+
+            lua_pushlstring(L, (const char*)Bytes.GetData(), Bytes.Num());
+            if (lua_rawget(L, Names) != LUA_TNIL)
+                return true;
+            lua_pop(L, 1);
+
+            // types loaded after env creation are registered under their own name, load them the way UE.XXX does
+            const char* Name = (const char*)Bytes.GetData();
+            const int32 Len = Bytes.Num();
+            if (Len > 1 && Name[0] == '@' && !Bytes.Contains('.'))
+            {
+                lua_getglobal(L, "UE");
+                if (lua_istable(L, -1))
+                {
+                    lua_pushlstring(L, Name + 1, Len - 1);
+                    lua_gettable(L, -2);
+                    lua_pop(L, 1);
+                }
+                lua_pop(L, 1);
+                lua_pushlstring(L, Name + 1, Len - 1);
+                if (lua_rawget(L, LUA_REGISTRYINDEX) != LUA_TNIL)
+                    return true;
+                lua_pop(L, 1);
+            }
+            const FUTF8ToTCHAR Converted(Name, Len);
+            return Fail(*FString::Printf(TEXT("unknown name %s"), *FString(Converted.Length(), Converted.Get())));
+        }
+
+        bool ReadTable()
+        {
+            lua_newtable(L);
+            AddId();
+            if (!ReadFields())
+                return false;
+            if (!Read())
+                return false;
+            if (lua_istable(L, -1))
+                lua_setmetatable(L, -2);
+            else
+                lua_pop(L, 1);
+            return true;
+        }
+
+        bool ReadFunction()
+        {
+            TArray<uint8> Bytecode;
+            if (!ReadBytes(Bytecode))
+                return false;
+            if (luaL_loadbufferx(L, (const char*)Bytecode.GetData(), Bytecode.Num(), "snapshot", "b") != LUA_OK)
+            {
+                const FString LoadError = UTF8_TO_TCHAR(lua_tostring(L, -1));
+                lua_pop(L, 1);
+                return Fail(*LoadError);
+            }
+            const int Function = lua_gettop(L);
+            AddId();
+
+            int32 NumUpvalues = 0;
+            Ar << NumUpvalues;
+            for (int32 i = 1; i <= NumUpvalues; i++)
+            {
+                int32 Owner = INDEX_NONE;
+                Ar << Owner;
+                if (Owner != INDEX_NONE)
+                {
+                    int32 Index = 0;
+                    Ar << Index;
+                    if (lua_rawgeti(L, Ids, Owner) != LUA_TFUNCTION)
+                        return Fail(TEXT("invalid shared upvalue"));
+                    lua_upvaluejoin(L, Function, i, -1, Index);
+                    lua_pop(L, 1);
+                    continue;
+                }
+
+                if (!Read())
+                    return false;
+                if (!lua_setupvalue(L, Function, i))
+                    lua_pop(L, 1);
+            }
+            return true;
+        }
+
+        void AddId()
+        {
+            lua_pushvalue(L, -1);
+            lua_rawseti(L, Ids, ++NumIds);
+        }
+
+        bool ReadBytes(TArray<uint8>& Bytes)
+        {
+            int32 Num = 0;
+            Ar << Num;
+            if (Ar.IsError() || Num < 0 || Num > Ar.TotalSize() - Ar.Tell())
+                return Fail(TEXT("truncated snapshot"));
+            Bytes.SetNumUninitialized(Num);
+            Ar.Serialize(Bytes.GetData(), Num);
+            return true;
+        }
+
+        bool Fail(const TCHAR* What)
+        {
+            if (Error.IsEmpty())
+                Error = What;
+            return false;
+        }
+
+        lua_State* L;
+        int Names;
+        int Ids;
+        int32 NumIds = 0;
+        FArchive& Ar;
+    };
+
+    bool FLuaEnvSnapshot::Save(FLuaEnv& Env, const FString& StartupModuleName, const TMap<FString, UObject*>& Args, const FString& FilePath)
+    {
+        if (Env.IsStarted())
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("can't snapshot lua env %s, it has already started"), *Env.GetName());
+            return false;
+        }
+
+        const auto L = Env.GetMainState();
+        const int Top = lua_gettop(L);
+        PushPermanents(L, false);
+        const int Names = lua_gettop(L);
+
+        Env.Start(StartupModuleName, Args);
+        lua_settop(L, Names);
+
+        // metatables of types first used by the startup module, Load finds them again through UE
+        PushPermanents(L, false, true);
+        lua_pushnil(L);
+        while (lua_next(L, -2))
+        {
+            lua_pushvalue(L, -2);
+            if (lua_rawget(L, Names) == LUA_TNIL)
+            {
+                lua_pop(L, 1);
+                lua_pushvalue(L, -2);
+                lua_insert(L, -2);
+                lua_rawset(L, Names);
+                continue;
+            }
+            lua_pop(L, 2);
+        }
+        lua_pop(L, 1);
+
+        TArray<uint8> Bytes;
+        FMemoryWriter Ar(Bytes);
+        uint32 Magic = SNAPSHOT_MAGIC;
+        int32 Version = SNAPSHOT_VERSION;
+        int32 LuaVersion = LUA_VERSION_NUM;
+        Ar << Magic << Version << LuaVersion;
+
+        FSnapshotWriter Writer(L, Names, Ar);
+        lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+        bool bWritten = Writer.WriteFields(lua_gettop(L));
+        if (bWritten)
+        {
+            lua_pushglobaltable(L);
+            bWritten = Writer.WriteFields(lua_gettop(L));
+        }
+        lua_settop(L, Top);
+
+        if (!bWritten)
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("failed to snapshot lua env %s: %s"), *Env.GetName(), *Writer.Error);
+            return false;
+        }
+        return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+    }
+
+    bool FLuaEnvSnapshot::Load(FLuaEnv& Env, const FString& FilePath)
+    {
+        if (Env.IsStarted())
+            return false;
+
+        TArray<uint8> Bytes;
+        if (!FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent))
+            return false;
+
+        FMemoryReader Ar(Bytes);
+        uint32 Magic = 0;
+        int32 Version = 0;
+        int32 LuaVersion = 0;
+        Ar << Magic << Version << LuaVersion;
+        if (Magic != SNAPSHOT_MAGIC || Version != SNAPSHOT_VERSION || LuaVersion != LUA_VERSION_NUM)
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("lua env snapshot %s is outdated"), *FilePath);
+            return false;
+        }
+
+        const auto L = Env.GetMainState();
+        const int Top = lua_gettop(L);
+        PushPermanents(L, true);
+        const int Names = lua_gettop(L);
+
+        // read everything aside first, a broken snapshot leaves the env untouched
+        FSnapshotReader Reader(L, Names, Ar);
+        lua_newtable(L);
+        const int Loaded = lua_gettop(L);
+        bool bRead = Reader.ReadFields();
+        lua_newtable(L);
+        const int Globals = lua_gettop(L);
+        bRead = bRead && Reader.ReadFields();
+        if (!bRead)
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("failed to load lua env snapshot %s: %s"), *FilePath, *Reader.Error);
+            lua_settop(L, Top);
+            return false;
+        }
+
+        for (const auto Pair : {TPair<int, int>(Loaded, 0), TPair<int, int>(Globals, 1)})
+        {
+            if (Pair.Value == 0)
+                lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+            else
+                lua_pushglobaltable(L);
+            lua_pushnil(L);
+            while (lua_next(L, Pair.Key))
+            {
+                lua_pushvalue(L, -2);
+                lua_insert(L, -2);
+                lua_rawset(L, -4);
+            }
+            lua_pop(L, 1);
+        }
+        lua_settop(L, Top);
+
+        Env.Start(TEXT(""), {});
+        return true;
+    }
+}
@@ -193,9 +193,16 @@
 static constexpr uint8 ScriptMagicHeader[] = {EX_StringConst, 'L', 'U', 'A', '\0', EX_UInt64Const};
 static constexpr size_t ScriptMagicHeaderSize = sizeof ScriptMagicHeader;
 
-DEFINE_FUNCTION(ULuaFunction::execCallLua)
+static void CallLua(ULuaFunction* LuaFunction, UObject* Context, FFrame& Stack, RESULT_DECL)
 {
-    const auto LuaFunction = Cast<ULuaFunction>(Stack.CurrentNativeFunction);
+    // 已绑定的对象直接用绑定时记下的环境和实例引用
+    if (const auto Record = UnLua::FObjectRegistry::FindBoundRecord(Context))
+    {
+        const auto SelfRef = Record->SelfRef;
+        Record->Env->GetFunctionRegistry()->Invoke(LuaFunction, Context, SelfRef, Stack, RESULT_PARAM);
+        return;
+    }
+
     const auto Env = IUnLuaModule::Get().GetEnv(Context);
     if (!Env)
     {
@@ -205,18 +212,18 @@ DEFINE_FUNCTION(ULuaFunction::execCallLua)
     Env->GetFunctionRegistry()->Invoke(LuaFunction, Context, Stack, RESULT_PARAM);
 }
 
+DEFINE_FUNCTION(ULuaFunction::execCallLua)
+{
+    const auto LuaFunction = Cast<ULuaFunction>(Stack.CurrentNativeFunction);
+    CallLua(LuaFunction, Context, Stack, RESULT_PARAM);
+}
+
 DEFINE_FUNCTION(ULuaFunction::execScriptCallLua)
 {
     const auto LuaFunction = Get(Stack.CurrentNativeFunction);
     if (!LuaFunction)
         return;
-    const auto Env = IUnLuaModule::Get().GetEnv(Context);
-    if (!Env)
-    {
-        // PIE 结束时可能已经没有Lua环境了
-        return;
-    }
-    Env->GetFunctionRegistry()->Invoke(LuaFunction, Context, Stack, RESULT_PARAM);
+    CallLua(LuaFunction, Context, Stack, RESULT_PARAM);
 }
 
 ULuaFunction* ULuaFunction::Get(UFunction* Function)
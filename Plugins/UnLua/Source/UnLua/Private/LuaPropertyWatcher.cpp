@@ -0,0 +1,238 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "LuaPropertyWatcher.h"
+#include "LuaEnv.h"
+#include "UnLuaPrivate.h"
+#include "ReflectionUtils/ClassDesc.h"
+#include "ReflectionUtils/FieldDesc.h"
+#include "ReflectionUtils/PropertyDesc.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Property Watches"), STAT_UnLua_PropertyWatches, STATGROUP_UnLua);
+UNLUA_DECLARE_DWORD_COUNTER_STAT("Changed Properties", UnLua_ChangedProperties);
+UNLUA_DECLARE_CYCLE_STAT("Compare Watched Properties", UnLua_CompareWatchedProperties);
+
+namespace UnLua
+{
+    static const char* DISPATCHER_CHUNK = R"(
+return function(Report, Batch, N)
+    for i = 1, N, 3 do
+        xpcall(Batch[i], Report, Batch[i + 1], Batch[i + 2])
+    end
+end
+)";
+
+    FPropertyWatcher::FPropertyWatcher(FLuaEnv* Env)
+        : Env(Env)
+    {
+        const auto L = Env->GetMainState();
+        luaL_loadbuffer(L, DISPATCHER_CHUNK, FCStringAnsi::Strlen(DISPATCHER_CHUNK), "Watch");
+        lua_call(L, 0, 1);
+        DispatcherRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        lua_newtable(L);
+        BatchRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+#if ENGINE_MAJOR_VERSION >= 5
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FPropertyWatcher::OnTicker));
+#else
+        TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FPropertyWatcher::OnTicker));
+#endif
+    }
+
+    FPropertyWatcher::~FPropertyWatcher()
+    {
+        // the lua state is already closed, along with the callbacks it referenced
+#if ENGINE_MAJOR_VERSION >= 5
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+        FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+        for (auto& Watch : Watches)
+        {
+            if (!Watch.Copy)
+                continue;
+            const FProperty* Property = Watch.Property->GetUProperty();
+            Property->DestroyValue(Watch.Copy);
+            FMemory::Free(Watch.Copy);
+        }
+    }
+
+    int FPropertyWatcher::Watch(lua_State* L)
+    {
+        UObject* Object = GetUObject(L, 1);
+        if (!Object)
+            return luaL_error(L, "invalid UObject");
+        const char* PropertyName = luaL_checkstring(L, 2);
+        luaL_checktype(L, 3, LUA_TFUNCTION);
+
+        TSharedPtr<FPropertyDesc> Property;
+        if (FClassDesc* ClassDesc = Env->GetClassRegistry()->Register(Object->GetClass()))
+        {
+            const auto Field = ClassDesc->RegisterField(FName(UTF8_TO_TCHAR(PropertyName)), ClassDesc);
+            if (Field && Field->IsValid())
+                Property = Field->AsProperty();
+        }
+        if (!Property || !Property->IsValid())
+            return luaL_error(L, "can't find property %s", PropertyName);
+
+        const FProperty* UProperty = Property->GetUProperty();
+        const FBoolProperty* BoolProperty = CastField<FBoolProperty>(UProperty);
+        const int32 Size = UProperty->GetSize();
+
+        FWatch Watch;
+        Watch.ValuePtr = UProperty->ContainerPtrToValuePtr<uint8>(Object);
+        Watch.Size = Size;
+        // bitfield bools share their byte with other bools, so they are compared by value
+        Watch.bRaw = UProperty->HasAnyPropertyFlags(CPF_IsPlainOldData) && Size <= RawSize && (!BoolProperty || BoolProperty->IsNativeBool());
+        if (Watch.bRaw)
+        {
+            FMemory::Memcpy(Watch.Snapshot, Watch.ValuePtr, Size);
+            Watch.Copy = nullptr;
+        }
+        else
+        {
+            Watch.Copy = FMemory::Malloc(Size, UProperty->GetMinAlignment());
+            UProperty->InitializeValue(Watch.Copy);
+            UProperty->CopyCompleteValue(Watch.Copy, Watch.ValuePtr);
+        }
+        Watch.Object = Object;
+        Watch.Property = Property;
+        lua_pushvalue(L, 3);
+        Watch.CallbackRef = luaL_ref(L, LUA_REGISTRYINDEX);
+        Watch.Id = NextId++;
+
+        IndexOfId.Add(Watch.Id, Watches.Num());
+        WatchesOfObject.Add(Object, Watch.Id);
+        Env->MarkObjectTracked(Object);
+        lua_pushinteger(L, Watch.Id);
+        Watches.Add(MoveTemp(Watch));
+        SET_DWORD_STAT(STAT_UnLua_PropertyWatches, Watches.Num());
+        return 1;
+    }
+
+    bool FPropertyWatcher::Unwatch(const int64 Id)
+    {
+        const int32* Index = IndexOfId.Find(Id);
+        if (!Index)
+            return false;
+        RemoveAt(*Index);
+        return true;
+    }
+
+    void FPropertyWatcher::Tick()
+    {
+        {
+            UNLUA_SCOPE_CYCLE_COUNTER(UnLua_CompareWatchedProperties);
+            Changed.Reset();
+            for (auto& Watch : Watches)
+            {
+                // like ticks, objects being destroyed are not called back, and their memory may already be torn down
+                const UObject* Object = Watch.Object;
+                if (!IsValid(Object) || Object->IsUnreachable() || Object->HasAnyFlags(RF_BeginDestroyed))
+                    continue;
+
+                if (Watch.bRaw)
+                {
+                    if (FMemory::Memcmp(Watch.Snapshot, Watch.ValuePtr, Watch.Size) == 0)
+                        continue;
+                    FMemory::Memcpy(Watch.Snapshot, Watch.ValuePtr, Watch.Size);
+                }
+                else
+                {
+                    const FProperty* Property = Watch.Property->GetUProperty();
+                    if (Property->Identical(Watch.Copy, Watch.ValuePtr))
+                        continue;
+                    Property->CopyCompleteValue(Watch.Copy, Watch.ValuePtr);
+                }
+                Changed.Add(Watch.Id);
+            }
+        }
+
+        if (Changed.Num() == 0 && LastBatchSize == 0)
+            return;
+
+        // pushing values may run finalizers that unwatch, so every watch is looked up again
+        const auto L = Env->GetMainState();
+        const int32 Top = lua_gettop(L);
+        lua_pushcfunction(L, ReportLuaCallError);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, DispatcherRef);
+        lua_pushvalue(L, -2);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, BatchRef);
+        int32 BatchSize = 0;
+        for (const int64 Id : Changed)
+        {
+            const int32* Index = IndexOfId.Find(Id);
+            if (!Index)
+                continue;
+            const FWatch& Watch = Watches[*Index];
+            UObject* Object = Watch.Object;
+            const TSharedPtr<FPropertyDesc> Property = Watch.Property;
+            lua_rawgeti(L, LUA_REGISTRYINDEX, Watch.CallbackRef);
+            lua_rawseti(L, -2, ++BatchSize);
+            PushUObject(L, Object);
+            lua_rawseti(L, -2, ++BatchSize);
+            Property->ReadValue_InContainer(L, Object, true);
+            lua_rawseti(L, -2, ++BatchSize);
+        }
+
+        // drop values left over from a bigger frame
+        for (int32 i = BatchSize + 1; i <= LastBatchSize; i++)
+        {
+            lua_pushnil(L);
+            lua_rawseti(L, -2, i);
+        }
+        LastBatchSize = BatchSize;
+
+        if (BatchSize > 0)
+        {
+            INC_DWORD_STAT_BY(STAT_UnLua_ChangedProperties, BatchSize / 3);
+            lua_pushinteger(L, BatchSize);
+            lua_pcall(L, 3, 0, Top + 1);
+        }
+        lua_settop(L, Top);
+    }
+
+    void FPropertyWatcher::NotifyUObjectDeleted(const UObject* Object)
+    {
+        TArray<int64> Ids;
+        WatchesOfObject.MultiFind(Object, Ids);
+        for (const int64 Id : Ids)
+            Unwatch(Id);
+    }
+
+    void FPropertyWatcher::RemoveAt(const int32 Index)
+    {
+        auto& Watch = Watches[Index];
+        luaL_unref(Env->GetMainState(), LUA_REGISTRYINDEX, Watch.CallbackRef);
+        if (Watch.Copy)
+        {
+            const FProperty* Property = Watch.Property->GetUProperty();
+            Property->DestroyValue(Watch.Copy);
+            FMemory::Free(Watch.Copy);
+        }
+        IndexOfId.Remove(Watch.Id);
+        WatchesOfObject.RemoveSingle(Watch.Object, Watch.Id);
+
+        Watches.RemoveAtSwap(Index, 1, false);
+        if (Index < Watches.Num())
+            IndexOfId.FindChecked(Watches[Index].Id) = Index;
+        SET_DWORD_STAT(STAT_UnLua_PropertyWatches, Watches.Num());
+    }
+
+    bool FPropertyWatcher::OnTicker(float DeltaSeconds)
+    {
+        Tick();
+        return true;
+    }
+}
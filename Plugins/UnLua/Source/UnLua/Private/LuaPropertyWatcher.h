@@ -0,0 +1,90 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "lua.hpp"
+
+class FPropertyDesc;
+
+namespace UnLua
+{
+    class FLuaEnv;
+
+    /**
+     * Calls Lua back when a property of an object changes, instead of polling it from Lua.
+     *
+     * Every watch keeps a snapshot of its value, all of them are compared once per frame and the changed ones are passed to
+     * their callbacks in a single call into Lua. Plain old data up to RawSize bytes is compared byte for byte against a snapshot
+     * kept in the watch itself, anything else against a copy with FProperty::Identical.
+     * Watches of an object are dropped when the object is deleted.
+     */
+    class FPropertyWatcher
+    {
+    public:
+        explicit FPropertyWatcher(FLuaEnv* Env);
+
+        ~FPropertyWatcher();
+
+        /** UnLua.Watch(Object, PropertyName, Callback), returns an id for UnLua.Unwatch */
+        int Watch(lua_State* L);
+
+        bool Unwatch(int64 Id);
+
+        /** Compare every watched value and call back the changed ones, the core ticker calls it every frame */
+        void Tick();
+
+        void NotifyUObjectDeleted(const UObject* Object);
+
+        FORCEINLINE int32 GetNumWatches() const { return Watches.Num(); }
+
+    private:
+        static constexpr int32 RawSize = 32;
+
+        struct FWatch
+        {
+            uint8 Snapshot[RawSize];
+            const uint8* ValuePtr; // stays valid until the object is deleted, and the watch with it
+            int32 Size;
+            bool bRaw;
+            void* Copy; // snapshot of values that are not compared byte for byte
+            UObject* Object;
+            TSharedPtr<FPropertyDesc> Property;
+            int32 CallbackRef;
+            int64 Id;
+        };
+
+        void RemoveAt(int32 Index);
+
+        bool OnTicker(float DeltaSeconds);
+
+        FLuaEnv* Env;
+        TArray<FWatch> Watches;
+        TMap<int64, int32> IndexOfId;
+        TMultiMap<const UObject*, int64> WatchesOfObject;
+        TArray<int64> Changed;
+        int64 NextId = 1;
+        int32 DispatcherRef;
+        int32 BatchRef;
+        int32 LastBatchSize = 0;
+#if ENGINE_MAJOR_VERSION >= 5
+        FTSTicker::FDelegateHandle TickerHandle;
+#else
+        FDelegateHandle TickerHandle;
+#endif
+    };
+}
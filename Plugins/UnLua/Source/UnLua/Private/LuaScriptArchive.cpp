@@ -0,0 +1,298 @@
+﻿// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "LuaScriptArchive.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "UnLuaBase.h"
+
+namespace UnLua
+{
+    static constexpr uint32 ARCHIVE_MAGIC = 0x41534C55; // "ULSA"
+    static constexpr uint32 ARCHIVE_VERSION = 1;
+
+    struct FArchiveHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 NumModules;
+        uint32 Reserved;
+    };
+
+    struct FLuaScriptArchive::FEntry
+    {
+        uint64 NameOffset;
+        uint64 DataOffset;
+        uint32 NameSize;
+        uint32 DataSize;
+        uint32 RawSize; // 0 when the data is not compressed
+        uint32 Hash;
+    };
+
+    static_assert(sizeof(FArchiveHeader) == 16 && sizeof(FLuaScriptArchive::FEntry) == 32, "archive layout must not depend on the platform");
+
+    static FCriticalSection ArchivesLock;
+    static TMap<FString, TWeakPtr<FLuaScriptArchive, ESPMode::ThreadSafe>> Archives;
+
+    bool FLuaScriptArchive::Compile(const TArray<uint8>& Source, const FString& ChunkName, bool bStripDebugInfo, TArray<uint8>& OutBytecode, FString& OutError)
+    {
+        const char* Buffer = (const char*)Source.GetData();
+        int32 BufferSize = Source.Num();
+        if (BufferSize > 3 && Buffer[0] == static_cast<char>(0xEF) && Buffer[1] == static_cast<char>(0xBB) && Buffer[2] == static_cast<char>(0xBF))
+        {
+            Buffer += 3;
+            BufferSize -= 3;
+        }
+
+        lua_State* L = luaL_newstate();
+        const bool bOk = luaL_loadbufferx(L, Buffer, BufferSize, TCHAR_TO_UTF8(*ChunkName), "t") == LUA_OK;
+        if (bOk)
+        {
+            OutBytecode.Reset();
+            lua_dump(L, [](lua_State*, const void* Data, size_t Size, void* UserData)
+            {
+                ((TArray<uint8>*)UserData)->Append((const uint8*)Data, Size);
+                return 0;
+            }, &OutBytecode, bStripDebugInfo ? 1 : 0);
+        }
+        else
+        {
+            OutError = UTF8_TO_TCHAR(lua_tostring(L, -1));
+        }
+        lua_close(L);
+        return bOk;
+    }
+
+    bool FLuaScriptArchive::Write(const FString& FilePath, TArray<FModule> Modules, bool bCompress)
+    {
+        TArray<TArray<uint8>> Names;
+        Names.Reserve(Modules.Num());
+        for (const auto& Module : Modules)
+        {
+            const FTCHARToUTF8 Name(*Module.Name);
+            Names.Emplace((const uint8*)Name.Get(), Name.Length());
+        }
+
+        // sorted by the utf-8 bytes, the same order Find compares in
+        TArray<int32> Order;
+        for (int32 i = 0; i < Modules.Num(); i++)
+            Order.Add(i);
+        Order.Sort([&Names](const int32 A, const int32 B)
+        {
+            const auto& NameA = Names[A];
+            const auto& NameB = Names[B];
+            const int32 Result = FMemory::Memcmp(NameA.GetData(), NameB.GetData(), FMath::Min(NameA.Num(), NameB.Num()));
+            return Result < 0 || (Result == 0 && NameA.Num() < NameB.Num());
+        });
+
+        TArray<FEntry> Entries;
+        Entries.SetNumZeroed(Modules.Num());
+        TArray<uint8> NameBlock;
+        TArray<uint8> DataBlock;
+        for (int32 i = 0; i < Order.Num(); i++)
+        {
+            const int32 Index = Order[i];
+            if (i > 0 && Names[Order[i - 1]] == Names[Index])
+            {
+                UE_LOG(LogUnLua, Error, TEXT("duplicated module '%s' in script archive %s"), *Modules[Index].Name, *FilePath);
+                return false;
+            }
+
+            auto& Entry = Entries[i];
+            const auto& Raw = Modules[Index].Data;
+            Entry.NameOffset = NameBlock.Num();
+            Entry.NameSize = Names[Index].Num();
+            NameBlock.Append(Names[Index]);
+            Entry.Hash = FCrc::MemCrc32(Raw.GetData(), Raw.Num());
+            Entry.DataOffset = DataBlock.Num();
+
+            int32 CompressedSize = bCompress ? FCompression::CompressMemoryBound(NAME_Zlib, Raw.Num()) : 0;
+            if (CompressedSize > 0)
+            {
+                TArray<uint8> Compressed;
+                Compressed.SetNumUninitialized(CompressedSize);
+                if (FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Raw.GetData(), Raw.Num()) && CompressedSize < Raw.Num())
+                {
+                    Entry.RawSize = Raw.Num();
+                    Entry.DataSize = CompressedSize;
+                    DataBlock.Append(Compressed.GetData(), CompressedSize);
+                    continue;
+                }
+            }
+
+            Entry.DataSize = Raw.Num();
+            DataBlock.Append(Raw);
+        }
+
+        const uint64 NameBase = sizeof(FArchiveHeader) + sizeof(FEntry) * Entries.Num();
+        const uint64 DataBase = Align(NameBase + NameBlock.Num(), 16);
+        for (auto& Entry : Entries)
+        {
+            Entry.NameOffset += NameBase;
+            Entry.DataOffset += DataBase;
+        }
+
+        FArchiveHeader Header;
+        Header.Magic = ARCHIVE_MAGIC;
+        Header.Version = ARCHIVE_VERSION;
+        Header.NumModules = Entries.Num();
+        Header.Reserved = 0;
+
+        TArray<uint8> Bytes;
+        Bytes.Reserve(DataBase + DataBlock.Num());
+        Bytes.Append((const uint8*)&Header, sizeof(Header));
+        Bytes.Append((const uint8*)Entries.GetData(), sizeof(FEntry) * Entries.Num());
+        Bytes.Append(NameBlock);
+        Bytes.AddZeroed(DataBase - Bytes.Num());
+        Bytes.Append(DataBlock);
+        return FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+    }
+
+    TSharedPtr<FLuaScriptArchive, ESPMode::ThreadSafe> FLuaScriptArchive::Mount(const FString& FilePath)
+    {
+        const auto FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+        FScopeLock Lock(&ArchivesLock);
+        if (const auto Existing = Archives.Find(FullPath))
+        {
+            if (const auto Archive = Existing->Pin())
+                return Archive;
+        }
+
+        TSharedPtr<FLuaScriptArchive, ESPMode::ThreadSafe> Archive(new FLuaScriptArchive());
+        if (!Archive->Open(FullPath))
+            return nullptr;
+        Archives.Add(FullPath, Archive);
+        return Archive;
+    }
+
+    FLuaScriptArchive::~FLuaScriptArchive()
+    {
+        MappedRegion.Reset();
+        MappedHandle.Reset();
+    }
+
+    bool FLuaScriptArchive::Open(const FString& InFilePath)
+    {
+        FilePath = InFilePath;
+        IMappedFileHandle* Handle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath);
+        if (Handle)
+        {
+            MappedHandle.Reset(Handle);
+            if (Handle->GetFileSize() > 0)
+                MappedRegion.Reset(Handle->MapRegion());
+        }
+
+        if (MappedRegion.IsValid())
+        {
+            Data = MappedRegion->GetMappedPtr();
+            Size = MappedRegion->GetMappedSize();
+        }
+        else
+        {
+            MappedHandle.Reset();
+            if (!FFileHelper::LoadFileToArray(LoadedData, *FilePath, FILEREAD_Silent))
+                return false;
+            Data = LoadedData.GetData();
+            Size = LoadedData.Num();
+        }
+
+        if (Size < (int64)sizeof(FArchiveHeader))
+            return false;
+
+        const auto& Header = *(const FArchiveHeader*)Data;
+        if (Header.Magic != ARCHIVE_MAGIC || Header.Version != ARCHIVE_VERSION)
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("invalid script archive %s"), *FilePath);
+            return false;
+        }
+
+        const int64 NameBase = sizeof(FArchiveHeader) + sizeof(FEntry) * (int64)Header.NumModules;
+        if (NameBase > Size)
+            return false;
+
+        Entries = (const FEntry*)(Data + sizeof(FArchiveHeader));
+        for (uint32 i = 0; i < Header.NumModules; i++)
+        {
+            const auto& Entry = Entries[i];
+            if (Entry.NameOffset < (uint64)NameBase || Entry.NameOffset + Entry.NameSize > (uint64)Size || Entry.DataOffset + Entry.DataSize > (uint64)Size)
+            {
+                UE_LOG(LogUnLua, Warning, TEXT("corrupted script archive %s"), *FilePath);
+                return false;
+            }
+        }
+        NumModules = Header.NumModules;
+        return true;
+    }
+
+    const FLuaScriptArchive::FEntry* FLuaScriptArchive::Find(const char* ModuleName) const
+    {
+        const int32 NameSize = FCStringAnsi::Strlen(ModuleName);
+        int32 Low = 0;
+        int32 High = NumModules - 1;
+        while (Low <= High)
+        {
+            const int32 Mid = (Low + High) / 2;
+            const auto& Entry = Entries[Mid];
+            int32 Result = FMemory::Memcmp(Data + Entry.NameOffset, ModuleName, FMath::Min<int32>(Entry.NameSize, NameSize));
+            if (Result == 0)
+                Result = (int32)Entry.NameSize - NameSize;
+            if (Result == 0)
+                return &Entry;
+            if (Result < 0)
+                Low = Mid + 1;
+            else
+                High = Mid - 1;
+        }
+        return nullptr;
+    }
+
+    bool FLuaScriptArchive::Contains(const char* ModuleName) const
+    {
+        return Find(ModuleName) != nullptr;
+    }
+
+    uint32 FLuaScriptArchive::GetHash(const char* ModuleName) const
+    {
+        const auto Entry = Find(ModuleName);
+        return Entry ? Entry->Hash : 0;
+    }
+
+    bool FLuaScriptArchive::GetData(const char* ModuleName, const char*& OutData, int32& OutSize, TArray<uint8>& Scratch) const
+    {
+        const auto Entry = Find(ModuleName);
+        if (!Entry)
+            return false;
+
+        if (Entry->RawSize == 0)
+        {
+            OutData = (const char*)Data + Entry->DataOffset;
+            OutSize = Entry->DataSize;
+            return true;
+        }
+
+        Scratch.SetNumUninitialized(Entry->RawSize);
+        if (!FCompression::UncompressMemory(NAME_Zlib, Scratch.GetData(), Entry->RawSize, Data + Entry->DataOffset, Entry->DataSize))
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("failed to uncompress '%s' in script archive %s"), UTF8_TO_TCHAR(ModuleName), *FilePath);
+            return false;
+        }
+        OutData = (const char*)Scratch.GetData();
+        OutSize = Scratch.Num();
+        return true;
+    }
+}
@@ -0,0 +1,541 @@
+﻿// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "LuaSharedData.h"
+#include "Misc/Crc.h"
+#include "Misc/ScopeLock.h"
+#include "UnLuaSettings.h"
+
+namespace UnLua
+{
+    static const char* PROXY_METATABLE = "UnLuaSharedData";
+    static const char* PROXY_CACHE_KEY = "UnLua_SharedDataProxies";
+
+    struct FSharedValue
+    {
+        uint8 Type = LUA_TNIL; // LUA_TBOOLEAN, LUA_TNUMBER, LUA_TSTRING or LUA_TTABLE
+        bool bInteger = false;
+
+        union
+        {
+            bool Boolean;
+            lua_Integer Integer;
+            lua_Number Number;
+            int32 Index; // into FSharedModule::Strings or FSharedModule::Tables
+        };
+
+        FSharedValue() : Integer(0)
+        {
+        }
+    };
+
+    struct FSharedTable
+    {
+        TArray<FSharedValue> Array; // t[1] .. t[#t]
+        TArray<FSharedValue> Keys; // everything else, in pairs() order
+        TArray<FSharedValue> Values;
+        TMap<lua_Integer, int32> IntegerKeys; // key -> index into Keys
+        TMap<int32, int32> StringKeys; // string index -> index into Keys
+
+        SIZE_T GetAllocatedSize() const
+        {
+            return Array.GetAllocatedSize() + Keys.GetAllocatedSize() + Values.GetAllocatedSize()
+                + IntegerKeys.GetAllocatedSize() + StringKeys.GetAllocatedSize();
+        }
+    };
+
+    struct FSharedModule
+    {
+        TArray<FSharedTable> Tables; // Tables[0] is what the module returned
+        TArray<ANSICHAR> Chars;
+        TArray<TPair<int32, int32>> Strings; // offset into Chars and length, each string stored once
+        TMultiMap<uint32, int32> StringIndices; // crc -> index into Strings
+
+        int32 FindString(const char* String, const int32 Len) const
+        {
+            for (auto It = StringIndices.CreateConstKeyIterator(FCrc::MemCrc32(String, Len)); It; ++It)
+            {
+                const auto& Entry = Strings[It.Value()];
+                if (Entry.Value == Len && FMemory::Memcmp(Chars.GetData() + Entry.Key, String, Len) == 0)
+                    return It.Value();
+            }
+            return INDEX_NONE;
+        }
+
+        int32 AddString(const char* String, const int32 Len)
+        {
+            int32 Index = FindString(String, Len);
+            if (Index != INDEX_NONE)
+                return Index;
+            Index = Strings.Emplace(Chars.Num(), Len);
+            Chars.Append(String, Len);
+            StringIndices.Add(FCrc::MemCrc32(String, Len), Index);
+            return Index;
+        }
+
+        SIZE_T GetAllocatedSize() const
+        {
+            SIZE_T Size = sizeof(*this) + Tables.GetAllocatedSize() + Chars.GetAllocatedSize()
+                + Strings.GetAllocatedSize() + StringIndices.GetAllocatedSize();
+            for (const auto& Table : Tables)
+                Size += Table.GetAllocatedSize();
+            return Size;
+        }
+    };
+
+    struct FSharedProxy
+    {
+        TSharedPtr<const FSharedModule, ESPMode::ThreadSafe> Module;
+        int32 Table;
+    };
+
+    static FCriticalSection ModulesLock;
+    static TMap<FString, TWeakPtr<const FSharedModule, ESPMode::ThreadSafe>> Modules;
+
+    /** Flattens the lua table on the top of the stack, reports unsupported data in Error instead of raising so no destructor is skipped */
+    class FSharedModuleBuilder
+    {
+    public:
+        FSharedModuleBuilder(lua_State* L, FSharedModule& Module)
+            : L(L), Module(Module)
+        {
+        }
+
+        bool AddTable(int32& OutIndex, FString& Error)
+        {
+            const void* Ptr = lua_topointer(L, -1);
+            if (const auto Found = Visited.Find(Ptr))
+            {
+                OutIndex = *Found;
+                return true;
+            }
+
+            if (!lua_checkstack(L, 4))
+            {
+                Error = TEXT("tables nested too deep");
+                return false;
+            }
+
+            OutIndex = Module.Tables.AddDefaulted();
+            Visited.Add(Ptr, OutIndex);
+
+            // Module.Tables may grow while children are added, fill a local copy and move it in at the end
+            FSharedTable Table;
+            const lua_Integer Len = (lua_Integer)lua_rawlen(L, -1);
+            Table.Array.Reserve((int32)Len);
+            for (lua_Integer i = 1; i <= Len; i++)
+            {
+                lua_rawgeti(L, -1, i);
+                FSharedValue Value;
+                const bool bAdded = AddValue(Value, Error);
+                lua_pop(L, 1);
+                if (!bAdded)
+                    return false;
+                Table.Array.Add(Value);
+            }
+
+            lua_pushnil(L);
+            while (lua_next(L, -2))
+            {
+                FSharedValue Key;
+                const int KeyType = lua_type(L, -2);
+                if (KeyType == LUA_TNUMBER && lua_isinteger(L, -2))
+                {
+                    const lua_Integer Integer = lua_tointeger(L, -2);
+                    if (Integer >= 1 && Integer <= Len)
+                    {
+                        lua_pop(L, 1);
+                        continue;
+                    }
+                    Key.Type = LUA_TNUMBER;
+                    Key.bInteger = true;
+                    Key.Integer = Integer;
+                    Table.IntegerKeys.Add(Integer, Table.Keys.Num());
+                }
+                else if (KeyType == LUA_TSTRING)
+                {
+                    size_t KeyLen;
+                    const char* String = lua_tolstring(L, -2, &KeyLen);
+                    Key.Type = LUA_TSTRING;
+                    Key.Index = Module.AddString(String, (int32)KeyLen);
+                    Table.StringKeys.Add(Key.Index, Table.Keys.Num());
+                }
+                else
+                {
+                    Error = FString::Printf(TEXT("unsupported key type '%s'"), UTF8_TO_TCHAR(lua_typename(L, KeyType)));
+                    lua_pop(L, 2);
+                    return false;
+                }
+
+                FSharedValue Value;
+                const bool bAdded = AddValue(Value, Error);
+                lua_pop(L, 1);
+                if (!bAdded)
+                {
+                    lua_pop(L, 1);
+                    return false;
+                }
+                Table.Keys.Add(Key);
+                Table.Values.Add(Value);
+            }
+
+            Table.Array.Shrink();
+            Table.Keys.Shrink();
+            Table.Values.Shrink();
+            Table.IntegerKeys.Shrink();
+            Table.StringKeys.Shrink();
+            Module.Tables[OutIndex] = MoveTemp(Table);
+            return true;
+        }
+
+    private:
+        bool AddValue(FSharedValue& Value, FString& Error)
+        {
+            const int Type = lua_type(L, -1);
+            Value.Type = (uint8)Type;
+            switch (Type)
+            {
+            case LUA_TBOOLEAN:
+                Value.Boolean = !!lua_toboolean(L, -1);
+                return true;
+            case LUA_TNUMBER:
+                Value.bInteger = !!lua_isinteger(L, -1);
+                if (Value.bInteger)
+                    Value.Integer = lua_tointeger(L, -1);
+                else
+                    Value.Number = lua_tonumber(L, -1);
+                return true;
+            case LUA_TSTRING:
+                {
+                    size_t Len;
+                    const char* String = lua_tolstring(L, -1, &Len);
+                    Value.Index = Module.AddString(String, (int32)Len);
+                    return true;
+                }
+            case LUA_TTABLE:
+                return AddTable(Value.Index, Error);
+            default:
+                Error = FString::Printf(TEXT("unsupported value type '%s'"), UTF8_TO_TCHAR(lua_typename(L, Type)));
+                return false;
+            }
+        }
+
+        lua_State* L;
+        FSharedModule& Module;
+        TMap<const void*, int32> Visited;
+    };
+
+    static void PushTable(lua_State* L, const TSharedPtr<const FSharedModule, ESPMode::ThreadSafe>& Module, const int32 Table);
+
+    static void PushValue(lua_State* L, const TSharedPtr<const FSharedModule, ESPMode::ThreadSafe>& Module, const FSharedValue& Value)
+    {
+        switch (Value.Type)
+        {
+        case LUA_TBOOLEAN:
+            lua_pushboolean(L, Value.Boolean);
+            break;
+        case LUA_TNUMBER:
+            if (Value.bInteger)
+                lua_pushinteger(L, Value.Integer);
+            else
+                lua_pushnumber(L, Value.Number);
+            break;
+        case LUA_TSTRING:
+            {
+                const auto& Entry = Module->Strings[Value.Index];
+                lua_pushlstring(L, Module->Chars.GetData() + Entry.Key, Entry.Value);
+                break;
+            }
+        case LUA_TTABLE:
+            PushTable(L, Module, Value.Index);
+            break;
+        default:
+            lua_pushnil(L);
+        }
+    }
+
+    static const FSharedValue* FindValue(lua_State* L, const FSharedModule& Module, const FSharedTable& Table, const int KeyIndex)
+    {
+        const int KeyType = lua_type(L, KeyIndex);
+        if (KeyType == LUA_TNUMBER)
+        {
+            int IsInteger;
+            const lua_Integer Integer = lua_tointegerx(L, KeyIndex, &IsInteger);
+            if (!IsInteger)
+                return nullptr;
+            if (Integer >= 1 && Integer <= Table.Array.Num())
+                return &Table.Array[(int32)Integer - 1];
+            const auto Found = Table.IntegerKeys.Find(Integer);
+            return Found ? &Table.Values[*Found] : nullptr;
+        }
+
+        if (KeyType == LUA_TSTRING)
+        {
+            size_t Len;
+            const char* String = lua_tolstring(L, KeyIndex, &Len);
+            const int32 StringIndex = Module.FindString(String, (int32)Len);
+            if (StringIndex == INDEX_NONE)
+                return nullptr;
+            const auto Found = Table.StringKeys.Find(StringIndex);
+            return Found ? &Table.Values[*Found] : nullptr;
+        }
+
+        return nullptr;
+    }
+
+    static FSharedProxy& CheckProxy(lua_State* L, const int Index)
+    {
+        return *(FSharedProxy*)luaL_checkudata(L, Index, PROXY_METATABLE);
+    }
+
+    static int Proxy_Index(lua_State* L)
+    {
+        const auto& Proxy = CheckProxy(L, 1);
+        const auto& Table = Proxy.Module->Tables[Proxy.Table];
+        if (const auto Value = FindValue(L, *Proxy.Module, Table, 2))
+            PushValue(L, Proxy.Module, *Value);
+        else
+            lua_pushnil(L);
+        return 1;
+    }
+
+    static int Proxy_NewIndex(lua_State* L)
+    {
+        return luaL_error(L, "attempt to modify shared data");
+    }
+
+    static int Proxy_Len(lua_State* L)
+    {
+        const auto& Proxy = CheckProxy(L, 1);
+        lua_pushinteger(L, Proxy.Module->Tables[Proxy.Table].Array.Num());
+        return 1;
+    }
+
+    /** next() for proxies: the array part first, then the other keys in the order they were flattened */
+    static int Proxy_Next(lua_State* L)
+    {
+        const auto& Proxy = CheckProxy(L, 1);
+        const auto& Table = Proxy.Module->Tables[Proxy.Table];
+        const int32 ArrayNum = Table.Array.Num();
+
+        int32 Position = 0;
+        if (!lua_isnoneornil(L, 2))
+        {
+            int IsInteger = 0;
+            const lua_Integer Integer = lua_type(L, 2) == LUA_TNUMBER ? lua_tointegerx(L, 2, &IsInteger) : 0;
+            if (IsInteger && Integer >= 1 && Integer <= ArrayNum)
+            {
+                Position = (int32)Integer;
+            }
+            else
+            {
+                const int32* KeyIndex = nullptr;
+                if (IsInteger)
+                {
+                    KeyIndex = Table.IntegerKeys.Find(Integer);
+                }
+                else if (lua_type(L, 2) == LUA_TSTRING)
+                {
+                    size_t Len;
+                    const char* String = lua_tolstring(L, 2, &Len);
+                    const int32 StringIndex = Proxy.Module->FindString(String, (int32)Len);
+                    KeyIndex = StringIndex == INDEX_NONE ? nullptr : Table.StringKeys.Find(StringIndex);
+                }
+                if (!KeyIndex)
+                    return luaL_error(L, "invalid key to 'next'");
+                Position = ArrayNum + *KeyIndex + 1;
+            }
+        }
+
+        if (Position < ArrayNum)
+        {
+            lua_pushinteger(L, Position + 1);
+            PushValue(L, Proxy.Module, Table.Array[Position]);
+            return 2;
+        }
+
+        const int32 KeyIndex = Position - ArrayNum;
+        if (KeyIndex < Table.Keys.Num())
+        {
+            PushValue(L, Proxy.Module, Table.Keys[KeyIndex]);
+            PushValue(L, Proxy.Module, Table.Values[KeyIndex]);
+            return 2;
+        }
+
+        lua_pushnil(L);
+        return 1;
+    }
+
+    static int Proxy_Pairs(lua_State* L)
+    {
+        CheckProxy(L, 1);
+        lua_pushcfunction(L, Proxy_Next);
+        lua_pushvalue(L, 1);
+        lua_pushnil(L);
+        return 3;
+    }
+
+    static int Proxy_GC(lua_State* L)
+    {
+        auto& Proxy = CheckProxy(L, 1);
+        Proxy.~FSharedProxy();
+        return 0;
+    }
+
+    static constexpr luaL_Reg Proxy_Functions[] = {
+        {"__index", Proxy_Index},
+        {"__newindex", Proxy_NewIndex},
+        {"__len", Proxy_Len},
+        {"__pairs", Proxy_Pairs},
+        {"__gc", Proxy_GC},
+        {NULL, NULL}
+    };
+
+    /** Proxies are cached per lua env so the same shared table always has the same proxy */
+    static void PushTable(lua_State* L, const TSharedPtr<const FSharedModule, ESPMode::ThreadSafe>& Module, const int32 Table)
+    {
+        if (lua_getfield(L, LUA_REGISTRYINDEX, PROXY_CACHE_KEY) == LUA_TNIL)
+        {
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_newtable(L);
+            lua_pushstring(L, "v");
+            lua_setfield(L, -2, "__mode");
+            lua_setmetatable(L, -2);
+            lua_pushvalue(L, -1);
+            lua_setfield(L, LUA_REGISTRYINDEX, PROXY_CACHE_KEY);
+        }
+
+        const void* Key = &Module->Tables[Table];
+        if (lua_rawgetp(L, -1, Key) != LUA_TNIL)
+        {
+            lua_remove(L, -2);
+            return;
+        }
+        lua_pop(L, 1);
+
+        const auto Proxy = new(lua_newuserdata(L, sizeof(FSharedProxy))) FSharedProxy;
+        Proxy->Module = Module;
+        Proxy->Table = Table;
+        if (luaL_newmetatable(L, PROXY_METATABLE))
+            luaL_setfuncs(L, Proxy_Functions, 0);
+        lua_setmetatable(L, -2);
+
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, -3, Key);
+        lua_remove(L, -2);
+    }
+
+    /** Runs the module through the searchers after this one, pushes what it returned */
+    static bool RunModule(lua_State* L, const char* Name)
+    {
+        lua_getglobal(L, "package");
+        lua_getfield(L, -1, "searchers");
+        lua_remove(L, -2);
+        const lua_Integer Num = (lua_Integer)lua_rawlen(L, -1);
+        for (lua_Integer i = 1; i <= Num; i++)
+        {
+            lua_rawgeti(L, -1, i);
+            if (lua_tocfunction(L, -1) == FLuaSharedData::Searcher)
+            {
+                lua_pop(L, 1);
+                continue;
+            }
+
+            lua_pushstring(L, Name);
+            lua_call(L, 1, 2);
+            if (!lua_isfunction(L, -2))
+            {
+                lua_pop(L, 2);
+                continue;
+            }
+
+            lua_remove(L, -3);
+            lua_pushstring(L, Name);
+            lua_insert(L, -2);
+            lua_call(L, 2, 1);
+            return true;
+        }
+        lua_pop(L, 1);
+        return false;
+    }
+
+    static int LoadSharedModule(lua_State* L)
+    {
+        // the first upvalue is left free, UnLua.HotReload replaces it with a sandbox env like it does for lua chunks
+        lua_pushvalue(L, lua_upvalueindex(2));
+        return 1;
+    }
+
+    int FLuaSharedData::Searcher(lua_State* L)
+    {
+        const char* Name = luaL_checkstring(L, 1);
+        const FString ModuleName = UTF8_TO_TCHAR(Name);
+        if (!GetDefault<UUnLuaSettings>()->SharedDataModules.Contains(ModuleName))
+            return 0;
+
+        TSharedPtr<const FSharedModule, ESPMode::ThreadSafe> Module;
+        {
+            FScopeLock Lock(&ModulesLock);
+            if (const auto Found = Modules.Find(ModuleName))
+                Module = Found->Pin();
+        }
+
+        if (!Module)
+        {
+            if (!RunModule(L, Name))
+                return 0;
+
+            if (!lua_istable(L, -1))
+                return luaL_error(L, "shared data module '%s' must return a table", Name);
+
+            FString Error;
+            {
+                const auto NewModule = MakeShared<FSharedModule, ESPMode::ThreadSafe>();
+                int32 Root;
+                if (FSharedModuleBuilder(L, *NewModule).AddTable(Root, Error))
+                {
+                    NewModule->Tables.Shrink();
+                    NewModule->Chars.Shrink();
+                    NewModule->Strings.Shrink();
+                    NewModule->StringIndices.Shrink();
+                    Module = NewModule;
+                }
+            }
+            lua_pop(L, 1);
+            if (!Module)
+                return luaL_error(L, "failed to load shared data module '%s': %s", Name, TCHAR_TO_UTF8(*Error));
+
+            FScopeLock Lock(&ModulesLock);
+            Modules.Add(ModuleName, Module);
+        }
+
+        lua_pushnil(L);
+        PushTable(L, Module, 0);
+        lua_pushcclosure(L, LoadSharedModule, 2);
+        return 1;
+    }
+
+    SIZE_T FLuaSharedData::GetAllocatedSize()
+    {
+        FScopeLock Lock(&ModulesLock);
+        SIZE_T Size = 0;
+        for (const auto& Pair : Modules)
+        {
+            if (const auto Module = Pair.Value.Pin())
+                Size += Module->GetAllocatedSize();
+        }
+        return Size;
+    }
+}
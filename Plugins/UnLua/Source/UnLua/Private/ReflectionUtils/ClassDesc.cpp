@@ -105,9 +105,9 @@
 
 // ### **6. 默认参数处理**
 // ```cpp
-// FunctionCollection = GDefaultParamCollection.Find(*ClassName);
+// FunctionCollection = FindDefaultParamCollection(*ClassName);
 // ```
-// - **数据源**：`GDefaultParamCollection` 存储预生成的函数默认参数
+// - **数据源**：预生成的常量默认参数表，类第一次注册时二分查找并构建默认值
 // - **绑定时机**：在类描述初始化时关联，加速运行时参数解析
 
 // ---
@@ -209,7 +209,7 @@ FClassDesc::FClassDesc(UnLua::FLuaEnv* Env, UStruct* InStruct, const FString& In
     if (bIsClass)
     {
         Size = Struct->GetStructureSize();
-        FunctionCollection = GDefaultParamCollection.Find(*ClassName);
+        FunctionCollection = FindDefaultParamCollection(*ClassName);
     }
     else if (bIsScriptStruct)
     {
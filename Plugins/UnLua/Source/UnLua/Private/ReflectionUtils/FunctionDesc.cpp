@@ -29,8 +29,8 @@
  * Function descriptor constructor
  */
 FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefaultParams)
-    : DefaultParams(InDefaultParams), ReturnPropertyIndex(INDEX_NONE), LatentPropertyIndex(INDEX_NONE)
-    , bStaticFunc(false), bInterfaceFunc(false)
+    : ReturnPropertyIndex(INDEX_NONE), LatentPropertyIndex(INDEX_NONE)
+    , bStaticFunc(false), bInterfaceFunc(false), bHasDefaultParams(InDefaultParams != nullptr)
 {
     check(InFunction);
 
@@ -52,6 +52,7 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
 
     static const FName NAME_LatentInfo = TEXT("LatentInfo");
     Properties.Reserve(InFunction->NumParms);
+    TArray<int32, TInlineAllocator<16>> ParamPropertyIndices;          // property index of each parameter, the return value excluded
     for (TFieldIterator<FProperty> It(InFunction); It && (It->PropertyFlags & CPF_Parm); ++It)
     {
         FProperty *Property = *It;
@@ -60,8 +61,10 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
         if (PropertyDesc->IsReturnParameter())
         {
             ReturnPropertyIndex = Index;                                // return property
+            continue;
         }
-        else if (LatentPropertyIndex == INDEX_NONE && Property->GetFName() == NAME_LatentInfo)
+        ParamPropertyIndices.Add(Index);
+        if (LatentPropertyIndex == INDEX_NONE && Property->GetFName() == NAME_LatentInfo)
         {
             LatentPropertyIndex = Index;                                // 'LatentInfo' property for latent function
         }
@@ -73,6 +76,20 @@ FFunctionDesc::FFunctionDesc(UFunction *InFunction, FParameterCollection *InDefa
             }
         }
     }
+
+    if (!InDefaultParams)
+        return;
+
+    // resolve the default values once, fall back to the name when the generated index no longer matches the signature
+    DefaultValues.SetNumZeroed(Properties.Num());
+    for (const FDefaultParameter& Param : InDefaultParams->Parameters)
+    {
+        int32 Index = ParamPropertyIndices.IsValidIndex(Param.Index) ? ParamPropertyIndices[Param.Index] : INDEX_NONE;
+        if (Index == INDEX_NONE || Properties[Index]->GetProperty()->GetFName() != Param.Name)
+            Index = Properties.IndexOfByPredicate([&Param](const TUniquePtr<FPropertyDesc>& Property) { return Property->GetProperty()->GetFName() == Param.Name; });
+        if (Index != INDEX_NONE)
+            DefaultValues[Index] = &Param.Value;
+    }
 }
 
 void FFunctionDesc::CallLua(lua_State* L, lua_Integer FunctionRef, lua_Integer SelfRef, FFrame& Stack, RESULT_DECL)
@@ -320,13 +337,11 @@ void FFunctionDesc::PreCall(lua_State* L, int32 NumParams, int32 FirstParamIndex
         }
         else if (!Property->IsOutParameter())
         {
-            if (DefaultParams)
+            if (bHasDefaultParams)
             {
                 // set value for default parameter
-                IParamValue **DefaultValue = DefaultParams->Parameters.Find(Property->GetProperty()->GetFName());
-                if (DefaultValue)
+                if (const void* ValuePtr = DefaultValues[i])
                 {
-                    const void *ValuePtr = (*DefaultValue)->GetValue();
                     Property->CopyValue(Params, ValuePtr);
                     CleanupFlags[i] = true;
                 }
@@ -120,11 +120,12 @@ private:
     TSharedPtr<FParamBufferAllocator> Buffer;
     TArray<TUniquePtr<FPropertyDesc>> Properties;
     TArray<int32> OutPropertyIndices;
-    FParameterCollection *DefaultParams;
+    TArray<const void*> DefaultValues; // default value of each property, null if it has none
     int32 ReturnPropertyIndex;
     int32 LatentPropertyIndex;
     uint8 bStaticFunc : 1;
     uint8 bInterfaceFunc : 1;
+    uint8 bHasDefaultParams : 1;
     int32 ParmsSize;
     TUniquePtr<FTCHARToUTF8> LuaFunctionName;
 };
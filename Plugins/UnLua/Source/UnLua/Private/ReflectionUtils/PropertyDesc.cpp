@@ -871,7 +871,7 @@ public:
         FLuaArray *Array = (FLuaArray*)Userdata;
         int32 Index = Array->AddDefaulted();
         uint8 *Data = Array->GetData(Index);
-        Array->Inner->WriteValue_InContainer(L, Data, -1);
+        Array->InnerAccessor.WriteInContainer(L, Data, -1);
         return true;
     }
 
@@ -1007,8 +1007,8 @@ public:
         void *ValueCache = (uint8*)Map->ElementCache + Map->MapLayout.ValueOffset;
         Map->KeyInterface->Initialize(Map->ElementCache);
         Map->ValueInterface->Initialize(ValueCache);
-        Map->KeyInterface->WriteValue_InContainer(L, Map->ElementCache, -2);
-        Map->ValueInterface->WriteValue_InContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, -1);
+        Map->KeyAccessor.WriteInContainer(L, Map->ElementCache, -2);
+        Map->ValueAccessor.WriteInContainer(L, Map->ValueInterface->GetOffset() > 0 ? Map->ElementCache : ValueCache, -1);
         Map->Add(Map->ElementCache, ValueCache);
         return true;
     }
@@ -1143,7 +1143,7 @@ public:
     {
         FLuaSet *Set = (FLuaSet*)Userdata;
         Set->ElementInterface->Initialize(Set->ElementCache);
-        Set->ElementInterface->WriteValue_InContainer(L, Set->ElementCache, -1);
+        Set->ElementAccessor.WriteInContainer(L, Set->ElementCache, -1);
         Set->Add(Set->ElementCache);
         return true;
     }
@@ -62,6 +62,7 @@ namespace UnLua
         if (Ret)
         {
             Classes.FindOrAdd(Ret->AsStruct(), Ret);
+            Env->MarkObjectTracked(Ret->AsStruct());
             return Ret;
         }
 
@@ -98,6 +99,7 @@ namespace UnLua
         if (Exists)
         {
             Classes.Add(Type, *Exists);
+            Env->MarkObjectTracked(Type);
             return *Exists;
         }
 
@@ -307,6 +309,7 @@ namespace UnLua
         FClassDesc* ClassDesc = new FClassDesc(Env, Type, Name);
         Classes.Add(Type, ClassDesc);
         Name2Classes.Add(FName(*Name), ClassDesc);
+        Env->MarkObjectTracked(Type);
 
         return ClassDesc;
     }
@@ -16,6 +16,7 @@
 #include "LowLevel.h"
 #include "LuaCore.h"
 #include "LuaEnv.h"
+#include "UnLuaCompatibility.h"
 
 namespace UnLua
 {
@@ -33,6 +34,15 @@ namespace UnLua
 
     FLuaArray* FContainerRegistry::NewArray(lua_State* L, TSharedPtr<ITypeInterface> ElementType, FLuaArray::EScriptArrayFlag Flag)
     {
+        if (Flag == FLuaArray::OwnedBySelf)
+        {
+            void* ScriptArray;
+            void* ElementCache;
+            const FContainerType& Type = FindOrAddType(ElementType);
+            void* Userdata = NewUserdata(L, FScriptContainerDesc::Array, sizeof(FScriptArray), Type, ScriptArray, ElementCache);
+            return new(Userdata) FLuaArray(Type, ScriptArray, ElementCache);
+        }
+
         const FScriptArray* ScriptArray = new FScriptArray;
         void* Userdata = NewUserdata(L, FScriptContainerDesc::Array);
         const auto Ret = new(Userdata) FLuaArray(ScriptArray, ElementType, Flag);
@@ -41,6 +51,15 @@ namespace UnLua
 
     FLuaSet* FContainerRegistry::NewSet(lua_State* L, TSharedPtr<ITypeInterface> ElementType, FLuaSet::FScriptSetFlag Flag)
     {
+        if (Flag == FLuaSet::OwnedBySelf)
+        {
+            void* ScriptSet;
+            void* ElementCache;
+            const FContainerType& Type = FindOrAddType(ElementType);
+            void* Userdata = NewUserdata(L, FScriptContainerDesc::Set, sizeof(FScriptSet), Type, ScriptSet, ElementCache);
+            return new(Userdata) FLuaSet(Type, ScriptSet, ElementCache);
+        }
+
         const FScriptSet* ScriptSet = new FScriptSet;
         void* Userdata = NewUserdata(L, FScriptContainerDesc::Set);
         const auto Ret = new(Userdata) FLuaSet(ScriptSet, ElementType, Flag); 
@@ -49,6 +68,15 @@ namespace UnLua
 
     FLuaMap* FContainerRegistry::NewMap(lua_State* L, TSharedPtr<ITypeInterface> KeyType, TSharedPtr<ITypeInterface> ValueType, FLuaMap::FScriptMapFlag Flag)
     {
+        if (Flag == FLuaMap::OwnedBySelf)
+        {
+            void* ScriptMap;
+            void* ElementCache;
+            const FContainerType& Type = FindOrAddType(KeyType, ValueType);
+            void* Userdata = NewUserdata(L, FScriptContainerDesc::Map, sizeof(FScriptMap), Type, ScriptMap, ElementCache);
+            return new(Userdata) FLuaMap(Type, ScriptMap, ElementCache);
+        }
+
         const FScriptMap* ScriptMap = new FScriptMap;
         void* Userdata = NewUserdata(L, FScriptContainerDesc::Map);
         const auto Ret = new(Userdata) FLuaMap(ScriptMap, KeyType, ValueType, Flag);
@@ -109,10 +137,96 @@ namespace UnLua
         RemoveCachedScriptContainer(L, Container->GetContainerPtr());
     }
 
+    const FContainerType& FContainerRegistry::FindOrAddType(const TSharedPtr<ITypeInterface>& ElementType, const TSharedPtr<ITypeInterface>& ValueType)
+    {
+        const FTypeKey Key(ElementType.Get(), ValueType.Get());
+        if (const auto Exists = Types.Find(Key))
+            return *Exists;
+
+        FContainerType Type;
+        Type.Inner = ElementType;
+        Type.Extra = ValueType;
+        Type.InnerAccessor = FContainerElementAccessor(ElementType);
+        Type.ExtraAccessor = FContainerElementAccessor(ValueType);
+        if (ValueType)
+        {
+            FStructBuilder StructBuilder;
+            StructBuilder.AddMember(ElementType->GetSize(), ElementType->GetAlignment());
+            StructBuilder.AddMember(ValueType->GetSize(), ValueType->GetAlignment());
+            Type.ElementCacheSize = StructBuilder.GetSize();
+            Type.ElementCacheAlignment = StructBuilder.GetAlignment();
+        }
+        else
+        {
+            Type.ElementCacheSize = ElementType->GetSize();
+            Type.ElementCacheAlignment = ElementType->GetAlignment();
+        }
+
+        TrackOwner(ElementType.Get(), Key);
+        if (ValueType)
+            TrackOwner(ValueType.Get(), Key);
+        return Types.Add(Key, MoveTemp(Type));
+    }
+
+    void FContainerRegistry::NotifyTypeRemoved(const ITypeInterface* Type)
+    {
+        for (auto It = Types.CreateIterator(); It; ++It)
+        {
+            if (It.Key().Key == Type || It.Key().Value == Type)
+                It.RemoveCurrent();
+        }
+
+        for (auto It = TypesOfOwner.CreateIterator(); It; ++It)
+        {
+            if (It.Value().Key == Type || It.Value().Value == Type)
+                It.RemoveCurrent();
+        }
+    }
+
+    void FContainerRegistry::NotifyUObjectDeleted(const UObject* Object)
+    {
+        TArray<FTypeKey> Keys;
+        TypesOfOwner.MultiFind(Object, Keys);
+        if (Keys.Num() == 0)
+            return;
+
+        TypesOfOwner.Remove(Object);
+        for (const auto& Key : Keys)
+            Types.Remove(Key);
+    }
+
+    void FContainerRegistry::TrackOwner(const ITypeInterface* Type, const FTypeKey& Key)
+    {
+        // properties die with the struct or function declaring them, types made up from lua go through NotifyTypeRemoved
+        const FProperty* Property = Type->GetUProperty();
+        if (!Property)
+            return;
+
+        UObject* Owner = GetPropertyOuter(Property);
+        if (!Owner || Owner == Env->GetPropertyRegistry()->GetPropertyCollector())
+            return;
+
+        TypesOfOwner.AddUnique(Owner, Key);
+        Env->MarkObjectTracked(Owner);
+    }
+
     void* FContainerRegistry::NewUserdata(lua_State* L, const FScriptContainerDesc& Desc)
     {
         void* Userdata = NewUserdataWithContainerTag(L, Desc.GetSize());
         luaL_setmetatable(L, Desc.GetName());
         return Userdata;
     }
+
+    void* FContainerRegistry::NewUserdata(lua_State* L, const FScriptContainerDesc& Desc, int32 ScriptContainerSize, const FContainerType& Type, void*& OutScriptContainer, void*& OutElementCache)
+    {
+        static_assert(alignof(FScriptArray) <= alignof(FLuaArray) && alignof(FScriptSet) <= alignof(FLuaSet) && alignof(FScriptMap) <= alignof(FLuaMap), "script containers must fit right behind their wrappers");
+
+        // userdata are only aligned for lua_Number, so leave room to align the element cache ourselves
+        const int32 Alignment = FMath::Max(Type.ElementCacheAlignment, 1);
+        uint8* Userdata = (uint8*)NewUserdataWithContainerTag(L, Desc.GetSize() + ScriptContainerSize + Type.ElementCacheSize + Alignment - 1);
+        luaL_setmetatable(L, Desc.GetName());
+        OutScriptContainer = Userdata + Desc.GetSize();
+        OutElementCache = Align(Userdata + Desc.GetSize() + ScriptContainerSize, Alignment);
+        return Userdata;
+    }
 }
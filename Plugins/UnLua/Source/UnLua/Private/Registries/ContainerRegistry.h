@@ -46,11 +46,40 @@ namespace UnLua
         void Remove(const FLuaSet* Container);
 
         void Remove(const FLuaMap* Container);
+
+        /**
+         * Find the shared description of containers with these element types, ValueType is only set for maps
+         */
+        const FContainerType& FindOrAddType(const TSharedPtr<ITypeInterface>& ElementType, const TSharedPtr<ITypeInterface>& ValueType = nullptr);
+
+        /**
+         * Forget the descriptions using a type interface that is going away
+         */
+        void NotifyTypeRemoved(const ITypeInterface* Type);
+
+        /**
+         * Forget the descriptions using inner properties of a struct or function that is going away
+         */
+        void NotifyUObjectDeleted(const UObject* Object);
         
     private:
+        typedef TPair<const ITypeInterface*, const ITypeInterface*> FTypeKey;
+
+        /**
+         * Remember the struct or function owning the property behind a type interface, if any
+         */
+        void TrackOwner(const ITypeInterface* Type, const FTypeKey& Key);
+
         static void* NewUserdata(lua_State* L, const FScriptContainerDesc& Desc);
 
+        /**
+         * Create a userdata holding a container, followed by its script container and its element cache
+         */
+        static void* NewUserdata(lua_State* L, const FScriptContainerDesc& Desc, int32 ScriptContainerSize, const FContainerType& Type, void*& OutScriptContainer, void*& OutElementCache);
+
         int MapRef;
         FLuaEnv* Env;
+        TMap<FTypeKey, FContainerType> Types;
+        TMultiMap<const UObject*, FTypeKey> TypesOfOwner;
     };
 }
@@ -0,0 +1,310 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "DataTableRegistry.h"
+#include "LuaCore.h"
+#include "LuaEnv.h"
+#include "LowLevel.h"
+#include "UnLuaPrivate.h"
+#include "ReflectionUtils/ClassDesc.h"
+#include "ReflectionUtils/FieldDesc.h"
+#include "ReflectionUtils/PropertyDesc.h"
+
+namespace UnLua
+{
+    FDataTableRegistry::FDataTableRegistry(FLuaEnv* Env)
+        : Env(Env)
+    {
+    }
+
+    FDataTableRegistry::~FDataTableRegistry()
+    {
+        // the lua state is already closed, along with the row references and caches
+        for (const auto& Pair : Tables)
+        {
+            Pair.Value->Table->OnDataTableChanged().Remove(Pair.Value->ChangedHandle);
+            delete Pair.Value;
+        }
+    }
+
+    void FDataTableRegistry::PushRow(lua_State* L, UDataTable* Table, const FName RowName)
+    {
+        FTableDesc* Desc = Register(Table);
+        uint8* RowPtr = Table->FindRowUnchecked(RowName);
+        if (!RowPtr)
+        {
+            lua_pushnil(L);
+            return;
+        }
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, Desc->CacheRef);
+        PushRowRef(L, Desc, RowPtr);
+        lua_remove(L, -2);
+    }
+
+    void FDataTableRegistry::PushRowCopy(lua_State* L, UDataTable* Table, const FName RowName)
+    {
+        const FTableDesc* Desc = Register(Table);
+        const uint8* RowPtr = Table->FindRowUnchecked(RowName);
+        if (!RowPtr || !Desc->RowStruct)
+        {
+            lua_pushnil(L);
+            return;
+        }
+
+        // InitializeStruct runs the native constructor as well
+        void* Userdata = NewUserdataWithPadding(L, Desc->RowStruct->GetStructureSize(), Desc->MetatableName.GetData(), Desc->UserdataPadding);
+        if (Userdata)
+        {
+            Desc->RowStruct->InitializeStruct(Userdata);
+            Desc->RowStruct->CopyScriptStruct(Userdata, RowPtr);
+        }
+    }
+
+    void FDataTableRegistry::PushRows(lua_State* L, UDataTable* Table)
+    {
+        FTableDesc* Desc = Register(Table);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, Desc->CacheRef);
+        if (lua_getfield(L, -1, "Names") == LUA_TNIL)
+        {
+            lua_pop(L, 1);
+            const auto& RowMap = Table->GetRowMap();
+            lua_createtable(L, RowMap.Num(), 0);
+            lua_createtable(L, RowMap.Num(), 0);
+            int32 Index = 0;
+            for (const auto& Pair : RowMap)
+            {
+                Index++;
+                lua_pushstring(L, TCHAR_TO_UTF8(*Pair.Key.ToString()));
+                lua_rawseti(L, -3, Index);
+                lua_pushvalue(L, -3);
+                PushRowRef(L, Desc, Pair.Value);
+                lua_remove(L, -2);
+                lua_rawseti(L, -2, Index);
+            }
+            lua_setfield(L, -3, "Rows");
+            lua_pushvalue(L, -1);
+            lua_setfield(L, -3, "Names");
+        }
+        lua_getfield(L, -2, "Rows");
+        lua_pushinteger(L, 0);
+        lua_pushcclosure(L, RowsIterator, 3);
+        lua_remove(L, -2);
+    }
+
+    void FDataTableRegistry::PushColumn(lua_State* L, UDataTable* Table, const char* ColumnName)
+    {
+        FTableDesc* Desc = Register(Table);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, Desc->CacheRef);
+        lua_getfield(L, -1, "Columns");
+        if (lua_getfield(L, -1, ColumnName) != LUA_TNIL)
+        {
+            lua_replace(L, -3);
+            lua_pop(L, 1);
+            return;
+        }
+        lua_pop(L, 1);
+
+        // the name to index table RowIndex fills, so a field read both ways is only added to Fields once
+        int32 Index;
+        lua_getfield(L, -2, "Fields");
+        lua_pushstring(L, ColumnName);
+        if (lua_rawget(L, -2) == LUA_TNUMBER)
+        {
+            Index = (int32)lua_tointeger(L, -1);
+            lua_pop(L, 2);
+        }
+        else
+        {
+            lua_pop(L, 1);
+            Index = FindField(L, Desc, ColumnName);
+            lua_pushstring(L, ColumnName);
+            lua_pushinteger(L, Index);
+            lua_rawset(L, -3);
+            lua_pop(L, 1);
+        }
+        if (Index == 0)
+        {
+            luaL_error(L, "can't find column %s", ColumnName);
+            return;
+        }
+
+        const auto& Accessor = Desc->Fields[Index - 1].Accessor;
+        const auto& RowMap = Table->GetRowMap();
+        lua_createtable(L, 0, RowMap.Num());
+        for (const auto& Pair : RowMap)
+        {
+            lua_pushstring(L, TCHAR_TO_UTF8(*Pair.Key.ToString()));
+            Accessor.ReadInContainer(L, Pair.Value, true);
+            lua_rawset(L, -3);
+        }
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -3, ColumnName);
+        lua_replace(L, -3);
+        lua_pop(L, 1);
+    }
+
+    void FDataTableRegistry::NotifyUObjectDeleted(const UObject* Object)
+    {
+        FTableDesc* Desc;
+        if (!Tables.RemoveAndCopyValue((const UDataTable*)Object, Desc))
+            return;
+
+        for (const auto Userdata : Desc->RowRefs)
+            *(void**)Userdata = (void*)LowLevel::ReleasedPtr;
+        luaL_unref(Env->GetMainState(), LUA_REGISTRYINDEX, Desc->CacheRef);
+        delete Desc;
+    }
+
+    FDataTableRegistry::FTableDesc* FDataTableRegistry::Register(UDataTable* Table)
+    {
+        if (FTableDesc** Found = Tables.Find(Table))
+            return *Found;
+
+        const auto Desc = new FTableDesc;
+        Desc->Table = Table;
+        Desc->ChangedHandle = Table->OnDataTableChanged().AddRaw(this, &FDataTableRegistry::OnTableChanged, Table);
+        Reset(Desc);
+        Tables.Add(Table, Desc);
+        Env->MarkObjectTracked(Table);
+        return Desc;
+    }
+
+    void FDataTableRegistry::Reset(FTableDesc* Desc)
+    {
+        const auto L = Env->GetMainState();
+        for (const auto Userdata : Desc->RowRefs)
+            *(void**)Userdata = (void*)LowLevel::ReleasedPtr;
+        Desc->RowRefs.Reset();
+        Desc->Fields.Reset();
+        if (Desc->CacheRef != LUA_NOREF)
+            luaL_unref(L, LUA_REGISTRYINDEX, Desc->CacheRef);
+
+        // the row struct may change on reimport
+        Desc->RowStruct = Desc->Table->GetRowStruct();
+        const FTCHARToUTF8 MetatableName(*LowLevel::GetMetatableName(Desc->RowStruct));
+        Desc->MetatableName.Reset();
+        Desc->MetatableName.Append(MetatableName.Get(), MetatableName.Length() + 1);
+        Desc->UserdataPadding = LowLevel::CalculateUserdataPadding((UStruct*)Desc->RowStruct);
+
+        lua_createtable(L, 0, 6);
+        lua_newtable(L);
+        lua_setfield(L, -2, "Refs");
+        lua_newtable(L);
+        lua_setfield(L, -2, "Columns");
+        lua_newtable(L); // column name to index in Fields
+        lua_newtable(L); // metatable of the row references
+        lua_pushlightuserdata(L, Desc);
+        lua_pushvalue(L, -3);
+        lua_pushcclosure(L, RowIndex, 2);
+        lua_setfield(L, -2, "__index");
+        lua_pushcfunction(L, RowNewIndex);
+        lua_setfield(L, -2, "__newindex");
+        lua_setfield(L, -3, "Metatable");
+        lua_setfield(L, -2, "Fields");
+        Desc->CacheRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+
+    void FDataTableRegistry::OnTableChanged(UDataTable* Table)
+    {
+        if (FTableDesc** Desc = Tables.Find(Table))
+            Reset(*Desc);
+    }
+
+    int32 FDataTableRegistry::FindField(lua_State* L, FTableDesc* Desc, const char* Name)
+    {
+        if (!Desc->RowStruct)
+            return 0;
+
+        FClassDesc* ClassDesc = FLuaEnv::FindEnvChecked(L).GetClassRegistry()->Register(Desc->RowStruct);
+        if (!ClassDesc)
+            return 0;
+
+        const auto Field = ClassDesc->RegisterField(FName(UTF8_TO_TCHAR(Name)), ClassDesc);
+        if (!Field || !Field->IsValid())
+            return 0;
+
+        const auto Property = Field->AsProperty();
+        if (!Property)
+            return 0;
+
+        Desc->Fields.Add({Property, FContainerElementAccessor(Property)});
+        return Desc->Fields.Num();
+    }
+
+    void FDataTableRegistry::PushRowRef(lua_State* L, FTableDesc* Desc, uint8* RowPtr)
+    {
+        lua_getfield(L, -1, "Refs");
+        lua_pushlightuserdata(L, RowPtr);
+        if (lua_rawget(L, -2) == LUA_TNIL)
+        {
+            lua_pop(L, 1);
+            void* Userdata = NewUserdataWithTwoLvPtrTag(L, sizeof(void*), RowPtr);
+            lua_getfield(L, -3, "Metatable");
+            lua_setmetatable(L, -2);
+            lua_pushlightuserdata(L, RowPtr);
+            lua_pushvalue(L, -2);
+            lua_rawset(L, -4);
+            Desc->RowRefs.Add(Userdata);
+        }
+        lua_remove(L, -2);
+    }
+
+    int FDataTableRegistry::RowIndex(lua_State* L)
+    {
+        const uint8* RowPtr = *(uint8**)lua_touserdata(L, 1);
+        if (LowLevel::IsReleasedPtr(RowPtr))
+            return luaL_error(L, "attempt to read a row of a changed or unloaded data table");
+
+        lua_pushvalue(L, 2);
+        int32 Index;
+        if (lua_rawget(L, lua_upvalueindex(2)) == LUA_TNUMBER)
+        {
+            Index = (int32)lua_tointeger(L, -1);
+        }
+        else
+        {
+            if (lua_type(L, 2) != LUA_TSTRING)
+                return 0;
+            const auto Desc = (FTableDesc*)lua_touserdata(L, lua_upvalueindex(1));
+            Index = FindField(L, Desc, lua_tostring(L, 2));
+            lua_pushvalue(L, 2);
+            lua_pushinteger(L, Index);
+            lua_rawset(L, lua_upvalueindex(2));
+        }
+        if (Index == 0)
+            return 0;
+
+        const auto Desc = (FTableDesc*)lua_touserdata(L, lua_upvalueindex(1));
+        Desc->Fields[Index - 1].Accessor.ReadInContainer(L, RowPtr, true);
+        return 1;
+    }
+
+    int FDataTableRegistry::RowNewIndex(lua_State* L)
+    {
+        return luaL_error(L, "data table rows are read-only");
+    }
+
+    int FDataTableRegistry::RowsIterator(lua_State* L)
+    {
+        const int32 Index = (int32)lua_tointeger(L, lua_upvalueindex(3)) + 1;
+        if (lua_rawgeti(L, lua_upvalueindex(1), Index) == LUA_TNIL)
+            return 1;
+
+        lua_pushinteger(L, Index);
+        lua_replace(L, lua_upvalueindex(3));
+        lua_rawgeti(L, lua_upvalueindex(2), Index);
+        return 2;
+    }
+}
@@ -0,0 +1,96 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "lua.hpp"
+#include "Engine/DataTable.h"
+#include "Containers/LuaContainerElement.h"
+
+class FPropertyDesc;
+
+namespace UnLua
+{
+    class FLuaEnv;
+
+    /**
+     * 数据表的只读行引用。
+     *
+     * 行引用是指向表里行数据的二级指针userdata，读字段时按偏移直接从行里读，不再拷贝整个结构体，写字段会报错。
+     * 每个表缓存一份行引用、遍历用的行列表和按列名取出的整列数据。
+     * 表的内容变化（比如重新导入）或者表被卸载时，发出去的行引用全部失效，缓存随之清空。
+     */
+    class UNLUA_API FDataTableRegistry
+    {
+    public:
+        explicit FDataTableRegistry(FLuaEnv* Env);
+
+        ~FDataTableRegistry();
+
+        /** Push a reference to a row, nil if there is no such row */
+        void PushRow(lua_State* L, UDataTable* Table, FName RowName);
+
+        /** Push a copy of a row as a struct, nil if there is no such row */
+        void PushRowCopy(lua_State* L, UDataTable* Table, FName RowName);
+
+        /** Push an iterator over the names and references of all rows */
+        void PushRows(lua_State* L, UDataTable* Table);
+
+        /** Push a table of row name to the value of a column in that row */
+        void PushColumn(lua_State* L, UDataTable* Table, const char* ColumnName);
+
+        void NotifyUObjectDeleted(const UObject* Object);
+
+    private:
+        struct FField
+        {
+            TSharedPtr<FPropertyDesc> Property;
+            FContainerElementAccessor Accessor;
+        };
+
+        struct FTableDesc
+        {
+            UDataTable* Table;
+            const UScriptStruct* RowStruct;
+            TArray<ANSICHAR> MetatableName; // of the row struct, for copies
+            uint8 UserdataPadding;
+            TArray<FField> Fields;
+            TArray<void*> RowRefs; // released when the table changes, the cache keeps them alive until then
+            int32 CacheRef = LUA_NOREF; // { Refs, Fields, Columns, Metatable, Names, Rows }
+            FDelegateHandle ChangedHandle;
+        };
+
+        FTableDesc* Register(UDataTable* Table);
+
+        /** Release the row references of a table and start a new cache */
+        void Reset(FTableDesc* Desc);
+
+        void OnTableChanged(UDataTable* Table);
+
+        /** Resolve a column of the row struct, returns its index in Fields plus one, 0 if there is no such column */
+        static int32 FindField(lua_State* L, FTableDesc* Desc, const char* Name);
+
+        /** Push the reference to a row, the cache of the table needs to be on the top of the stack */
+        static void PushRowRef(lua_State* L, FTableDesc* Desc, uint8* RowPtr);
+
+        static int RowIndex(lua_State* L);
+
+        static int RowNewIndex(lua_State* L);
+
+        static int RowsIterator(lua_State* L);
+
+        FLuaEnv* Env;
+        TMap<const UDataTable*, FTableDesc*> Tables;
+    };
+}
@@ -70,6 +70,7 @@ namespace UnLua
 
         auto Ret = new FEnumDesc(Enum);
         Enums.Add(Enum, Ret);
+        Env->MarkObjectTracked(Enum);
         Name2Enums.Add(MetatableName, Ret);
 
         const auto L = Env->GetMainState();
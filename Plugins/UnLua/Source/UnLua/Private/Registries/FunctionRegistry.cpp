@@ -23,11 +23,19 @@ namespace UnLua
     {
         // TODO: refactor
         if (UNLIKELY(!Env->GetObjectRegistry()->IsBound(Context)))
+        {
             Env->TryBind(Context);
+            Env->GetManager()->BindDeferred(Context);
+        }
 
         const auto SelfRef = Env->GetObjectRegistry()->GetBoundRef(Context);
         check(SelfRef!=LUA_NOREF);
 
+        Invoke(Function, Context, SelfRef, Stack, RESULT_PARAM);
+    }
+
+    void FFunctionRegistry::Invoke(ULuaFunction* Function, UObject* Context, int32 SelfRef, FFrame& Stack, RESULT_DECL)
+    {
         const auto L = Env->GetMainState();
         lua_Integer FuncRef;
         FFunctionDesc* FuncDesc;
@@ -70,6 +78,7 @@ namespace UnLua
             Info.LuaRef = FuncRef;
             Info.Desc = TUniquePtr<FFunctionDesc>(FuncDesc);
             LuaFunctions.Add(Function, MoveTemp(Info));
+            Env->MarkObjectTracked(Function);
         }
 
         if (FuncRef == LUA_NOREF)
@@ -31,6 +31,9 @@ namespace UnLua
         
         void Invoke(ULuaFunction* Function, UObject* Context, FFrame& Stack, RESULT_DECL);
 
+        /** Invoke on an object already bound to this env, SelfRef being its instance ref. */
+        void Invoke(ULuaFunction* Function, UObject* Context, int32 SelfRef, FFrame& Stack, RESULT_DECL);
+
     private:
         struct FFunctionInfo
         {
@@ -44,6 +44,9 @@ namespace UnLua
         return 0;
     }
 
+    FObjectRegistry::FBoundRecord** FObjectRegistry::BoundRecordChunks = nullptr;
+    int32 FObjectRegistry::NumBoundRecordChunks = 0;
+
     FObjectRegistry::FObjectRegistry(FLuaEnv* Env)
         : Env(Env)
     {
@@ -70,6 +73,59 @@ namespace UnLua
         lua_pop(L, 2);
     }
 
+    FObjectRegistry::~FObjectRegistry()
+    {
+        // the objects may be freed by now so their index can't be read, find this env's records instead
+        int32 NumBound = 0;
+        for (const auto& Pair : ObjectRefs)
+        {
+            if (Pair.Value != LUA_NOREF)
+                ++NumBound;
+        }
+
+        for (int32 Chunk = 0; Chunk < NumBoundRecordChunks && NumBound > 0; ++Chunk)
+        {
+            FBoundRecord* Records = BoundRecordChunks[Chunk];
+            if (!Records)
+                continue;
+            for (int32 i = 0; i < BoundRecordsPerChunk && NumBound > 0; ++i)
+            {
+                if (Records[i].Env != Env)
+                    continue;
+                Records[i] = FBoundRecord();
+                --NumBound;
+            }
+        }
+    }
+
+    void FObjectRegistry::SetBoundRecord(const UObject* Object, const int32 SelfRef)
+    {
+        if (!BoundRecordChunks)
+        {
+            NumBoundRecordChunks = FMath::DivideAndRoundUp(GUObjectArray.GetObjectArrayCapacity(), BoundRecordsPerChunk);
+            BoundRecordChunks = new FBoundRecord*[NumBoundRecordChunks]();
+        }
+
+        const int32 Index = GUObjectArray.ObjectToIndex(Object);
+        const int32 Chunk = Index / BoundRecordsPerChunk;
+        if (Chunk >= NumBoundRecordChunks)
+            return;
+        if (!BoundRecordChunks[Chunk])
+            BoundRecordChunks[Chunk] = new FBoundRecord[BoundRecordsPerChunk];
+
+        auto& Record = BoundRecordChunks[Chunk][Index % BoundRecordsPerChunk];
+        Record.Env = Env;
+        Record.SelfRef = SelfRef;
+        Record.Object = Object;
+    }
+
+    void FObjectRegistry::ClearBoundRecord(const UObject* Object)
+    {
+        const auto Record = const_cast<FBoundRecord*>(FindBoundRecord(Object));
+        if (Record && Record->Env == Env)
+            *Record = FBoundRecord();
+    }
+
     void FObjectRegistry::NotifyUObjectDeleted(UObject* Object)
     {
         Unbind(Object);
@@ -97,7 +153,14 @@ namespace UnLua
 
         lua_getfield(L, LUA_REGISTRYINDEX, REGISTRY_KEY);
         lua_pushlightuserdata(L, Object);
-        const auto Type = lua_rawget(L, -2);
+        auto Type = lua_rawget(L, -2);
+        if (Type == LUA_TNIL && Env->Manager && Env->Manager->BindDeferred(Object))
+        {
+            // first use of a lazily bound object
+            lua_pop(L, 1);
+            lua_pushlightuserdata(L, Object);
+            Type = lua_rawget(L, -2);
+        }
         if (Type == LUA_TNIL)
         {
             lua_pop(L, 1);
@@ -106,6 +169,7 @@ namespace UnLua
             lua_pushvalue(L, -2);
             lua_rawset(L, -4);
             ObjectRefs.Add(Object, LUA_NOREF);
+            Env->MarkObjectTracked(Object);
         }
         lua_remove(L, -2);
     }
@@ -154,6 +218,8 @@ namespace UnLua
         lua_pushvalue(L, -1);
         const auto Ret = luaL_ref(L, LUA_REGISTRYINDEX);
         ObjectRefs.Add(Object, Ret);
+        SetBoundRecord(Object, Ret);
+        Env->MarkObjectTracked(Object);
 
         FUnLuaDelegates::OnObjectBinded.Broadcast(Object); // 'INSTANCE' is on the top of stack now
 
@@ -181,6 +247,8 @@ namespace UnLua
         int32 Ref;
         if (!ObjectRefs.RemoveAndCopyValue(Object, Ref))
             return;
+        ClearBoundRecord(Object);
+        Env->GetTickRegistry()->Remove(Object);
 
         const auto L = Env->GetMainState();
         const auto Top = lua_gettop(L);
@@ -214,6 +282,34 @@ namespace UnLua
         lua_settop(L, Top);
     }
 
+    bool FObjectRegistry::ResetInstance(UObject* Object)
+    {
+        const auto Ref = GetBoundRef(Object);
+        if (Ref == LUA_NOREF)
+            return false;
+
+        const auto L = Env->GetMainState();
+        lua_rawgeti(L, LUA_REGISTRYINDEX, Ref);
+        check(lua_istable(L, -1));
+        lua_pushnil(L);
+        while (lua_next(L, -2))
+        {
+            lua_pop(L, 1);
+            if (lua_type(L, -1) == LUA_TSTRING)
+            {
+                // keep the fields Bind set up, everything else falls back to the module through the metatable
+                const char* Key = lua_tostring(L, -1);
+                if (FCStringAnsi::Strcmp(Key, "Object") == 0 || FCStringAnsi::Strcmp(Key, "Overridden") == 0)
+                    continue;
+            }
+            lua_pushvalue(L, -1);
+            lua_pushnil(L);
+            lua_rawset(L, -4); // clearing existing fields is allowed during lua_next
+        }
+        lua_pop(L, 1);
+        return true;
+    }
+
     void FObjectRegistry::AddManualRef(lua_State* L, UObject* Object)
     {
         lua_getfield(L, LUA_REGISTRYINDEX, MANUAL_REF_PROXY_MAP);
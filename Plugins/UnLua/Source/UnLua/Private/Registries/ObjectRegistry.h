@@ -30,8 +30,32 @@ namespace UnLua
     class FObjectRegistry
     {
     public:
+        /** 绑定时记下的所属Lua环境和实例引用，按UObject索引存放，覆写函数的调用入口不用再定位环境和查表 */
+        struct FBoundRecord
+        {
+            const UObject* Object = nullptr;
+            FLuaEnv* Env = nullptr;
+            int32 SelfRef = LUA_NOREF;
+        };
+
         explicit FObjectRegistry(FLuaEnv* Env);
 
+        ~FObjectRegistry();
+
+        /**
+         * 获取UObject绑定时的记录。
+         * @return 若没有绑定到任何Lua环境则返回nullptr。
+         */
+        static FORCEINLINE const FBoundRecord* FindBoundRecord(const UObject* Object)
+        {
+            const int32 Index = GUObjectArray.ObjectToIndex(Object);
+            const int32 Chunk = Index / BoundRecordsPerChunk;
+            if (Chunk >= NumBoundRecordChunks || !BoundRecordChunks[Chunk])
+                return nullptr;
+            const auto& Record = BoundRecordChunks[Chunk][Index % BoundRecordsPerChunk];
+            return Record.Object == Object ? &Record : nullptr;
+        }
+
         void NotifyUObjectDeleted(UObject* Object);
 
         void NotifyUObjectLuaGC(UObject* Object);
@@ -66,6 +90,12 @@ namespace UnLua
          */
         void Unbind(UObject* Object);
 
+        /**
+         * 清空已绑定UObject的实例table中的字段，恢复为模块默认值，保留引用ID和元表，用于对象池复用。
+         * @return 若没有绑定过则返回false。
+         */
+        bool ResetInstance(UObject* Object);
+
         /**
          * 增加对指定对象的手动引用，并将对应的代理对象压入栈顶
          */;
@@ -79,8 +109,16 @@ namespace UnLua
     private:
         void RemoveFromObjectMapAndPushToStack(UObject* Object);
 
+        void SetBoundRecord(const UObject* Object, int32 SelfRef);
+
+        void ClearBoundRecord(const UObject* Object);
+
         FLuaEnv* Env;
         TMap<UObject*, int32> ObjectRefs;
+
+        static constexpr int32 BoundRecordsPerChunk = 64 * 1024;
+        static FBoundRecord** BoundRecordChunks; // allocated chunk by chunk on the game thread, never freed
+        static int32 NumBoundRecordChunks;
     };
 
     template <typename T>
@@ -19,7 +19,16 @@ namespace UnLua
 
     void FPropertyRegistry::NotifyUObjectDeleted(UObject* Object)
     {
-        FieldProperties.Remove(static_cast<UField*>(Object));
+        TSharedPtr<ITypeInterface> Removed;
+        if (!FieldProperties.RemoveAndCopyValue(static_cast<UField*>(Object), Removed))
+            return;
+
+        for (auto It = NamedTypes.CreateIterator(); It; ++It)
+        {
+            if (It.Value().TypeInterface == Removed)
+                It.RemoveCurrent();
+        }
+        Env->GetContainerRegistry()->NotifyTypeRemoved(Removed.Get());
     }
 
     TSharedPtr<ITypeInterface> FPropertyRegistry::CreateTypeInterface(lua_State* L, int32 Index)
@@ -44,22 +53,7 @@ namespace UnLua
                 lua_pushstring(L, "__name");
                 Type = lua_rawget(L, Index);
                 if (Type == LUA_TSTRING)
-                {
-                    const char* Name = lua_tostring(L, -1);
-                    auto ClassDesc = Env->GetClassRegistry()->Find(Name);
-                    if (ClassDesc)
-                    {
-                        TypeInterface = GetFieldProperty(ClassDesc->AsStruct());
-                    }
-                    else
-                    {
-                        auto EnumDesc = Env->GetEnumRegistry()->Find(Name);
-                        if (EnumDesc)
-                            TypeInterface = GetFieldProperty(EnumDesc->GetEnum());
-                        else
-                            TypeInterface = FindTypeInterface(lua_tostring(L, -1));
-                    }
-                }
+                    TypeInterface = GetNamedType(lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
             break;
@@ -91,6 +85,38 @@ namespace UnLua
         return TypeInterface;
     }
 
+    TSharedPtr<ITypeInterface> FPropertyRegistry::GetNamedType(const char* Name)
+    {
+        // Lua strings don't move while alive, a dead one's address can be reused by another string so the content is compared too
+        if (const auto Exists = NamedTypes.Find(Name))
+        {
+            if (FCStringAnsi::Strcmp(Exists->Name.GetData(), Name) == 0)
+                return Exists->TypeInterface;
+        }
+
+        TSharedPtr<ITypeInterface> TypeInterface;
+        if (const auto ClassDesc = Env->GetClassRegistry()->Find(Name))
+        {
+            TypeInterface = GetFieldProperty(ClassDesc->AsStruct());
+        }
+        else
+        {
+            const auto EnumDesc = Env->GetEnumRegistry()->Find(Name);
+            if (EnumDesc)
+                TypeInterface = GetFieldProperty(EnumDesc->GetEnum());
+            else
+                TypeInterface = FindTypeInterface(Name);
+        }
+
+        if (TypeInterface)
+        {
+            FNamedType& NamedType = NamedTypes.Add(Name);
+            NamedType.Name = TArray<ANSICHAR>(Name, FCStringAnsi::Strlen(Name) + 1);
+            NamedType.TypeInterface = TypeInterface;
+        }
+        return TypeInterface;
+    }
+
     TSharedPtr<ITypeInterface> FPropertyRegistry::GetBoolProperty()
     {
         if (!BoolProperty)
@@ -404,6 +430,7 @@ namespace UnLua
 
         const auto Ret = TSharedPtr<ITypeInterface>(FPropertyDesc::Create(Property));
         FieldProperties.Add(Field, Ret);
+        Env->MarkObjectTracked(Field);
         return Ret;
     }
 }
@@ -39,7 +39,18 @@ namespace UnLua
          */
         TSharedPtr<ITypeInterface> CreateTypeInterface(lua_State* L, int32 Index);
 
+        /** The struct owning the properties created for type interfaces, it is never unloaded */
+        FORCEINLINE const UScriptStruct* GetPropertyCollector() const { return PropertyCollector; }
+
     private:
+        /** A type looked up by the name of its Lua table */
+        struct FNamedType
+        {
+            TArray<ANSICHAR> Name;
+            TSharedPtr<ITypeInterface> TypeInterface;
+        };
+
+        TSharedPtr<ITypeInterface> GetNamedType(const char* Name);
         TSharedPtr<ITypeInterface> GetBoolProperty();
         TSharedPtr<ITypeInterface> GetIntProperty();
         TSharedPtr<ITypeInterface> GetFloatProperty();
@@ -51,6 +62,7 @@ namespace UnLua
         FLuaEnv* Env;
         UScriptStruct* PropertyCollector;
         TMap<UField*, TSharedPtr<ITypeInterface>> FieldProperties;
+        TMap<const void*, FNamedType> NamedTypes; // keyed by the address of the Lua string holding the name
         TSharedPtr<ITypeInterface> BoolProperty;
         TSharedPtr<ITypeInterface> IntProperty;
         TSharedPtr<ITypeInterface> FloatProperty;
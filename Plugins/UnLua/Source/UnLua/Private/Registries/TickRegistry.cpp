@@ -0,0 +1,271 @@
+﻿// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "TickRegistry.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "LuaCore.h"
+#include "LuaEnv.h"
+#include "UnLuaPrivate.h"
+
+namespace UnLua
+{
+    static const char* DISPATCHER_CHUNK = R"(
+return function(Instances, Deltas, N)
+    for i = 1, N do
+        Instances[i]:BatchTick(Deltas[i])
+    end
+end
+)";
+
+    FTickRegistry::FTickRegistry(FLuaEnv* Env)
+        : Env(Env)
+    {
+        const auto L = Env->GetMainState();
+        luaL_loadbuffer(L, DISPATCHER_CHUNK, FCStringAnsi::Strlen(DISPATCHER_CHUNK), "BatchTick");
+        lua_call(L, 0, 1);
+        DispatcherRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        OnWorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FTickRegistry::OnWorldCleanup);
+    }
+
+    FTickRegistry::~FTickRegistry()
+    {
+        FWorldDelegates::OnWorldCleanup.Remove(OnWorldCleanupHandle);
+
+        // the lua state is already closed
+        for (auto& Pair : Groups)
+            Pair.Value->TickFunction.UnRegisterTickFunction();
+    }
+
+    bool FTickRegistry::GetModuleTickGroup(lua_State* L, ETickingGroup& OutGroup, float& OutInterval)
+    {
+        static const TPair<const char*, ETickingGroup> GroupNames[] = {
+            {"PrePhysics", TG_PrePhysics},
+            {"DuringPhysics", TG_DuringPhysics},
+            {"PostPhysics", TG_PostPhysics},
+            {"PostUpdateWork", TG_PostUpdateWork},
+        };
+
+        lua_pushstring(L, "__TickGroup");
+        lua_rawget(L, -2);
+        bool bFound = false;
+        if (lua_type(L, -1) == LUA_TBOOLEAN)
+        {
+            bFound = !!lua_toboolean(L, -1);
+            OutGroup = TG_PrePhysics;
+        }
+        else if (lua_type(L, -1) == LUA_TSTRING)
+        {
+            const char* Name = lua_tostring(L, -1);
+            for (const auto& Pair : GroupNames)
+            {
+                if (FCStringAnsi::Strcmp(Name, Pair.Key) == 0)
+                {
+                    bFound = true;
+                    OutGroup = Pair.Value;
+                    break;
+                }
+            }
+            if (!bFound)
+                UE_LOG(LogUnLua, Warning, TEXT("unknown __TickGroup '%s'"), UTF8_TO_TCHAR(Name));
+        }
+        lua_pop(L, 1);
+
+        lua_pushstring(L, "__TickInterval");
+        lua_rawget(L, -2);
+        OutInterval = (float)lua_tonumber(L, -1);
+        lua_pop(L, 1);
+        return bFound;
+    }
+
+    void FTickRegistry::Add(UObject* Object, const int32 SelfRef, const ETickingGroup Group, const float Interval, const FString& ModuleName)
+    {
+        if (Locations.Contains(Object) || Object->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+            return;
+
+        UWorld* World = Object->GetWorld();
+        if (!World || !World->PersistentLevel)
+            return;
+
+        const TPair<UWorld*, int32> Key(World, Group);
+        auto GroupPtr = Groups.FindRef(Key).Get();
+        if (!GroupPtr)
+        {
+            GroupPtr = Groups.Add(Key, MakeUnique<FGroup>()).Get();
+            auto& TickFunction = GroupPtr->TickFunction;
+            TickFunction.Registry = this;
+            TickFunction.World = World;
+            TickFunction.TickGroup = Group;
+            TickFunction.bCanEverTick = true;
+            TickFunction.bStartWithTickEnabled = true;
+            TickFunction.RegisterTickFunction(World->PersistentLevel);
+        }
+
+        int32 BucketIndex = GroupPtr->Buckets.IndexOfByPredicate([&ModuleName](const FModuleBucket& Bucket) { return Bucket.ModuleName == ModuleName; });
+        if (BucketIndex == INDEX_NONE)
+        {
+            const auto L = Env->GetMainState();
+            BucketIndex = GroupPtr->Buckets.AddDefaulted();
+            auto& Bucket = GroupPtr->Buckets[BucketIndex];
+            Bucket.ModuleName = ModuleName;
+            lua_newtable(L);
+            Bucket.InstancesRef = luaL_ref(L, LUA_REGISTRYINDEX);
+            lua_newtable(L);
+            Bucket.DeltasRef = luaL_ref(L, LUA_REGISTRYINDEX);
+#if STATS
+            Bucket.StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_UnLua>(FString::Printf(TEXT("BatchTick %s"), *ModuleName));
+#endif
+        }
+
+        auto& Entries = GroupPtr->Buckets[BucketIndex].Entries;
+        FEntry Entry;
+        Entry.Object = Object;
+        Entry.SelfRef = SelfRef;
+        Entry.Interval = Interval;
+        Entry.Elapsed = 0;
+        Entry.bActor = Object->IsA<AActor>();
+        Locations.Add(Object, {GroupPtr, BucketIndex, Entries.Add(Entry)});
+    }
+
+    void FTickRegistry::Remove(const UObject* Object)
+    {
+        FLocation Location;
+        if (!Locations.RemoveAndCopyValue(Object, Location))
+            return;
+
+        auto& Entries = Location.Group->Buckets[Location.Bucket].Entries;
+        Entries.RemoveAtSwap(Location.Index, 1, false);
+        if (Location.Index < Entries.Num())
+            Locations.FindChecked(Entries[Location.Index].Object).Index = Location.Index;
+    }
+
+    void FTickRegistry::Tick(UWorld* World, const ETickingGroup Group, const float DeltaSeconds)
+    {
+        const auto Exists = Groups.Find(TPair<UWorld*, int32>(World, Group));
+        if (!Exists)
+            return;
+
+        const auto L = Env->GetMainState();
+        auto& Buckets = (*Exists)->Buckets;
+        // instances spawned by a BatchTick may add buckets, so no references across the lua call
+        for (int32 BucketIndex = 0; BucketIndex < Buckets.Num(); BucketIndex++)
+        {
+            if (Buckets[BucketIndex].Entries.Num() == 0 && Buckets[BucketIndex].LastCount == 0)
+                continue;
+
+#if STATS
+            FScopeCycleCounter CycleCounter(Buckets[BucketIndex].StatId);
+#endif
+            const double StartTime = FPlatformTime::Seconds();
+            const int32 Top = lua_gettop(L);
+            lua_pushcfunction(L, ReportLuaCallError);
+            lua_rawgeti(L, LUA_REGISTRYINDEX, DispatcherRef);
+
+            int32 Count = 0;
+            {
+                auto& Bucket = Buckets[BucketIndex];
+                lua_rawgeti(L, LUA_REGISTRYINDEX, Bucket.InstancesRef);
+                lua_rawgeti(L, LUA_REGISTRYINDEX, Bucket.DeltasRef);
+                for (auto& Entry : Bucket.Entries)
+                {
+                    // like ReceiveTick: not before BeginPlay, not once destroyed
+                    if (!IsValid(Entry.Object) || (Entry.bActor && !static_cast<AActor*>(Entry.Object)->HasActorBegunPlay()))
+                        continue;
+
+                    Entry.Elapsed += DeltaSeconds;
+                    if (Entry.Elapsed < Entry.Interval)
+                        continue;
+
+                    Count++;
+                    lua_rawgeti(L, LUA_REGISTRYINDEX, Entry.SelfRef);
+                    lua_rawseti(L, -3, Count);
+                    lua_pushnumber(L, Entry.Elapsed);
+                    lua_rawseti(L, -2, Count);
+                    Entry.Elapsed = 0;
+                }
+
+                // drop instances left over from a bigger frame
+                for (int32 i = Count + 1; i <= Bucket.LastCount; i++)
+                {
+                    lua_pushnil(L);
+                    lua_rawseti(L, -3, i);
+                }
+                Bucket.LastCount = Count;
+                Bucket.NumTicks += Count;
+            }
+
+            if (Count > 0)
+            {
+                lua_pushinteger(L, Count);
+                lua_pcall(L, 3, 0, Top + 1);
+            }
+            lua_settop(L, Top);
+            Buckets[BucketIndex].Seconds += FPlatformTime::Seconds() - StartTime;
+        }
+    }
+
+    void FTickRegistry::GetStats(TArray<FModuleStats>& OutStats) const
+    {
+        TMap<FString, FModuleStats> Stats;
+        for (const auto& Pair : Groups)
+        {
+            for (const auto& Bucket : Pair.Value->Buckets)
+            {
+                auto& ModuleStats = Stats.FindOrAdd(Bucket.ModuleName);
+                ModuleStats.ModuleName = Bucket.ModuleName;
+                ModuleStats.NumInstances += Bucket.Entries.Num();
+                ModuleStats.NumTicks += Bucket.NumTicks;
+                ModuleStats.Seconds += Bucket.Seconds;
+            }
+        }
+        Stats.GenerateValueArray(OutStats);
+    }
+
+    void FTickRegistry::FGroupTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+    {
+        Registry->Tick(World, TickGroup, DeltaTime);
+    }
+
+    FString FTickRegistry::FGroupTickFunction::DiagnosticMessage()
+    {
+        return FString::Printf(TEXT("UnLua BatchTick[%s]"), *UEnum::GetValueAsString(TickGroup.GetValue()));
+    }
+
+    void FTickRegistry::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+    {
+        for (auto It = Groups.CreateIterator(); It; ++It)
+        {
+            if (It.Key().Key != World)
+                continue;
+            RemoveGroup(*It.Value());
+            It.RemoveCurrent();
+        }
+    }
+
+    void FTickRegistry::RemoveGroup(FGroup& Group)
+    {
+        Group.TickFunction.UnRegisterTickFunction();
+
+        const auto L = Env->GetMainState();
+        for (const auto& Bucket : Group.Buckets)
+        {
+            for (const auto& Entry : Bucket.Entries)
+                Locations.Remove(Entry.Object);
+            luaL_unref(L, LUA_REGISTRYINDEX, Bucket.InstancesRef);
+            luaL_unref(L, LUA_REGISTRYINDEX, Bucket.DeltasRef);
+        }
+    }
+}
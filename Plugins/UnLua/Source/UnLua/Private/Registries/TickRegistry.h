@@ -0,0 +1,118 @@
+﻿// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "lua.hpp"
+#include "Engine/EngineBaseTypes.h"
+#include "Stats/Stats.h"
+
+namespace UnLua
+{
+    class FLuaEnv;
+
+    /**
+     * 批量Tick。
+     *
+     * 模块声明'__TickGroup'（"PrePhysics"、"DuringPhysics"、"PostPhysics"、"PostUpdateWork"，true表示"PrePhysics"）
+     * 和可选的'__TickInterval'（秒）后，绑定的实例按世界和TickGroup登记到原生列表里，
+     * 每帧每个模块只调用一次Lua分发函数，由它依次调用实例的'BatchTick(DeltaSeconds)'，不再逐个经过ProcessEvent。
+     * 有间隔的实例在没到时间的帧里跳过，到时间时收到累计的DeltaSeconds。
+     */
+    class UNLUA_API FTickRegistry
+    {
+    public:
+        explicit FTickRegistry(FLuaEnv* Env);
+
+        ~FTickRegistry();
+
+        /** 解析模块的'__TickGroup'，模块表需要在栈顶 */
+        static bool GetModuleTickGroup(lua_State* L, ETickingGroup& OutGroup, float& OutInterval);
+
+        void Add(UObject* Object, int32 SelfRef, ETickingGroup Group, float Interval, const FString& ModuleName);
+
+        void Remove(const UObject* Object);
+
+        /** 执行一个世界里某个TickGroup登记的所有实例，平时由注册到世界上的tick function调用 */
+        void Tick(UWorld* World, ETickingGroup Group, float DeltaSeconds);
+
+        /** 一个模块累计的批量Tick耗时 */
+        struct FModuleStats
+        {
+            FString ModuleName;
+            int32 NumInstances = 0;
+            int64 NumTicks = 0;
+            double Seconds = 0;
+        };
+
+        void GetStats(TArray<FModuleStats>& OutStats) const;
+
+    private:
+        struct FEntry
+        {
+            UObject* Object;
+            int32 SelfRef;
+            float Interval;
+            float Elapsed;
+            bool bActor;
+        };
+
+        struct FModuleBucket
+        {
+            FString ModuleName;
+            TArray<FEntry> Entries;
+            int32 InstancesRef = LUA_NOREF; // reused every frame, holds the instances due
+            int32 DeltasRef = LUA_NOREF;
+            int32 LastCount = 0;
+            int64 NumTicks = 0;
+            double Seconds = 0;
+#if STATS
+            TStatId StatId;
+#endif
+        };
+
+        struct FGroupTickFunction : FTickFunction
+        {
+            FTickRegistry* Registry = nullptr;
+            UWorld* World = nullptr;
+
+            virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+            virtual FString DiagnosticMessage() override;
+        };
+
+        struct FGroup
+        {
+            FGroupTickFunction TickFunction;
+            TArray<FModuleBucket> Buckets;
+        };
+
+        struct FLocation
+        {
+            FGroup* Group;
+            int32 Bucket;
+            int32 Index;
+        };
+
+        void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+        void RemoveGroup(FGroup& Group);
+
+        FLuaEnv* Env;
+        int32 DispatcherRef;
+        TMap<TPair<UWorld*, int32>, TUniquePtr<FGroup>> Groups;
+        TMap<const UObject*, FLocation> Locations;
+        FDelegateHandle OnWorldCleanupHandle;
+    };
+}
@@ -227,6 +227,99 @@ namespace UnLua
             return 0;
         }
 
+        static int Recycle(lua_State* L)
+        {
+            const auto Object = GetUObject(L, 1);
+            if (!Object)
+                return luaL_error(L, "invalid UObject");
+
+            auto& Env = FLuaEnv::FindEnvChecked(L);
+            lua_pushboolean(L, Env.RecycleObject(Object));
+            return 1;
+        }
+
+        static int Reuse(lua_State* L)
+        {
+            const auto Object = GetUObject(L, 1);
+            if (!Object)
+                return luaL_error(L, "invalid UObject");
+
+            auto& Env = FLuaEnv::FindEnvChecked(L);
+            int32 InitializerTableRef = LUA_NOREF;
+            if (lua_istable(L, 2))
+            {
+                lua_pushvalue(L, 2);
+                InitializerTableRef = luaL_ref(L, LUA_REGISTRYINDEX);
+            }
+            lua_pushboolean(L, Env.ReuseObject(Object, InitializerTableRef));
+            luaL_unref(L, LUA_REGISTRYINDEX, InitializerTableRef);
+            return 1;
+        }
+
+        static UObject* GetOwner(lua_State* L, int32 Index)
+        {
+            if (lua_isnoneornil(L, Index))
+                return nullptr;
+            const auto Owner = GetUObject(L, Index);
+            if (!Owner)
+                luaL_error(L, "invalid owner");
+            return Owner;
+        }
+
+        static int Sleep(lua_State* L)
+        {
+            const auto Seconds = luaL_checknumber(L, 1);
+            const auto Owner = GetOwner(L, 2);
+            return FLuaEnv::FindEnvChecked(L).GetCoroutineScheduler()->Sleep(L, Seconds, Owner);
+        }
+
+        static int WaitFrames(lua_State* L)
+        {
+            const auto NumFrames = (int32)luaL_optinteger(L, 1, 1);
+            const auto Owner = GetOwner(L, 2);
+            return FLuaEnv::FindEnvChecked(L).GetCoroutineScheduler()->WaitFrames(L, NumFrames, Owner);
+        }
+
+        static int WaitEvent(lua_State* L)
+        {
+            const auto Event = luaL_checkstring(L, 1);
+            const auto Owner = GetOwner(L, 2);
+            return FLuaEnv::FindEnvChecked(L).GetCoroutineScheduler()->WaitEvent(L, FName(UTF8_TO_TCHAR(Event)), Owner);
+        }
+
+        static int Signal(lua_State* L)
+        {
+            const auto Event = luaL_checkstring(L, 1);
+            const auto NumSignalled = FLuaEnv::FindEnvChecked(L).GetCoroutineScheduler()->Signal(L, FName(UTF8_TO_TCHAR(Event)), 2);
+            lua_pushinteger(L, NumSignalled);
+            return 1;
+        }
+
+        static int Cancel(lua_State* L)
+        {
+            const auto Thread = lua_tothread(L, 1);
+            luaL_argcheck(L, Thread, 1, "coroutine expected");
+            lua_pushboolean(L, FLuaEnv::FindEnvChecked(L).GetCoroutineScheduler()->Cancel(Thread));
+            return 1;
+        }
+
+        static int Spawn(lua_State* L)
+        {
+            return FLuaEnv::FindEnvChecked(L).GetCoroutinePool()->Spawn(L);
+        }
+
+        static int Watch(lua_State* L)
+        {
+            return FLuaEnv::FindEnvChecked(L).GetPropertyWatcher()->Watch(L);
+        }
+
+        static int Unwatch(lua_State* L)
+        {
+            const auto Id = luaL_checkinteger(L, 1);
+            lua_pushboolean(L, FLuaEnv::FindEnvChecked(L).GetPropertyWatcher()->Unwatch(Id));
+            return 1;
+        }
+
         static constexpr luaL_Reg UnLua_Functions[] = {
             {"Log", LogInfo},
             {"LogWarn", LogWarn},
@@ -234,6 +327,16 @@ namespace UnLua
             {"HotReload", HotReload},
             {"Ref", Ref},
             {"Unref", Unref},
+            {"Recycle", Recycle},
+            {"Reuse", Reuse},
+            {"Sleep", Sleep},
+            {"WaitFrames", WaitFrames},
+            {"WaitEvent", WaitEvent},
+            {"Signal", Signal},
+            {"Cancel", Cancel},
+            {"Spawn", Spawn},
+            {"Watch", Watch},
+            {"Unwatch", Unwatch},
             {"FTextEnabled", nullptr},
             {NULL, NULL}
         };
@@ -225,6 +225,7 @@
 #include "LuaCore.h"
 #include "LuaFunction.h"
 #include "ObjectReferencer.h"
+#include "UnLuaSettings.h"
 
 
 static const TCHAR* SReadableInputEvent[] = { TEXT("Pressed"), TEXT("Released"), TEXT("Repeat"), TEXT("DoubleClick"), TEXT("Axis"), TEXT("Max") };
@@ -263,35 +264,74 @@ bool UUnLuaManager::Bind(UObject *Object, const TCHAR *InModuleName, int32 Initi
     if (!Env->GetClassRegistry()->Register(Class))
         return false;
 
-    // try bind lua if not bind or use a copyed table
-    UnLua::FLuaRetValues RetValues = UnLua::Call(L, "require", TCHAR_TO_UTF8(InModuleName));
-    FString Error;
-    if (!RetValues.IsValid() || RetValues.Num() == 0)
+    // the class already holds a copy of this module in BindInfo.TableRef, no need to require it for every instance
+    if (!IsClassBound(Class, InModuleName))
     {
-        Error = "invalid return value of require()";
-    }
-    else if (RetValues[0].GetType() != LUA_TTABLE)
-    {
-        Error = FString("table needed but got ");
-        if(RetValues[0].GetType() == LUA_TSTRING)
-            Error += UTF8_TO_TCHAR(RetValues[0].Value<const char*>());
+        // try bind lua if not bind or use a copyed table
+        UnLua::FLuaRetValues RetValues = UnLua::Call(L, "require", TCHAR_TO_UTF8(InModuleName));
+        FString Error;
+        if (!RetValues.IsValid() || RetValues.Num() == 0)
+        {
+            Error = "invalid return value of require()";
+        }
+        else if (RetValues[0].GetType() != LUA_TTABLE)
+        {
+            Error = FString("table needed but got ");
+            if(RetValues[0].GetType() == LUA_TSTRING)
+                Error += UTF8_TO_TCHAR(RetValues[0].Value<const char*>());
+            else
+                Error += UTF8_TO_TCHAR(lua_typename(L, RetValues[0].GetType()));
+        }
         else
-            Error += UTF8_TO_TCHAR(lua_typename(L, RetValues[0].GetType()));
+        {
+            BindClass(Class, InModuleName, Error);
+        }
+
+        if (!Error.IsEmpty())
+        {
+            UE_LOG(LogUnLua, Warning, TEXT("Failed to attach %s module for object %s,%p!\n%s"), InModuleName, *Object->GetName(), Object, *Error);
+            return false;
+        }
     }
-    else
+
+    Env->GetObjectRegistry()->Bind(Class);
+
+    if (Object != Class && InitializerTableRef == LUA_NOREF)
     {
-        BindClass(Class, InModuleName, Error);
+        // only the class overrides are needed until lua first sees the object, see BindDeferred
+        const auto BindInfo = Classes.Find(Class);
+        if (BindInfo && BindInfo->bLazy)
+            return true;
     }
 
-    if (!Error.IsEmpty())
-    {
-        UE_LOG(LogUnLua, Warning, TEXT("Failed to attach %s module for object %s,%p!\n%s"), InModuleName, *Object->GetName(), Object, *Error);
+    return BindInstance(Object, InitializerTableRef);
+}
+
+/**
+ * Bind an instance of a lazily bound class, called when the object is first pushed to or dispatched into Lua
+ */
+bool UUnLuaManager::BindDeferred(UObject *Object)
+{
+    const auto BindInfo = Classes.Find(Object->GetClass());
+    if (!BindInfo || !BindInfo->bLazy || Env->GetObjectRegistry()->IsBound(Object))
         return false;
-    }
+
+    return BindInstance(Object, LUA_NOREF);
+}
+
+/**
+ * Create the Lua instance of a UObject whose class is bound, then call its 'Initialize'
+ */
+bool UUnLuaManager::BindInstance(UObject *Object, int32 InitializerTableRef)
+{
+    lua_State *L = Env->GetMainState();
 
     // create a Lua instance for this UObject
-    Env->GetObjectRegistry()->Bind(Class);
-    Env->GetObjectRegistry()->Bind(Object);
+    const int32 SelfRef = Env->GetObjectRegistry()->Bind(Object);
+
+    const auto BindInfo = Classes.Find(Object->GetClass());
+    if (BindInfo && BindInfo->bBatchTick && SelfRef > 0)
+        Env->GetTickRegistry()->Add(Object, SelfRef, BindInfo->TickGroup, BindInfo->TickInterval, BindInfo->ModuleName);
 
     // try call user first user function handler
     int32 FunctionRef = PushFunction(L, Object, "Initialize");                  // push hard coded Lua function 'Initialize'
@@ -450,6 +490,23 @@ void UUnLuaManager::OnLatentActionCompleted(int32 LinkID)
     Env->ResumeThread(LinkID); // resume a coroutine
 }
 
+/**
+ * Whether BindClass would return early for this class and module
+ */
+bool UUnLuaManager::IsClassBound(UClass* Class, const TCHAR* InModuleName) const
+{
+    const auto BindInfo = Classes.Find(Class);
+    if (!BindInfo || !BindInfo->ModuleName.Equals(InModuleName, ESearchCase::CaseSensitive))
+        return false;
+
+#if WITH_EDITOR
+    // 兼容蓝图Recompile导致FuncMap被清空的情况
+    return Class->FindFunctionByName("__UClassBindSucceeded", EIncludeSuperFlag::Type::ExcludeSuper) != nullptr;
+#else
+    return true;
+#endif
+}
+
 bool UUnLuaManager::BindClass(UClass* Class, const FString& InModuleName, FString& Error)
 {
     check(Class);
@@ -480,6 +537,16 @@ bool UUnLuaManager::BindClass(UClass* Class, const FString& InModuleName, FStrin
         return false;
     }
 
+    // 模块里的'__LazyBind'字段优先于工程设置
+    lua_pushstring(L, "__LazyBind");
+    lua_rawget(L, -2);
+    const bool bLazy = lua_isnil(L, -1) ? GetDefault<UUnLuaSettings>()->bLazyInstanceBinding : !!lua_toboolean(L, -1);
+    lua_pop(L, 1);
+
+    ETickingGroup TickGroup = TG_PrePhysics;
+    float TickInterval = 0;
+    const bool bBatchTick = UnLua::FTickRegistry::GetModuleTickGroup(L, TickGroup, TickInterval);
+
     if (!Class->IsChildOf<UBlueprintFunctionLibrary>())
     {
         // 一个LuaModule可能会被绑定到一个UClass和它的子类，复制一个出来作为它们的实例的元表
@@ -498,9 +565,15 @@ bool UUnLuaManager::BindClass(UClass* Class, const FString& InModuleName, FStrin
     lua_settop(L, Top);
 
     auto& BindInfo = Classes.Add(Class);
+    Env->MarkObjectTracked(Class);
     BindInfo.Class = Class;
     BindInfo.ModuleName = InModuleName;
     BindInfo.TableRef = Ref;
+    // 批量Tick要在实例创建时就注册到TickRegistry，所以这类模块不走延迟绑定
+    BindInfo.bLazy = bLazy && !bBatchTick;
+    BindInfo.bBatchTick = bBatchTick;
+    BindInfo.TickGroup = TickGroup;
+    BindInfo.TickInterval = TickInterval;
 
     UnLua::LowLevel::GetFunctionNames(Env->GetMainState(), Ref, BindInfo.LuaFunctions);
     ULuaFunction::GetOverridableFunctions(Class, BindInfo.UEFunctions);
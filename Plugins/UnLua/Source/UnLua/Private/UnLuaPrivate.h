@@ -47,6 +47,7 @@ DECLARE_MEMORY_STAT_EXTERN(TEXT("Lua Memory"), STAT_UnLua_Lua_Memory, STATGROUP_
 DECLARE_MEMORY_STAT_EXTERN(TEXT("Persistent Parameter Buffer Memory"), STAT_UnLua_PersistentParamBuffer_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("OutParmRec Memory"), STAT_UnLua_OutParmRec_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 DECLARE_MEMORY_STAT_EXTERN(TEXT("Container Element Cache Memory"), STAT_UnLua_ContainerElementCache_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Default Parameter Memory"), STAT_UnLua_DefaultParam_Memory, STATGROUP_UnLua, /*UNLUA_API*/);
 
 #define UNLUA_DEFINE_STAT(Name) \
     DEFINE_STAT(STAT_UnLua_##Name);
@@ -82,6 +83,12 @@ DECLARE_MEMORY_STAT_EXTERN(TEXT("Container Element Cache Memory"), STAT_UnLua_Co
 #define UNLUA_SCOPE_CYCLE_COUNTER(StatName) \
     SCOPE_CYCLE_COUNTER(STAT_##StatName)
 
+#define UNLUA_DECLARE_DWORD_COUNTER_STAT(FriendlyName, StatName) \
+    DECLARE_DWORD_COUNTER_STAT(TEXT(FriendlyName), STAT_##StatName, STATGROUP_UnLua)
+
+#define UNLUA_INC_DWORD_STAT(StatName) \
+    INC_DWORD_STAT(STAT_##StatName)
+
 #else
 
 #define UNLUA_DEFINE_STAT(Name)
@@ -93,6 +100,9 @@ DECLARE_MEMORY_STAT_EXTERN(TEXT("Container Element Cache Memory"), STAT_UnLua_Co
 #define UNLUA_DECLARE_CYCLE_STAT(FriendlyName, StatName)
 #define UNLUA_SCOPE_CYCLE_COUNTER(StatName)
 
+#define UNLUA_DECLARE_DWORD_COUNTER_STAT(FriendlyName, StatName)
+#define UNLUA_INC_DWORD_STAT(StatName)
+
 #endif
 
 UNLUA_API extern FString GLuaSrcRelativePath;
@@ -22,16 +22,24 @@
 #include "Registries/ContainerRegistry.h"
 #include "Registries/PropertyRegistry.h"
 #include "Registries/EnumRegistry.h"
+#include "Registries/TickRegistry.h"
+#include "Registries/DataTableRegistry.h"
 #include "UnLuaManager.h"
 #include "lua.hpp"
 #include "ObjectReferencer.h"
 #include "HAL/Platform.h"
+#include "Async/Future.h"
 #include "LuaDanglingCheck.h"
 #include "LuaDeadLoopCheck.h"
+#include "LuaCoroutineScheduler.h"
+#include "LuaCoroutinePool.h"
+#include "LuaPropertyWatcher.h"
 #include "LuaModuleLocator.h"
 
 namespace UnLua
 {
+    class FLuaScriptArchive;
+
     class UNLUA_API FLuaEnv
         : public FUObjectArray::FUObjectDeleteListener
     {
@@ -64,6 +72,14 @@ namespace UnLua
 
         void Start(const FString& StartupModuleName, const TMap<FString, UObject*>& Args);
 
+        FORCEINLINE bool IsStarted() const { return bStarted; }
+
+        /** Read and compile lua modules on worker threads, so their first require from the file system only loads bytecode. */
+        void PreloadModules(const TArray<FString>& ModuleNames);
+
+        /** Forget which module files exist, call it after adding or removing script files outside of a hot reload. */
+        void ResetModuleFileIndex();
+
         const FString& GetName();
 
         void SetName(FString InName);
@@ -76,6 +92,19 @@ namespace UnLua
 
         virtual bool TryReplaceInputs(UObject* Object);
 
+        /**
+         * Return a bound object to a pool: call its 'OnRecycle' then reset its Lua instance table to the module defaults.
+         * The registry ref and metatable survive, so reusing the object costs no rebinding.
+         * @return false if the object has no Lua instance
+         */
+        bool RecycleObject(UObject* Object);
+
+        /**
+         * Take a recycled object out of a pool: call its 'Initialize' then 'OnReuse', both with the initializer table if any.
+         * @return false if the object has no Lua instance
+         */
+        bool ReuseObject(UObject* Object, int32 InitializerTableRef = LUA_NOREF);
+
         bool DoString(const FString& Chunk, const FString& ChunkName = "chunk");
 
         virtual void GC();
@@ -90,8 +119,14 @@ namespace UnLua
 
         int32 FindThread(const lua_State* Thread);
 
+        /** Forget the reference a thread was registered with, a later ResumeThread with that reference does nothing. */
+        FORCEINLINE static void ClearThreadRef(lua_State* Thread) { *(int32*)lua_getextraspace(Thread) = 0; }
+
         void ResumeThread(int32 ThreadRef);
 
+        /** Resume a thread with the values PushArgs pushes onto it, PushArgs returns how many it has pushed. */
+        void ResumeThread(int32 ThreadRef, TFunctionRef<int32(lua_State*)> PushArgs);
+
         UUnLuaManager* GetManager();
 
         FORCEINLINE FClassRegistry* GetClassRegistry() const { return ClassRegistry; }
@@ -108,6 +143,16 @@ namespace UnLua
 
         FORCEINLINE FPropertyRegistry* GetPropertyRegistry() const { return PropertyRegistry; }
 
+        FORCEINLINE FTickRegistry* GetTickRegistry() const { return TickRegistry; }
+
+        FORCEINLINE FDataTableRegistry* GetDataTableRegistry() const { return DataTableRegistry; }
+
+        FORCEINLINE FCoroutineScheduler* GetCoroutineScheduler() const { return CoroutineScheduler; }
+
+        FORCEINLINE FCoroutinePool* GetCoroutinePool() const { return CoroutinePool; }
+
+        FORCEINLINE FPropertyWatcher* GetPropertyWatcher() const { return PropertyWatcher; }
+
         FORCEINLINE FDanglingCheck* GetDanglingCheck() const { return DanglingCheck; }
 
         FORCEINLINE FDeadLoopCheck* GetDeadLoopCheck() const { return DeadLoopCheck; }
@@ -116,10 +161,30 @@ namespace UnLua
 
         void AddBuiltInLoader(const FString InName, lua_CFunction Loader);
 
+        /** Search a script archive after the custom loaders and before the file system, archives added later win. */
+        void AddArchive(const TSharedPtr<FLuaScriptArchive, ESPMode::ThreadSafe>& Archive);
+
         void AddManualObjectReference(UObject* Object);
 
         void RemoveManualObjectReference(UObject* Object);
 
+        /** Registries call this when they start holding an object, deletions of objects never marked skip the registries. */
+        FORCEINLINE void MarkObjectTracked(const UObjectBase* Object)
+        {
+            const int32 Index = GUObjectArray.ObjectToIndex(Object);
+            const int32 Word = Index >> 5;
+            if (Word >= TrackedObjects.Num())
+                TrackedObjects.AddZeroed(Word + 1 - TrackedObjects.Num());
+            TrackedObjects[Word] |= 1u << (Index & 31);
+        }
+
+        /** Whether the object at a GUObjectArray index was marked, takes the index so it stays valid after the object is freed. */
+        FORCEINLINE bool IsObjectTracked(const int32 Index) const
+        {
+            const int32 Word = Index >> 5;
+            return Word < TrackedObjects.Num() && (TrackedObjects[Word] & (1u << (Index & 31))) != 0;
+        }
+
     protected:
         lua_State* L;
 
@@ -129,6 +194,8 @@ namespace UnLua
 
         static int LoadFromFileSystem(lua_State* L);
 
+        int LoadFromArchives(lua_State* InL);
+
         static void* DefaultLuaAllocator(void* ud, void* ptr, size_t osize, size_t nsize);
 
         virtual lua_Alloc GetLuaAllocator() const;
@@ -146,8 +213,44 @@ namespace UnLua
         }
 
     private:
+        /** What TryBind/TryReplaceInputs learned about a class, none of it changes until the class is recompiled */
+        struct FClassBindDecision
+        {
+            FString ModuleName; // empty when instances never bind statically
+            bool bImplUnluaInterface = false;
+            bool bInputComponent = false;
+        };
+
+        /** A module read and compiled ahead of its require */
+        struct FPreloadedChunk
+        {
+            FString FullPath; // empty when the module was not found
+            TArray<uint8> Data; // bytecode, or the source when it has to go through LoadBuffer
+        };
+
+        static bool FindModuleFile(const FString& PackagePath, const FString& ModuleName, TArray<uint8>& OutData, FString& OutFullPath);
+
+        static bool ReadModuleFile(const FString& FullPath, TArray<uint8>& OutData);
+
+        /**
+         * Look a module up in the file index, building it first if the package path changed.
+         * @return false if the module has no file; true with an empty OutFullPath if the package path can't be indexed
+         */
+        bool LocateModuleFile(const FString& PackagePath, const FString& ModuleName, FString& OutFullPath);
+
+        static FPreloadedChunk PreloadChunk(const FString& PackagePath, const FString& ModuleName, const FString& FullPath);
+
         void AddSearcher(lua_CFunction Searcher, int Index) const;
 
+        bool MakeBindDecision(UClass* Class, UObject* Object, FClassBindDecision& OutDecision) const;
+
+        /** The cached decision of a class, nullptr when it can't be cached yet or the module locator is not class based */
+        const FClassBindDecision* FindOrAddBindDecision(UClass* Class, UObject* Object);
+
+#if WITH_EDITOR
+        void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacedObjects);
+#endif
+
         bool LoadBuffer(lua_State* InL, const char* Buffer, const size_t Size, const char* InName);
 
         void OnAsyncLoadingFlushUpdate();
@@ -161,6 +264,7 @@ namespace UnLua
         static TMap<lua_State*, FLuaEnv*> AllEnvs;
         TMap<FString, lua_CFunction> BuiltinLoaders;
         TArray<FLuaFileLoader> CustomLoaders;
+        TArray<TSharedPtr<FLuaScriptArchive, ESPMode::ThreadSafe>> Archives;
         TArray<FWeakObjectPtr> Candidates; // binding candidates during async loading
         ULuaModuleLocator* ModuleLocator;
         FCriticalSection CandidatesLock;
@@ -174,13 +278,27 @@ namespace UnLua
         FContainerRegistry* ContainerRegistry;
         FPropertyRegistry* PropertyRegistry;
         FEnumRegistry* EnumRegistry;
+        FTickRegistry* TickRegistry;
+        FDataTableRegistry* DataTableRegistry;
+        FCoroutineScheduler* CoroutineScheduler;
+        FCoroutinePool* CoroutinePool;
+        FPropertyWatcher* PropertyWatcher;
         FDanglingCheck* DanglingCheck;
         FDeadLoopCheck* DeadLoopCheck;
-        TMap<lua_State*, int32> ThreadToRef;
-        TMap<int32, lua_State*> RefToThread;
         FDelegateHandle OnAsyncLoadingFlushUpdateHandle;
         TArray<UInputComponent*> CandidateInputComponents;
         FDelegateHandle OnWorldTickStartHandle;
+        TMap<UClass*, FClassBindDecision> BindDecisions; // game thread only
+        TMap<FString, TFuture<FPreloadedChunk>> PreloadedChunks; // consumed by their first require
+        FString PreloadedPackagePath;
+        TMap<FString, FString> ModuleFileIndex; // module file name -> full path of every script under the package path
+        FString ModuleFileIndexPackagePath;
+        bool bModuleFileIndexBuilt = false;
+        bool bModuleFileIndexUsable = false;
+        TArray<uint32> TrackedObjects; // one bit per GUObjectArray index
+#if WITH_EDITOR
+        FDelegateHandle OnObjectsReplacedHandle;
+#endif
         FString Name = TEXT("Env_0");
         bool bObjectArrayListenerRegistered;
         bool bStarted;
@@ -0,0 +1,49 @@
+﻿// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnLua
+{
+    class FLuaEnv;
+
+    /**
+     * Lua环境启动快照。
+     *
+     * Save 在一个刚创建的环境里执行启动模块，把 package.loaded 和 _G 里新增的内容写入快照文件；
+     * Load 在另一个刚创建的环境里读回这些内容，代替再次执行启动模块。
+     *
+     * 写入的是纯Lua数据：table（含元表）、Lua函数（字节码和upvalue，共享的upvalue保持共享）、字符串、数字和布尔值。
+     * 环境创建时就存在的table、函数和userdata（标准库、UE命名空间、导出的C函数、元表等）只记录名字，读取时按名字重新关联；
+     * UObject按路径记录，读取时重新加载。其它userdata、线程和没有名字的C函数会导致保存失败。
+     * 启动模块对环境自带的table做的修改（比如往 string 里加函数）不会被保存。
+     */
+    class UNLUA_API FLuaEnvSnapshot
+    {
+    public:
+        /**
+         * 在未启动的Env里执行启动模块，并把结果写入快照文件
+         * @return Env已经启动过或者有无法保存的值时返回false
+         */
+        static bool Save(FLuaEnv& Env, const FString& StartupModuleName, const TMap<FString, UObject*>& Args, const FString& FilePath);
+
+        /**
+         * 用快照文件启动未启动的Env，不再执行启动模块
+         * @return 文件不存在、版本不匹配或者有无法关联的名字时返回false，此时Env保持未启动
+         */
+        static bool Load(FLuaEnv& Env, const FString& FilePath);
+    };
+}
@@ -23,6 +23,12 @@ class UNLUA_API ULuaModuleLocator : public UObject
     GENERATED_BODY()
 public:
     virtual FString Locate(const UObject* Object);
+
+    /**
+     * Whether all instances of a class locate the same module. The env then asks once per class and reuses the answer,
+     * override it to return false when Locate depends on the instance.
+     */
+    virtual bool IsClassBased() const { return true; }
 };
 
 UCLASS()
@@ -0,0 +1,86 @@
+﻿// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "lua.hpp"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace UnLua
+{
+    /**
+     * 脚本归档文件，把所有Lua模块打包成一个文件。
+     *
+     * 格式：文件头 + 按模块名（UTF-8字节序）排序的索引 + 模块名字符串区 + 模块数据区。
+     * 模块数据通常是字节码，也可以是源码，可以单独用zlib压缩；每个模块记录原始数据的CRC32，用于生成补丁时比较。
+     * 运行时以只读方式内存映射，未压缩的模块直接从映射内存加载，不再逐个打开文件。
+     * 平台或者pak不支持映射时退化为一次性读入整个文件。
+     */
+    class UNLUA_API FLuaScriptArchive
+    {
+    public:
+        struct FModule
+        {
+            FString Name;
+            TArray<uint8> Data;
+        };
+
+        /** 把源码编译成字节码，bStripDebugInfo 会去掉行号和局部变量名 */
+        static bool Compile(const TArray<uint8>& Source, const FString& ChunkName, bool bStripDebugInfo, TArray<uint8>& OutBytecode, FString& OutError);
+
+        /** 写入归档文件，bCompress 时只压缩能变小的模块 */
+        static bool Write(const FString& FilePath, TArray<FModule> Modules, bool bCompress);
+
+        /** 打开归档文件，同一路径在所有Lua环境之间共享 */
+        static TSharedPtr<FLuaScriptArchive, ESPMode::ThreadSafe> Mount(const FString& FilePath);
+
+        ~FLuaScriptArchive();
+
+        FORCEINLINE const FString& GetFilePath() const { return FilePath; }
+
+        FORCEINLINE int32 Num() const { return NumModules; }
+
+        bool Contains(const char* ModuleName) const;
+
+        /** 模块原始数据的CRC32，模块不存在时返回0 */
+        uint32 GetHash(const char* ModuleName) const;
+
+        /**
+         * 获取模块数据，未压缩时直接指向映射内存，压缩时解压到 Scratch
+         * @return 模块不存在或者解压失败时返回false
+         */
+        bool GetData(const char* ModuleName, const char*& OutData, int32& OutSize, TArray<uint8>& Scratch) const;
+
+    private:
+        struct FEntry;
+
+        FLuaScriptArchive() = default;
+
+        bool Open(const FString& InFilePath);
+
+        const FEntry* Find(const char* ModuleName) const;
+
+        FString FilePath;
+        TUniquePtr<IMappedFileHandle> MappedHandle;
+        TUniquePtr<IMappedFileRegion> MappedRegion;
+        TArray<uint8> LoadedData; // when the file can't be mapped
+        const uint8* Data = nullptr;
+        int64 Size = 0;
+        const FEntry* Entries = nullptr;
+        int32 NumModules = 0;
+    };
+}
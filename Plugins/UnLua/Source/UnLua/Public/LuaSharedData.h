@@ -0,0 +1,38 @@
+﻿// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "lua.hpp"
+
+namespace UnLua
+{
+    /**
+     * 跨Lua环境共享的只读数据模块。
+     *
+     * UUnLuaSettings::SharedDataModules 中列出的模块只在第一个require它的环境里执行一次，
+     * 返回的table被展开成紧凑的原生结构（字符串去重），之后每个环境拿到的都是同一份数据的只读代理userdata，
+     * 支持 __index/__len/__pairs。数据里只能有boolean、number、string和table，key只能是number或string。
+     */
+    class UNLUA_API FLuaSharedData
+    {
+    public:
+        /** package.searchers 里的搜索器，排在其它加载器前面，只处理共享数据模块 */
+        static int Searcher(lua_State* L);
+
+        /** 当前所有共享数据模块占用的原生内存，单位字节 */
+        static SIZE_T GetAllocatedSize();
+    };
+}
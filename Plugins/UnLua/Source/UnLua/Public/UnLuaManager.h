@@ -16,6 +16,7 @@
 
 #include "InputCoreTypes.h"
 #include "Engine/DynamicBlueprintBinding.h"
+#include "Engine/EngineBaseTypes.h"
 #include "lua.hpp"
 #include "UnLuaCompatibility.h"
 #include "UnLuaManager.generated.h"
@@ -38,6 +39,9 @@ public:
 
     bool Bind(UObject *Object, const TCHAR *InModuleName, int32 InitializerTableRef = LUA_NOREF);
 
+    /* 延迟绑定的模块，实例在第一次进入Lua时才创建实例表并调用Initialize */
+    bool BindDeferred(UObject *Object);
+
     void NotifyUObjectDeleted(const UObjectBase *Object);
 
     void Cleanup();
@@ -95,6 +99,11 @@ private:
     /* 将一个UClass绑定到Lua模块，根据这个模块定义的函数列表来覆盖上面的UFunction */
     bool BindClass(UClass *Class, const FString &InModuleName, FString &Error);
 
+    /* UClass已经绑定到这个Lua模块，实例可以直接使用绑定时复制的模块表 */
+    bool IsClassBound(UClass *Class, const TCHAR *InModuleName) const;
+
+    bool BindInstance(UObject *Object, int32 InitializerTableRef);
+
     void ReplaceActionInputs(AActor *Actor, UInputComponent *InputComponent, TSet<FName> &LuaFunctions);
     void ReplaceKeyInputs(AActor *Actor, UInputComponent *InputComponent, TSet<FName> &LuaFunctions);
     void ReplaceAxisInputs(AActor *Actor, UInputComponent *InputComponent, TSet<FName> &LuaFunctions);
@@ -108,6 +117,10 @@ private:
         UClass* Class;
         FString ModuleName;
         int TableRef;
+        bool bLazy;
+        bool bBatchTick;
+        TEnumAsByte<ETickingGroup> TickGroup;
+        float TickInterval;
         TSet<FName> LuaFunctions;
         TMap<FName, UFunction*> UEFunctions;
     };
@@ -51,6 +51,30 @@ public:
     UPROPERTY(Config, EditAnywhere, Category=Runtime, Meta=(AllowAbstract="false", DisplayName="LuaModuleLocator"))
     TSubclassOf<ULuaModuleLocator> ModuleLocatorClass = ULuaModuleLocator::StaticClass();
 
+    /** Create the lua instance of a bound object the first time lua uses it, instead of when the object is created. Modules can override it with a '__LazyBind' field. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    bool bLazyInstanceBinding = false;
+
+    /** Data-only modules loaded once and shared read-only by every lua env, instead of being required again in each env. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    TArray<FString> SharedDataModules;
+
+    /** Modules read and compiled on worker threads when a lua env starts, so their first require skips file reading and parsing. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    TArray<FString> PreloadModules;
+
+    /** Also preload the modules of every loaded class implementing UnLuaInterface, as located by the module locator. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    bool bPreloadBoundModules = false;
+
+    /** Script archives relative to the project directory, searched after custom loaders and before loose files. Later archives win, so patch archives go last. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime")
+    TArray<FString> ScriptArchives;
+
+    /** Finished coroutines kept for reuse by UnLua.Spawn, per lua env. */
+    UPROPERTY(Config, EditAnywhere, Category="Runtime", meta=(ClampMin="0"))
+    int32 CoroutinePoolSize = 256;
+
     /** List of classes to bind on startup. */
     UPROPERTY(config, EditAnywhere, Category=Runtime, meta = (MetaClass="Object", AllowAbstract="True", DisplayName = "List of classes to bind on startup"))
     TArray<FSoftClassPath> PreBindClasses;
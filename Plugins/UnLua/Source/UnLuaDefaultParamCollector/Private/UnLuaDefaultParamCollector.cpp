@@ -72,29 +72,7 @@ public:
     virtual void Initialize(const FString& RootLocalPath, const FString& RootBuildPath, const FString& OutputDirectory, const FString& IncludeBase) override
     {
         GeneratedFileContent.Empty();
-
-        GeneratedFileContent += FString::Printf(TEXT("FFunctionCollection* FC = nullptr;\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FParameterCollection* PC = nullptr;\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FBoolParamValue* SharedBool_TRUE = new FBoolParamValue(true);\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FBoolParamValue* SharedBool_FALSE = new FBoolParamValue(false);\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FFloatParamValue* SharedFloat_Zero = new FFloatParamValue(0.000000f);\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FFloatParamValue* SharedFloat_One = new FFloatParamValue(1.000000f);\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FEnumParamValue* SharedEnum_Zero = new FEnumParamValue(0);\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FIntParamValue* SharedInt_Zero = new FIntParamValue(0);\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FByteParamValue* SharedByte_Zero = new FByteParamValue(0);\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FNameParamValue* SharedFName_None = new FNameParamValue(FName(\"None\"));\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FVectorParamValue* SharedFVector_Zero = new FVectorParamValue(FVector(EForceInit::ForceInitToZero));\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FVector2DParamValue* SharedFVector2D_Zero = new FVector2DParamValue(FVector2D(EForceInit::ForceInitToZero));\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FRotatorParamValue* SharedFRotator_Zero = new FRotatorParamValue(FRotator(EForceInit::ForceInitToZero));\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FLinearColorParamValue* SharedFLinearColor_Zero = new FLinearColorParamValue(FLinearColor(EForceInit::ForceInitToZero));\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FColorParamValue* SharedFColor_Zero = new FColorParamValue(FColor(EForceInit::ForceInitToZero));\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FScriptArrayParamValue* SharedScriptArray = new FScriptArrayParamValue();\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FScriptDelegateParamValue* SharedScriptDelegate = new FScriptDelegateParamValue(FScriptDelegate());\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("FMulticastScriptDelegateParamValue* SharedMulticastScriptDelegate = new FMulticastScriptDelegateParamValue(FMulticastScriptDelegate());\r\n"));
-        GeneratedFileContent += FString::Printf(TEXT("\r\n"));
+        Slots.Empty();
 
         OutputDir = OutputDirectory;
     }
@@ -112,7 +90,6 @@ public:
         for (TFieldIterator<UFunction> FuncIt(Class, EFieldIteratorFlags::ExcludeSuper, EFieldIteratorFlags::ExcludeDeprecated); FuncIt; ++FuncIt)
         {
             UFunction* Function = *FuncIt;
-            CurrentFunctionName.Empty();
 
             // filter out functions without meta data
             TMap<FName, FString>* MetaMap = UMetaData::GetMapForObject(Function);
@@ -131,8 +108,9 @@ public:
                 // GeneratedFileContent += FString::Printf(TEXT("// DEBUG %s AutoCreateRefTerm=%s \r\n"), *Function->GetName(), *AutoCreateRefTerm);
             }
 
-            // parameters
-            for (TFieldIterator<FProperty> It(Function); It && (It->HasAnyPropertyFlags(CPF_Parm) && !It->HasAnyPropertyFlags(CPF_ReturnParm)); ++It)
+            // parameters, the index is the position among the parameters so the runtime does not look them up by name
+            int32 ParamIndex = 0;
+            for (TFieldIterator<FProperty> It(Function); It && (It->HasAnyPropertyFlags(CPF_Parm) && !It->HasAnyPropertyFlags(CPF_ReturnParm)); ++It, ++ParamIndex)
             {
                 FProperty* Property = *It;
                 FString ValueStr;
@@ -164,8 +142,7 @@ public:
                     {
                         if(ValueStr.IsEmpty())
                         {
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFVector_Zero);\r\n"), *Property->GetName());
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Vector"));
                         }
                         else
                         {
@@ -176,8 +153,7 @@ public:
                                 float X = TCString<TCHAR>::Atof(*Values[0]);
                                 float Y = TCString<TCHAR>::Atof(*Values[1]);
                                 float Z = TCString<TCHAR>::Atof(*Values[2]);
-                                PreAddProperty(Class, Function);
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FVectorParamValue(FVector(%ff,%ff,%ff)));\r\n"), *Property->GetName(), X, Y, Z);
+                                AddSlot(Class, Function, ParamIndex, Property, TEXT("Vector"), FString::Printf(TEXT("%f, %f, %f"), X, Y, Z));
                             }
                         }
                     }
@@ -185,8 +161,7 @@ public:
                     {
                         if(ValueStr.IsEmpty())
                         {
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFRotator_Zero);\r\n"), *Property->GetName());
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Rotator"));
                         }
                         else
                         {
@@ -197,9 +172,7 @@ public:
                                 float Pitch = TCString<TCHAR>::Atof(*Values[0]);
                                 float Yaw = TCString<TCHAR>::Atof(*Values[1]);
                                 float Roll = TCString<TCHAR>::Atof(*Values[2]);
-                                PreAddProperty(Class, Function);
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FRotatorParamValue(FRotator(%ff,%ff,%ff)));\r\n"),
-                                                                        *Property->GetName(), Pitch, Yaw, Roll);
+                                AddSlot(Class, Function, ParamIndex, Property, TEXT("Rotator"), FString::Printf(TEXT("%f, %f, %f"), Pitch, Yaw, Roll));
                             }
                         }
                     }
@@ -207,47 +180,39 @@ public:
                     {
                         if(ValueStr.IsEmpty())
                         {
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFVector2D_Zero);\r\n"), *Property->GetName());
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Vector2D"));
                         }
                         else
                         {
                             FVector2D Value;
                             Value.InitFromString(ValueStr);
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FVector2DParamValue(FVector2D(%ff,%ff)));\r\n"), *Property->GetName(), Value.X, Value.Y);
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Vector2D"), FString::Printf(TEXT("%f, %f"), Value.X, Value.Y));
                         }
                     }
                     else if (StructProperty->Struct == LinearColorStruct) // FLinearColor
                     {
                         if(ValueStr.IsEmpty())
                         {
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFLinearColor_Zero);\r\n"), *Property->GetName());
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("LinearColor"));
                         }
                         else
                         {
                             FLinearColor Value;
                             Value.InitFromString(ValueStr);
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FLinearColorParamValue(FLinearColor(%ff,%ff,%ff,%ff)));\r\n"),
-                                                                    *Property->GetName(), Value.R, Value.G, Value.B, Value.A);    
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("LinearColor"), FString::Printf(TEXT("%f, %f, %f, %f"), Value.R, Value.G, Value.B, Value.A));
                         }
                     }
                     else if (StructProperty->Struct == ColorStruct) // FColor
                     {
                         if(ValueStr.IsEmpty())
                         {
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFColor_Zero);\r\n"), *Property->GetName());
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Color"));
                         }
                         else
                         {
                             FColor Value;
                             Value.InitFromString(ValueStr);
-                            PreAddProperty(Class, Function);
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FColorParamValue(FColor(%d,%d,%d,%d)));\r\n"),
-                                                                    *Property->GetName(), Value.R, Value.G, Value.B, Value.A);   
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Color"), FString::Printf(TEXT("%d, %d, %d, %d"), Value.R, Value.G, Value.B, Value.A));
                         }
                     }
                 }
@@ -256,11 +221,7 @@ public:
                     if (Property->IsA(FIntProperty::StaticClass())) // int
                     {
                         int32 Value = TCString<TCHAR>::Atoi(*ValueStr);
-                        PreAddProperty(Class, Function);
-                        if (Value == 0)
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedInt_Zero);\r\n"), *Property->GetName(), Value);
-                        else
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FIntParamValue(%d));\r\n"), *Property->GetName(), Value);
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("Int"), FString::Printf(TEXT("%d"), Value));
                     }
                     else if (Property->IsA(FByteProperty::StaticClass())) // byte
                     {
@@ -268,29 +229,20 @@ public:
                         if(Enum)
                         {
                             int64 Value = Enum->GetValueByNameString(ValueStr);
-                            PreAddProperty(Class, Function);
-                            if (Value == 0)
-                            {
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedByte_Zero);\r\n"), *Property->GetName(), Value);
-                            }
-                            else if (Value > 0 && Value <= 255)
+                            if (Value >= 0 && Value <= 255)
                             {
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FByteParamValue(%d));\r\n"), *Property->GetName(), Value);
+                                AddSlot(Class, Function, ParamIndex, Property, TEXT("Byte"), FString::Printf(TEXT("%lld"), Value));
                             }
                             else
                             {
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FRuntimeEnumParamValue(\"%s\",%d));\r\n"), *Property->GetName(), *Enum->CppType, Enum->GetIndexByNameString(ValueStr));
+                                AddSlot(Class, Function, ParamIndex, Property, TEXT("RuntimeEnum"), FString::Printf(TEXT("%d"), Enum->GetIndexByNameString(ValueStr)), FString::Printf(TEXT("TEXT(\"%s\")"), *Enum->CppType));
                             }
                         }
                         else
                         {
                             int32 Value = TCString<TCHAR>::Atoi(*ValueStr);
                             check(Value >= 0 && Value <= 255)
-                            PreAddProperty(Class, Function);
-                            if (Value == 0)
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedByte_Zero);\r\n"), *Property->GetName(), Value);
-                            else
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FByteParamValue(%d));\r\n"), *Property->GetName(), Value);
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Byte"), FString::Printf(TEXT("%d"), Value));
                         }
                     }
                     else if (Property->IsA(FEnumProperty::StaticClass())) // enum
@@ -299,118 +251,83 @@ public:
                         if(Enum)
                         {
                             int64 Value = Enum->GetValueByNameString(ValueStr);
-                            PreAddProperty(Class, Function);
-                            if (Value == 0)
-                            {
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedEnum_Zero);\r\n"), *Property->GetName(), Value);
-                            }
-                            else if (Value > 0 && Value <= 255)
+                            if (Value >= 0 && Value <= 255)
                             {
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FEnumParamValue(%ld));\r\n"), *Property->GetName(), Value);
+                                AddSlot(Class, Function, ParamIndex, Property, TEXT("Enum"), FString::Printf(TEXT("%lld"), Value));
                             }
                             else
                             {
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FRuntimeEnumParamValue(\"%s\",%d));\r\n"), *Property->GetName(), *Enum->CppType, Enum->GetIndexByNameString(ValueStr));
+                                AddSlot(Class, Function, ParamIndex, Property, TEXT("RuntimeEnum"), FString::Printf(TEXT("%d"), Enum->GetIndexByNameString(ValueStr)), FString::Printf(TEXT("TEXT(\"%s\")"), *Enum->CppType));
                             }
                         }
                         else
                         {
                             int64 Value = TCString<TCHAR>::Atoi64(*ValueStr);
-                            PreAddProperty(Class, Function);
-                            if (Value == 0)
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedEnum_Zero);\r\n"), *Property->GetName(), Value);
-                            else
-                                GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FEnumParamValue(%ld));\r\n"), *Property->GetName(), Value);
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Enum"), FString::Printf(TEXT("%lld"), Value));
                         }
                     }
                     else if (Property->IsA(FFloatProperty::StaticClass())) // float
                     {
                         float Value = TCString<TCHAR>::Atof(*ValueStr);
-                        PreAddProperty(Class, Function);
-                        if (FMath::IsNearlyZero(Value))
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFloat_Zero);\r\n"), *Property->GetName(), Value);
-                        else if (FMath::IsNearlyEqual(Value, 1))
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFloat_One);\r\n"), *Property->GetName(), Value);
-                        else
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FFloatParamValue(%ff));\r\n"), *Property->GetName(), Value);
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("Float"), FString::Printf(TEXT("%f"), Value));
                     }
                     else if (Property->IsA(FDoubleProperty::StaticClass())) // double
                     {
                         double Value = TCString<TCHAR>::Atod(*ValueStr);
-                        PreAddProperty(Class, Function);
-                        GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FDoubleParamValue(%lf));\r\n"), *Property->GetName(), Value);
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("Double"), FString::Printf(TEXT("%lf"), Value));
                     }
                     else if (Property->IsA(FBoolProperty::StaticClass())) // boolean
                     {
-                        PreAddProperty(Class, Function);
-                        if (ValueStr.IsEmpty())
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedBool_FALSE);\r\n"), *Property->GetName());
-                        else
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedBool_%s);\r\n"), *Property->GetName(), *ValueStr.ToUpper());
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("Bool"), ValueStr.ToBool() ? TEXT("1") : TEXT("0"));
                     }
                     else if (Property->IsA(FNameProperty::StaticClass())) // FName
                     {
-                        PreAddProperty(Class, Function);
-                        if (ValueStr == "None")
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedFName_None);\r\n"), *Property->GetName(), *ValueStr);
-                        else
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FNameParamValue(FName(\"%s\")));\r\n"), *Property->GetName(), *ValueStr);
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("Name"), TEXT("0"), FString::Printf(TEXT("TEXT(\"%s\")"), *ValueStr));
                     }
                     else if (Property->IsA(FTextProperty::StaticClass())) // FText
                     {
-                        PreAddProperty(Class, Function);
 #if ENGINE_MAJOR_VERSION > 4 || (ENGINE_MAJOR_VERSION == 4 && ENGINE_MINOR_VERSION > 20)
-                        if (ValueStr.StartsWith(TEXT("INVTEXT(\"")))
+                        if (ValueStr.StartsWith(TEXT("INVTEXT(\"")) && ValueStr.EndsWith(TEXT("\")")))
                         {
-                            GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FTextParamValue(%s));\r\n"), *Property->GetName(), *ValueStr);
+                            // INVTEXT("...") becomes TEXT("...") built as a culture invariant text
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("InvariantText"), TEXT("0"), FString::Printf(TEXT("TEXT(%s)"), *ValueStr.Mid(8, ValueStr.Len() - 9)));
                         }
                         else
 #endif
                         {
-                            GeneratedFileContent += FString::Printf(
-                                TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FTextParamValue(FText::FromString(TEXT(\"%s\"))));\r\n"), *Property->GetName(), *ValueStr);
+                            AddSlot(Class, Function, ParamIndex, Property, TEXT("Text"), TEXT("0"), FString::Printf(TEXT("TEXT(\"%s\")"), *ValueStr));
                         }
                     }
                     else if (Property->IsA(FStrProperty::StaticClass())) // FString
                     {
-                        PreAddProperty(Class, Function);
-                        GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), new FStringParamValue(TEXT(\"%s\")));\r\n"), *Property->GetName(), *ValueStr);
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("String"), TEXT("0"), FString::Printf(TEXT("TEXT(\"%s\")"), *ValueStr));
                     }
                     else if (Property->IsA(FArrayProperty::StaticClass()))
                     {
-                        PreAddProperty(Class, Function);
-                        GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedScriptArray);\r\n"), *Property->GetName());
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("ScriptArray"));
                     }
                     else if (Property->IsA(FDelegateProperty::StaticClass()))
                     {
-                        PreAddProperty(Class, Function);
-                        GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedScriptDelegate);\r\n"), *Property->GetName());
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("ScriptDelegate"));
                     }
                     else if (Property->IsA(FMulticastDelegateProperty::StaticClass()))
                     {
-                        PreAddProperty(Class, Function);
-                        GeneratedFileContent += FString::Printf(TEXT("PC->Parameters.Add(TEXT(\"%s\"), SharedMulticastDelegate);\r\n"), *Property->GetName());
+                        AddSlot(Class, Function, ParamIndex, Property, TEXT("MulticastScriptDelegate"));
                     }
                 }
             }
         }
-
-        if (CurrentClassName.Len() > 0)
-        {
-            CurrentClassName.Empty();
-            CurrentFunctionName.Empty();
-
-            GeneratedFileContent += TEXT("\r\n");
-        }
     }
 
     virtual void FinishExport() override
     {
-        const FString FilePath = FString::Printf(TEXT("%s%s"), *OutputDir, TEXT("DefaultParamCollection.inl"));
+        WriteTables();
+
+        const FString FilePath = FString::Printf(TEXT("%s%s"), *OutputDir, TEXT("DefaultParamTable.inl"));
         FString FileContent;
         FFileHelper::LoadFileToString(FileContent, *FilePath);
 
-        // If Current build Game Project, try to update DefaultParamCollection.inl file for project
+        // If Current build Game Project, try to update DefaultParamTable.inl file for project
         if (HasGameRuntime)
         {
             if (GeneratedFileContent != FileContent)
@@ -421,8 +338,8 @@ public:
         }
         else
         {
-            // If Current build Engine Project, try create new file if has no DefaultParamCollection.inl to fix compile error
-            // or do not update DefaultParamCollection.inl file if exists
+            // If Current build Engine Project, try create new file if has no DefaultParamTable.inl to fix compile error
+            // or do not update DefaultParamTable.inl file if exists
             if (!FPaths::FileExists(FilePath) || FileContent.Len() == 0)
             {
                 bool bResult = FFileHelper::SaveStringToFile(GeneratedFileContent, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
@@ -437,18 +354,40 @@ public:
     }
 
 private:
-    void PreAddProperty(UClass* Class, UFunction* Function)
+    void AddSlot(UClass* Class, UFunction* Function, int32 ParamIndex, const FProperty* Property, const TCHAR* Type, const FString& Numbers = TEXT("0"), const FString& String = TEXT("nullptr"))
     {
-        if (CurrentClassName.Len() < 1)
-        {
-            CurrentClassName = FString::Printf(TEXT("%s%s"), Class->GetPrefixCPP(), *Class->GetName());
-            GeneratedFileContent += FString::Printf(TEXT("FC = &GDefaultParamCollection.Add(TEXT(\"%s\"));\r\n"), *CurrentClassName);
-        }
-        if (CurrentFunctionName.Len() < 1)
+        const FString ClassName = FString::Printf(TEXT("%s%s"), Class->GetPrefixCPP(), *Class->GetName());
+        TArray<FString>& FunctionSlots = Slots.FindOrAdd(ClassName).FindOrAdd(Function->GetName());
+        FunctionSlots.Add(FString::Printf(TEXT("{%d, TEXT(\"%s\"), EDefaultParamType::%s, {%s}, %s},\r\n"), ParamIndex, *Property->GetName(), Type, *Numbers, *String));
+    }
+
+    /** Append the classes, functions and slots as constant arrays, class and function names sorted for the runtime binary search */
+    void WriteTables()
+    {
+        FString ClassTable, FunctionTable, SlotTable;
+        int32 NumFunctions = 0;
+        int32 NumSlots = 0;
+
+        const auto ByChar = [](const FString& A, const FString& B) { return A.Compare(B, ESearchCase::CaseSensitive) < 0; };
+        Slots.KeySort(ByChar);
+        for (TPair<FString, TMap<FString, TArray<FString>>>& Class : Slots)
         {
-            CurrentFunctionName = Function->GetName();
-            GeneratedFileContent += FString::Printf(TEXT("PC = &FC->Functions.Add(TEXT(\"%s\"));\r\n"), *CurrentFunctionName);
+            ClassTable += FString::Printf(TEXT("{TEXT(\"%s\"), %d, %d},\r\n"), *Class.Key, NumFunctions, Class.Value.Num());
+            Class.Value.KeySort(ByChar);
+            for (const TPair<FString, TArray<FString>>& Function : Class.Value)
+            {
+                FunctionTable += FString::Printf(TEXT("{TEXT(\"%s\"), %d, %d},\r\n"), *Function.Key, NumSlots, Function.Value.Num());
+                for (const FString& Slot : Function.Value)
+                    SlotTable += Slot;
+                NumSlots += Function.Value.Num();
+                ++NumFunctions;
+            }
         }
+
+        // every array ends with an empty entry so none of them is ever empty
+        GeneratedFileContent += TEXT("\r\nstatic constexpr FDefaultParamClassEntry GDefaultParamClasses[] = {\r\n") + ClassTable + TEXT("{}\r\n};\r\n");
+        GeneratedFileContent += TEXT("\r\nstatic constexpr FDefaultParamFunctionEntry GDefaultParamFunctions[] = {\r\n") + FunctionTable + TEXT("{}\r\n};\r\n");
+        GeneratedFileContent += TEXT("\r\nstatic constexpr FDefaultParamSlot GDefaultParamSlots[] = {\r\n") + SlotTable + TEXT("{}\r\n};\r\n");
     }
 
     void ParseModule(const FString& ModuleName, EBuildModuleType::Type ModuleType, const FString& ModuleGeneratedIncludeDirectory)
@@ -463,8 +402,7 @@ private:
 
     bool HasGameRuntime; // Flag for if current uht has GameRuntime module or not
     FString OutputDir;
-    FString CurrentClassName;
-    FString CurrentFunctionName;
+    TMap<FString, TMap<FString, TArray<FString>>> Slots; // class -> function -> slot initializers
     FString GeneratedFileContent;
 };
 
@@ -27,32 +27,8 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
             Factory = factory;
             Borrower = new BorrowStringBuilder(StringBuilderCache.Big);
             bHasGameRuntime = false;
-            bCurrentClassWritten = false;
-            bCurrentFunctionWritten = false;
 
             GeneratedContentBuilder.Append("// Generated By C# UbtPlugin\r\n");
-            GeneratedContentBuilder.Append("FFunctionCollection* FC = nullptr;\r\n");
-            GeneratedContentBuilder.Append("FParameterCollection* PC = nullptr;\r\n");
-            GeneratedContentBuilder.Append("\r\n");
-            GeneratedContentBuilder.Append("FBoolParamValue* SharedBool_TRUE = new FBoolParamValue(true);\r\n");
-            GeneratedContentBuilder.Append("FBoolParamValue* SharedBool_FALSE = new FBoolParamValue(false);\r\n");
-            GeneratedContentBuilder.Append("FFloatParamValue* SharedFloat_Zero = new FFloatParamValue(0.000000f);\r\n");
-            GeneratedContentBuilder.Append("FFloatParamValue* SharedFloat_One = new FFloatParamValue(1.000000f);\r\n");
-            GeneratedContentBuilder.Append("FEnumParamValue* SharedEnum_Zero = new FEnumParamValue(0);\r\n");
-            GeneratedContentBuilder.Append("FIntParamValue* SharedInt_Zero = new FIntParamValue(0);\r\n");
-            GeneratedContentBuilder.Append("FByteParamValue* SharedByte_Zero = new FByteParamValue(0);\r\n");
-            GeneratedContentBuilder.Append("FNameParamValue* SharedFName_None = new FNameParamValue(FName(\"None\"));\r\n");
-            GeneratedContentBuilder.Append("\r\n");
-            GeneratedContentBuilder.Append("FVectorParamValue* SharedFVector_Zero = new FVectorParamValue(FVector(EForceInit::ForceInitToZero));\r\n");
-            GeneratedContentBuilder.Append("FVector2DParamValue* SharedFVector2D_Zero = new FVector2DParamValue(FVector2D(EForceInit::ForceInitToZero));\r\n");
-            GeneratedContentBuilder.Append("FRotatorParamValue* SharedFRotator_Zero = new FRotatorParamValue(FRotator(EForceInit::ForceInitToZero));\r\n");
-            GeneratedContentBuilder.Append("FLinearColorParamValue* SharedFLinearColor_Zero = new FLinearColorParamValue(FLinearColor(EForceInit::ForceInitToZero));\r\n");
-            GeneratedContentBuilder.Append("FColorParamValue* SharedFColor_Zero = new FColorParamValue(FColor(EForceInit::ForceInitToZero));\r\n");
-            GeneratedContentBuilder.Append("\r\n");
-            GeneratedContentBuilder.Append("FScriptArrayParamValue* SharedScriptArray = new FScriptArrayParamValue();\r\n");
-            GeneratedContentBuilder.Append("FScriptDelegateParamValue* SharedScriptDelegate = new FScriptDelegateParamValue(FScriptDelegate());\r\n");
-            GeneratedContentBuilder.Append("FMulticastScriptDelegateParamValue* SharedMulticastScriptDelegate = new FMulticastScriptDelegateParamValue(FMulticastScriptDelegate());\r\n");
-            GeneratedContentBuilder.Append("\r\n");
         }
 
         private void Generate()
@@ -103,11 +79,6 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
                     ExportFunction(classObj, function);
                 }
             }
-            if (bCurrentClassWritten)
-            {
-                bCurrentClassWritten = false;
-                GeneratedContentBuilder.Append("\r\n");
-            }
         }
 
         private bool CanExportFunction(UhtFunction function)
@@ -118,7 +89,6 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
 
         private void ExportFunction(UhtClass classObj, UhtFunction function)
         {
-            bCurrentFunctionWritten = false;
             var metaData = function.MetaData;
             var autoCreateRefTerm = metaData.GetValueOrDefault("AutoCreateRefTerm");
             var autoEmitParameterNames = new string[] {};
@@ -131,11 +101,14 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
                 }
             }
 
+            // the index is the position among the parameters, the runtime resolves default values by it
+            CurrentParamIndex = 0;
             foreach (UhtType child in function.Children)
             {
                 if (child is UhtProperty property && CanExportParamProperty(classObj, property))
                 {
                     ExportParamProperty(classObj, function, property, metaData, autoEmitParameterNames);
+                    CurrentParamIndex++;
                 }
             }
         }
@@ -162,16 +135,14 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
                 {
                     if (string.IsNullOrEmpty(valueStr))
                     {
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFVector_Zero);\r\n", property.SourceName);
+                        AddSlot(classObj, function, property, "Vector");
                     }
                     else
                     {
                         var values = valueStr.Split(",").Select(float.Parse).ToArray();
                         if (values.Length == 3)
                         {
-                            PreAddProperty(classObj, function);
-                            GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FVectorParamValue(FVector({1:F6}f,{2:F6}f,{3:F6}f)));\r\n", property.SourceName, values[0], values[1], values[2]);
+                            AddSlot(classObj, function, property, "Vector", FormatNumbers(values));
                         }
                     }
                 }
@@ -179,16 +150,14 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
                 {
                     if (string.IsNullOrEmpty(valueStr))
                     {
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFRotator_Zero);\r\n", property.SourceName);
+                        AddSlot(classObj, function, property, "Rotator");
                     }
                     else
                     {
                         var values = valueStr.Split(",").Select(float.Parse).ToArray();
                         if (values.Length == 3)
                         {
-                            PreAddProperty(classObj, function);
-                            GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FRotatorParamValue(FRotator({1:F6}f,{2:F6}f,{3:F6}f)));\r\n", property.SourceName, values[0], values[1], values[2]);
+                            AddSlot(classObj, function, property, "Rotator", FormatNumbers(values));
                         }
                     }
                 }
@@ -196,59 +165,43 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
                 {
                     if (string.IsNullOrEmpty(valueStr))
                     {
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFVector2D_Zero);\r\n", property.SourceName);
+                        AddSlot(classObj, function, property, "Vector2D");
                     }
                     else
                     {
                         var values = Regex.Split(valueStr, @"[^\d.]+").Where(x => !string.IsNullOrEmpty(x)).Select(float.Parse).ToArray();
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FVector2DParamValue(FVector2D({1:F6}f,{2:F6}f)));\r\n", property.SourceName, values[0], values[1]);
+                        AddSlot(classObj, function, property, "Vector2D", FormatNumbers(values[0], values[1]));
                     }
                 }
                 else if (structTypeName.Equals("LinearColor"))
                 {
                     if (string.IsNullOrEmpty(valueStr))
                     {
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFLinearColor_Zero);\r\n", property.SourceName);
+                        AddSlot(classObj, function, property, "LinearColor");
                     }
                     else
                     {
                         var values = Regex.Split(valueStr, @"[^\d.]+").Where(x => !string.IsNullOrEmpty(x)).Select(float.Parse).ToArray();
-
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FLinearColorParamValue(FLinearColor({1:F6}f,{2:F6}f,{3:F6}f,{4:F6}f)));\r\n", property.SourceName, values[0], values[1], values[2], values[3]);
+                        AddSlot(classObj, function, property, "LinearColor", FormatNumbers(values[0], values[1], values[2], values[3]));
                     }
                 }
                 else if (structTypeName.Equals("Color"))
                 {
                     if (string.IsNullOrEmpty(valueStr))
                     {
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFColor_Zero);\r\n", property.SourceName);
+                        AddSlot(classObj, function, property, "Color");
                     }
                     else
                     {
                         var values = Regex.Split(valueStr, @"[^\d.]+").Where(x => !string.IsNullOrEmpty(x)).ToArray();
-
-                        PreAddProperty(classObj, function);
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FColorParamValue(FColor({1},{2},{3},{4})));\r\n", property.SourceName, values[0], values[1], values[2], values[3]);
+                        AddSlot(classObj, function, property, "Color", string.Join(", ", values.Take(4)));
                     }
                 }
             }
             else if (property is UhtIntProperty)
             {
                 int.TryParse(valueStr, out var value);
-                PreAddProperty(classObj, function);
-                if (value == 0)
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedInt_Zero);\r\n", property.SourceName);
-                }
-                else
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FIntParamValue({1}));\r\n", property.SourceName, value);
-                }
+                AddSlot(classObj, function, property, "Int", value.ToString(CultureInfo.InvariantCulture));
             }
             else if (property is UhtByteProperty byteProperty)
             {
@@ -256,33 +209,19 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
                 {
                     var index = byteProperty.Enum.GetIndexByName(valueStr);
                     var value = index == -1 ? -1 : byteProperty.Enum.EnumValues[index].Value;
-            
-                    PreAddProperty(classObj, function);
-                    if (value == 0)
-                    {
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedByte_Zero);\r\n", property.SourceName);
-                    }
-                    else if (value is > 0 and <= 255)
+                    if (value is >= 0 and <= 255)
                     {
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FByteParamValue({1}));\r\n", property.SourceName, value);
+                        AddSlot(classObj, function, property, "Byte", value.ToString(CultureInfo.InvariantCulture));
                     }
                     else
                     {
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FRuntimeEnumParamValue(\"{1}\",{2}));\r\n", property.SourceName, byteProperty.Enum.CppType, index);
+                        AddSlot(classObj, function, property, "RuntimeEnum", index.ToString(CultureInfo.InvariantCulture), "TEXT(\"" + byteProperty.Enum.CppType + "\")");
                     }
                 }
                 else
                 {
                     int.TryParse(valueStr, out var value);
-                    PreAddProperty(classObj, function);
-                    if (value == 0)
-                    {
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedByte_Zero);\r\n", property.SourceName);
-                    }
-                    else
-                    {
-                        GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FByteParamValue({1}));\r\n", property.SourceName, value);
-                    }
+                    AddSlot(classObj, function, property, "Byte", value.ToString(CultureInfo.InvariantCulture));
                 }
             }
             else if (property is UhtEnumProperty enumProperty)
@@ -290,108 +229,117 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
                 // [Mark]: A ByteProperty in C++ may be recognized as EnumProperty in C#, its UnderlyingProperty is null
                 var index = enumProperty.Enum.GetIndexByName(valueStr);
                 var value = index == -1 ? -1 : enumProperty.Enum.EnumValues[index].Value;
-                
-                PreAddProperty(classObj, function);
                 var isFakeEnum = enumProperty.UnderlyingProperty == null;
-                if (value == 0)
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), {1});\r\n", property.SourceName, isFakeEnum ? "SharedByte_Zero" : "SharedEnum_Zero");
-                }
-                else if (value is > 0 and <= 255)
+                if (value is >= 0 and <= 255)
                 {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new {1}({2}));\r\n", property.SourceName, isFakeEnum ? "FByteParamValue" : "FEnumParamValue", value);
+                    AddSlot(classObj, function, property, isFakeEnum ? "Byte" : "Enum", value.ToString(CultureInfo.InvariantCulture));
                 }
                 else
                 {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FRuntimeEnumParamValue(\"{1}\",{2}));\r\n", property.SourceName, enumProperty.Enum.CppType, index);
+                    AddSlot(classObj, function, property, "RuntimeEnum", index.ToString(CultureInfo.InvariantCulture), "TEXT(\"" + enumProperty.Enum.CppType + "\")");
                 }
             }
             else if (property is UhtFloatProperty)
             {
                 // 1.f is not valid in C#
                 float.TryParse(valueStr.Replace(".f", ""), out var value);
-                PreAddProperty(classObj, function);
-                if (Math.Abs(value) < 1E-8)
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFloat_Zero);\r\n", property.SourceName);
-                }
-                else if (Math.Abs(value - 1) < 1E-8)
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFloat_One);\r\n", property.SourceName);
-                }
-                else
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FFloatParamValue({1:F6}f));\r\n", property.SourceName, value);
-                }
+                AddSlot(classObj, function, property, "Float", FormatNumbers(value));
             }
             else if (property is UhtDoubleProperty)
             {
-                PreAddProperty(classObj, function);
-                GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FDoubleParamValue({1:F6}));\r\n", property.SourceName, double.Parse(valueStr));
+                AddSlot(classObj, function, property, "Double", FormatNumbers(double.Parse(valueStr)));
             }
             else if (property is UhtBoolProperty)
             {
-                PreAddProperty(classObj, function);
-                GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedBool_{1});\r\n", property.SourceName, valueStr.ToUpper());
+                AddSlot(classObj, function, property, "Bool", valueStr.Equals("true", StringComparison.OrdinalIgnoreCase) ? "1" : "0");
             }
             else if (property is UhtNameProperty)
             {
-                PreAddProperty(classObj, function);
-                if (valueStr.Equals("None"))
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedFName_None);\r\n", property.SourceName);
-                }
-                else
-                {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FNameParamValue(FName(\"{1}\")));\r\n", property.SourceName, valueStr);
-                }
+                AddSlot(classObj, function, property, "Name", "0", "TEXT(\"" + valueStr + "\")");
             }
             else if (property is UhtTextProperty)
             {
-                PreAddProperty(classObj, function);
-                if (valueStr.StartsWith("INVTEXT(\""))
+                if (valueStr.StartsWith("INVTEXT(\"") && valueStr.EndsWith("\")"))
                 {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FTextParamValue({1}));\r\n", property.SourceName, valueStr);
+                    // INVTEXT("...") becomes TEXT("...") built as a culture invariant text
+                    AddSlot(classObj, function, property, "InvariantText", "0", "TEXT(" + valueStr.Substring(8, valueStr.Length - 9) + ")");
                 }
                 else
                 {
-                    GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FTextParamValue(FText::FromString(TEXT(\"{1}\"))));\r\n", property.SourceName, valueStr);
+                    AddSlot(classObj, function, property, "Text", "0", "TEXT(\"" + valueStr + "\")");
                 }
             }
             else if (property is UhtStrProperty)
             {
-                PreAddProperty(classObj, function);
-                GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), new FStringParamValue(TEXT(\"{1}\")));\r\n", property.SourceName, valueStr);
+                AddSlot(classObj, function, property, "String", "0", "TEXT(\"" + valueStr + "\")");
             }
             else if (property is UhtArrayProperty)
             {
-                PreAddProperty(classObj, function);
-                GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedScriptArray);\r\n", property.SourceName);
+                AddSlot(classObj, function, property, "ScriptArray");
             }
             else if (property is UhtDelegateProperty)
             {
-                PreAddProperty(classObj, function);
-                GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedScriptDelegate);\r\n", property.SourceName);
+                AddSlot(classObj, function, property, "ScriptDelegate");
             }
             else if (property is UhtMulticastDelegateProperty)
             {
-                PreAddProperty(classObj, function);
-                GeneratedContentBuilder.AppendFormat("PC->Parameters.Add(TEXT(\"{0}\"), SharedMulticastDelegate);\r\n", property.SourceName);
+                AddSlot(classObj, function, property, "MulticastScriptDelegate");
             }
         }
 
-        private void PreAddProperty(UhtClass classObj, UhtFunction function)
+        private void AddSlot(UhtClass classObj, UhtFunction function, UhtProperty property, string type, string numbers = "0", string str = "nullptr")
         {
-            if (!bCurrentClassWritten)
+            var className = classObj.EngineNamePrefix + classObj.EngineName;
+            if (!Slots.TryGetValue(className, out var functions))
             {
-                bCurrentClassWritten = true;
-                GeneratedContentBuilder.AppendFormat("FC = &GDefaultParamCollection.Add(TEXT(\"{0}\"));\r\n", classObj.EngineNamePrefix + classObj.EngineName);
+                functions = new SortedDictionary<string, List<string>>(StringComparer.Ordinal);
+                Slots.Add(className, functions);
             }
-            if (!bCurrentFunctionWritten)
+            if (!functions.TryGetValue(function.StrippedFunctionName, out var slots))
             {
-                bCurrentFunctionWritten = true;
-                GeneratedContentBuilder.AppendFormat("PC = &FC->Functions.Add(TEXT(\"{0}\"));\r\n", function.StrippedFunctionName);
+                slots = new List<string>();
+                functions.Add(function.StrippedFunctionName, slots);
             }
+            slots.Add(string.Format("{{{0}, TEXT(\"{1}\"), EDefaultParamType::{2}, {{{3}}}, {4}}},\r\n", CurrentParamIndex, property.SourceName, type, numbers, str));
+        }
+
+        private static string FormatNumbers(params double[] values)
+        {
+            return string.Join(", ", values.Select(value => value.ToString("F6", CultureInfo.InvariantCulture)));
+        }
+
+        private static string FormatNumbers(params float[] values)
+        {
+            return FormatNumbers(values.Select(value => (double)value).ToArray());
+        }
+
+        // Append the classes, functions and slots as constant arrays, names are sorted ordinally for the runtime binary search
+        private void WriteTables()
+        {
+            var classTable = new StringBuilder();
+            var functionTable = new StringBuilder();
+            var slotTable = new StringBuilder();
+            var numFunctions = 0;
+            var numSlots = 0;
+            foreach (var classPair in Slots)
+            {
+                classTable.AppendFormat("{{TEXT(\"{0}\"), {1}, {2}}},\r\n", classPair.Key, numFunctions, classPair.Value.Count);
+                foreach (var functionPair in classPair.Value)
+                {
+                    functionTable.AppendFormat("{{TEXT(\"{0}\"), {1}, {2}}},\r\n", functionPair.Key, numSlots, functionPair.Value.Count);
+                    foreach (var slot in functionPair.Value)
+                    {
+                        slotTable.Append(slot);
+                    }
+                    numSlots += functionPair.Value.Count;
+                    numFunctions++;
+                }
+            }
+
+            // every array ends with an empty entry so none of them is ever empty
+            GeneratedContentBuilder.Append("\r\nstatic constexpr FDefaultParamClassEntry GDefaultParamClasses[] = {\r\n").Append(classTable).Append("{}\r\n};\r\n");
+            GeneratedContentBuilder.Append("\r\nstatic constexpr FDefaultParamFunctionEntry GDefaultParamFunctions[] = {\r\n").Append(functionTable).Append("{}\r\n};\r\n");
+            GeneratedContentBuilder.Append("\r\nstatic constexpr FDefaultParamSlot GDefaultParamSlots[] = {\r\n").Append(slotTable).Append("{}\r\n};\r\n");
         }
 
         private static bool FindDefaultValueString(UhtMetaData metaData, UhtProperty property, out string value)
@@ -417,8 +365,9 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
 
         private void Finish()
         {
+            WriteTables();
             var generatedFileContent = GeneratedContentBuilder.ToString();
-            string filePath = Factory.MakePath("DefaultParamCollection", ".inl");
+            string filePath = Factory.MakePath("DefaultParamTable", ".inl");
             
             if (File.Exists(filePath))
             {
@@ -439,8 +388,8 @@ namespace UnLuaDefaultParamCollectorUbtPlugin
         private UhtSession Session => Factory.Session;
 
         private bool bHasGameRuntime;
-        private bool bCurrentClassWritten;
-        private bool bCurrentFunctionWritten;
+        private int CurrentParamIndex;
+        private SortedDictionary<string, SortedDictionary<string, List<string>>> Slots = new(StringComparer.Ordinal); // class -> function -> slot initializers
         private BorrowStringBuilder Borrower;
         private StringBuilder GeneratedContentBuilder => Borrower.StringBuilder;
     }
@@ -0,0 +1,116 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "Commandlets/UnLuaScriptArchiveCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "LuaScriptArchive.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UnLuaBase.h"
+
+UUnLuaScriptArchiveCommandlet::UUnLuaScriptArchiveCommandlet(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+}
+
+int32 UUnLuaScriptArchiveCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Tokens;
+    TArray<FString> Switches;
+    TMap<FString, FString> ParamsMap;
+    ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+    const auto GetParam = [&ParamsMap](const TCHAR* Key, const FString& Default)
+    {
+        const auto Value = ParamsMap.Find(Key);
+        return FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), Value ? *Value : Default);
+    };
+    FString SourceDir = GetParam(TEXT("Source"), TEXT("Content/Script"));
+    FPaths::NormalizeDirectoryName(SourceDir);
+    const FString OutputPath = GetParam(TEXT("Output"), TEXT("Content/Script.ulsa"));
+    const bool bCompress = Switches.Contains(TEXT("Compress"));
+    const bool bStrip = Switches.Contains(TEXT("Strip"));
+    const bool bKeepSource = Switches.Contains(TEXT("KeepSource"));
+
+    TSharedPtr<UnLua::FLuaScriptArchive, ESPMode::ThreadSafe> BaseArchive;
+    if (ParamsMap.Contains(TEXT("Base")))
+    {
+        BaseArchive = UnLua::FLuaScriptArchive::Mount(GetParam(TEXT("Base"), TEXT("")));
+        if (!BaseArchive)
+        {
+            UE_LOG(LogUnLua, Error, TEXT("unable to open base script archive %s"), *ParamsMap[TEXT("Base")]);
+            return 1;
+        }
+    }
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFilesRecursive(Files, *SourceDir, TEXT("*.lua"), true, false);
+    Files.Sort();
+
+    TArray<UnLua::FLuaScriptArchive::FModule> Modules;
+    int32 NumErrors = 0;
+    for (const auto& File : Files)
+    {
+        FString ModuleName = File.Mid(SourceDir.Len() + 1).LeftChop(4);
+        ModuleName.ReplaceInline(TEXT("/"), TEXT("."));
+
+        TArray<uint8> Source;
+        if (!FFileHelper::LoadFileToArray(Source, *File))
+        {
+            UE_LOG(LogUnLua, Error, TEXT("unable to read %s"), *File);
+            NumErrors++;
+            continue;
+        }
+
+        UnLua::FLuaScriptArchive::FModule Module;
+        Module.Name = ModuleName;
+        if (bKeepSource)
+        {
+            Module.Data = MoveTemp(Source);
+        }
+        else
+        {
+            // chunk names relative to the project, the archive is built on another machine than it runs on
+            FString ChunkName = File;
+            FPaths::MakePathRelativeTo(ChunkName, *FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()));
+            FString Error;
+            if (!UnLua::FLuaScriptArchive::Compile(Source, ChunkName, bStrip, Module.Data, Error))
+            {
+                UE_LOG(LogUnLua, Error, TEXT("%s"), *Error);
+                NumErrors++;
+                continue;
+            }
+        }
+
+        if (BaseArchive && BaseArchive->GetHash(TCHAR_TO_UTF8(*ModuleName)) == FCrc::MemCrc32(Module.Data.GetData(), Module.Data.Num()))
+            continue;
+
+        Modules.Add(MoveTemp(Module));
+    }
+
+    if (NumErrors > 0)
+        return 1;
+
+    const int32 NumModules = Modules.Num();
+    if (!UnLua::FLuaScriptArchive::Write(OutputPath, MoveTemp(Modules), bCompress))
+    {
+        UE_LOG(LogUnLua, Error, TEXT("unable to write script archive %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogUnLua, Display, TEXT("%d of %d modules packed into %s"), NumModules, Files.Num(), *OutputPath);
+    return 0;
+}
@@ -19,6 +19,7 @@
 #include "IDirectoryWatcher.h"
 #include "SocketSubsystem.h"
 #include "UnLua.h"
+#include "LuaEnv.h"
 #include "UnLuaEditorSettings.h"
 #include "UnLuaFunctionLibrary.h"
 #include "Common/UdpSocketBuilder.h"
@@ -111,6 +112,15 @@ FString UUnLuaEditorFunctionLibrary::GetCurrentVersion()
 
 void UUnLuaEditorFunctionLibrary::OnLuaFilesModified(const TArray<FFileChangeData>& FileChanges)
 {
+    for (const auto& FileChange : FileChanges)
+    {
+        if (FileChange.Action == FFileChangeData::FCA_Modified)
+            continue;
+        for (const auto& Pair : UnLua::FLuaEnv::GetAll())
+            Pair.Value->ResetModuleFileIndex();
+        break;
+    }
+
     const auto& Settings = *GetDefault<UUnLuaEditorSettings>();
     if (Settings.HotReloadMode != EHotReloadMode::Auto)
         return;
@@ -0,0 +1,37 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "UnLuaScriptArchiveCommandlet.generated.h"
+
+/**
+ * Pack every lua file under a script directory into one script archive.
+ *
+ * -Source=<dir>   scripts to pack, Content/Script by default
+ * -Output=<file>  archive to write, Content/Script.ulsa by default
+ * -Base=<file>    only pack modules whose content differs from this archive, for patches
+ * -Compress       zlib compress modules that get smaller
+ * -Strip          strip debug info from the bytecode
+ * -KeepSource     keep lua source instead of compiling to bytecode
+ */
+UCLASS()
+class UUnLuaScriptArchiveCommandlet : public UCommandlet
+{
+    GENERATED_UCLASS_BODY()
+
+public:
+    virtual int32 Main(const FString& Params) override;
+};
@@ -22,6 +22,11 @@ PB_NS_BEGIN
 #define PB_BUFFER    "pb.Buffer"
 #define PB_SLICE     "pb.Slice"
 
+/* LuaSocket receive slices, the userdata starts with data pointer and
+ * length (see LuaSocket src/slice.h), data is NULL once released */
+#define PB_SOCKETSLICE "slice{}"
+typedef struct lpb_SocketSlice { const char *data; size_t len; } lpb_SocketSlice;
+
 #define check_buffer(L,idx) ((pb_Buffer*)luaL_checkudata(L,idx,PB_BUFFER))
 #define test_buffer(L,idx)  ((pb_Buffer*)luaL_testudata(L,idx,PB_BUFFER))
 #define check_slice(L,idx)  ((pb_Slice*)luaL_checkudata(L,idx,PB_SLICE))
@@ -262,10 +267,14 @@ static pb_Slice lpb_toslice(lua_State *L, int idx) {
     } else if (type == LUA_TUSERDATA) {
         pb_Buffer *buffer;
         pb_Slice *s;
+        lpb_SocketSlice *ss;
         if ((buffer = test_buffer(L, idx)) != NULL)
             return pb_result(buffer);
         else if ((s = test_slice(L, idx)) != NULL)
             return *s;
+        else if ((ss = (lpb_SocketSlice*)luaL_testudata(L, idx, PB_SOCKETSLICE)) != NULL
+                && ss->data != NULL)
+            return pb_lslice(ss->data, ss->len);
     }
     return pb_slice(NULL);
 }
@@ -0,0 +1,742 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+/*
+ * Lua API of 'socket.async', every call except close() has to be made from a coroutine and yields it
+ * until the worker thread has finished the operation:
+ *
+ *   local async = require("socket.async")
+ *   local conn, err = async.connect(host, port[, timeout])
+ *   local sent, err, partial = conn:send(data[, timeout])
+ *   local data, err, partial = conn:receive([pattern = "*l" | "*a" | number][, timeout])
+ *   conn:close()
+ *
+ * Results follow the conventions of the blocking tcp object, timeouts are in seconds.
+ */
+
+#include "LuaAsyncSocket.h"
+#include "HAL/RunnableThread.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#endif
+#include "inet.h"
+#if PLATFORM_WINDOWS
+#include "Windows/HideWindowsPlatformTypes.h"
+#else
+#include <poll.h>
+#endif
+
+EXTENSION_NAMESPACE_BEGIN
+
+#if PLATFORM_WINDOWS
+typedef WSAPOLLFD FPollFd;
+static int PollSockets(FPollFd* Fds, int32 Num, int32 Timeout) { return WSAPoll(Fds, Num, Timeout); }
+#else
+typedef pollfd FPollFd;
+static int PollSockets(FPollFd* Fds, int32 Num, int32 Timeout) { return poll(Fds, Num, Timeout); }
+#endif
+
+static void AddPollFd(TArray<FPollFd>& PollFds, t_socket Fd, short Events)
+{
+    FPollFd& PollFd = PollFds.AddDefaulted_GetRef();
+    PollFd.fd = Fd;
+    PollFd.events = Events;
+    PollFd.revents = 0;
+}
+
+static const char* ConnectionMetatableName = "socket.async{connection}";
+
+static constexpr int32 RecvChunkSize = 64 * 1024;
+
+struct FAsyncSocketConnection
+{
+    int32 SocketId;
+    bool bClosed;
+};
+
+struct FAsyncSocketWorker::FSocketState
+{
+    t_socket Fd = SOCKET_INVALID;
+    bool bConnecting = false;
+    bool bFailed = false;
+    bool bDirty = true;
+    short Revents = 0;
+    int32 PeerError = IO_DONE; // set once the peer has closed the connection or it broke
+    FRequest ConnectRequest;
+    TArray<FRequest> Sends;
+    int64 SendOffset = 0;
+    TArray<FRequest> Receives;
+    TArray<uint8> Inbox;
+    int32 InboxOffset = 0;
+};
+
+FAsyncSocketWorker* FAsyncSocketWorker::Instance = nullptr;
+int32 FAsyncSocketWorker::LastSocketId = 0;
+
+static bool IsExpired(double Deadline, double Now)
+{
+    return Deadline >= 0 && Deadline <= Now;
+}
+
+static bool OpenWakeSocket(t_socket& Fd)
+{
+    sockaddr_in Address = {};
+    Address.sin_family = AF_INET;
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t Length = sizeof(Address);
+    t_timeout Timeout;
+    timeout_init(&Timeout, -1, -1);
+
+    if (socket_create(&Fd, AF_INET, SOCK_DGRAM, 0) != IO_DONE)
+        return false;
+
+    if (socket_bind(&Fd, (SA*)&Address, Length) != IO_DONE
+        || getsockname(Fd, (SA*)&Address, &Length) != 0
+        || socket_connect(&Fd, (SA*)&Address, Length, &Timeout) != IO_DONE)
+    {
+        socket_destroy(&Fd);
+        return false;
+    }
+
+    socket_setnonblocking(&Fd);
+    return true;
+}
+
+FAsyncSocketWorker& FAsyncSocketWorker::Get()
+{
+    check(IsInGameThread());
+    if (!Instance)
+        Instance = new FAsyncSocketWorker();
+    return *Instance;
+}
+
+void FAsyncSocketWorker::Shutdown()
+{
+    delete Instance;
+    Instance = nullptr;
+}
+
+FAsyncSocketWorker::FAsyncSocketWorker()
+    : WakeSocket(SOCKET_INVALID),
+      Thread(nullptr),
+      bRunning(true),
+      bPolling(false)
+{
+    socket_open();
+    if (!OpenWakeSocket(WakeSocket))
+        UE_LOG(LogUnLua, Warning, TEXT("socket.async: failed to create the wake up socket, falling back to polling"));
+
+    RecvChunk.SetNumUninitialized(RecvChunkSize);
+    OnLuaEnvDestroyedHandle = UnLua::FLuaEnv::OnDestroyed.AddRaw(this, &FAsyncSocketWorker::OnLuaEnvDestroyed);
+#if ENGINE_MAJOR_VERSION >= 5
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAsyncSocketWorker::Tick));
+#else
+    TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAsyncSocketWorker::Tick));
+#endif
+    Thread = FRunnableThread::Create(this, TEXT("LuaAsyncSocket"));
+}
+
+FAsyncSocketWorker::~FAsyncSocketWorker()
+{
+#if ENGINE_MAJOR_VERSION >= 5
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+    FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+    UnLua::FLuaEnv::OnDestroyed.Remove(OnLuaEnvDestroyedHandle);
+
+    if (Thread)
+    {
+        Thread->Kill(true);
+        delete Thread;
+    }
+
+    for (const auto& Pair : Sockets)
+    {
+        socket_destroy(&Pair.Value->Fd);
+        delete Pair.Value;
+    }
+    socket_destroy(&WakeSocket);
+}
+
+void FAsyncSocketWorker::Stop()
+{
+    bRunning = false;
+    Wake();
+}
+
+void FAsyncSocketWorker::Submit(FRequest&& Request)
+{
+    Requests.Enqueue(MoveTemp(Request));
+    Wake();
+}
+
+void FAsyncSocketWorker::Wake()
+{
+    if (!bPolling || WakeSocket == SOCKET_INVALID)
+        return;
+    const char Byte = 0;
+    send(WakeSocket, &Byte, 1, 0);
+}
+
+uint32 FAsyncSocketWorker::Run()
+{
+    TArray<FPollFd> PollFds;
+    TArray<FSocketState*> PollStates;
+
+    while (bRunning)
+    {
+        FRequest Request;
+        while (Requests.Dequeue(Request))
+            Accept(MoveTemp(Request));
+
+        double Now = timeout_gettime();
+        double NextDeadline = -1;
+        PollFds.Reset();
+        PollStates.Reset();
+        if (WakeSocket != SOCKET_INVALID)
+        {
+            AddPollFd(PollFds, WakeSocket, POLLIN);
+            PollStates.Add(nullptr);
+        }
+
+        for (auto It = Sockets.CreateIterator(); It; ++It)
+        {
+            FSocketState* Socket = It.Value();
+            Progress(*Socket, Now);
+            if (Socket->bFailed)
+            {
+                socket_destroy(&Socket->Fd);
+                delete Socket;
+                It.RemoveCurrent();
+                continue;
+            }
+
+            short Events = 0;
+            double Deadline = -1;
+            if (Socket->bConnecting)
+            {
+                Events |= POLLOUT;
+                Deadline = Socket->ConnectRequest.Deadline;
+            }
+            if (Socket->Sends.Num() > 0)
+            {
+                Events |= POLLOUT;
+                Deadline = Socket->Sends[0].Deadline;
+            }
+            if (Socket->Receives.Num() > 0)
+            {
+                if (Socket->PeerError == IO_DONE)
+                    Events |= POLLIN;
+                const double ReceiveDeadline = Socket->Receives[0].Deadline;
+                if (Deadline < 0 || (ReceiveDeadline >= 0 && ReceiveDeadline < Deadline))
+                    Deadline = ReceiveDeadline;
+            }
+            if (Deadline >= 0 && (NextDeadline < 0 || Deadline < NextDeadline))
+                NextDeadline = Deadline;
+            if (Events == 0)
+                continue;
+
+            AddPollFd(PollFds, Socket->Fd, Events);
+            PollStates.Add(Socket);
+        }
+
+        // without the wake up socket new requests are only noticed on a short poll period
+        int32 Timeout = WakeSocket == SOCKET_INVALID ? 1 : -1;
+        if (NextDeadline >= 0)
+        {
+            const int32 DeadlineTimeout = FMath::Max(0, FMath::CeilToInt((NextDeadline - Now) * 1000));
+            Timeout = Timeout < 0 ? DeadlineTimeout : FMath::Min(Timeout, DeadlineTimeout);
+        }
+
+        bPolling = true;
+        if (!Requests.IsEmpty() || !bRunning)
+        {
+            bPolling = false;
+            continue;
+        }
+        const int32 NumReady = PollSockets(PollFds.GetData(), PollFds.Num(), Timeout);
+        bPolling = false;
+        if (NumReady <= 0)
+            continue;
+
+        for (int32 i = 0; i < PollFds.Num(); ++i)
+        {
+            if (!PollFds[i].revents)
+                continue;
+            FSocketState* Socket = PollStates[i];
+            if (!Socket)
+            {
+                char Drain[64];
+                while (recv(WakeSocket, Drain, sizeof(Drain), 0) > 0)
+                {
+                }
+                continue;
+            }
+            Socket->Revents = PollFds[i].revents;
+            Socket->bDirty = true;
+        }
+    }
+    return 0;
+}
+
+void FAsyncSocketWorker::Accept(FRequest&& Request)
+{
+    FSocketState** Found = Sockets.Find(Request.SocketId);
+    FSocketState* Socket = Found ? *Found : nullptr;
+
+    switch (Request.Op)
+    {
+    case EOp::Connect:
+        {
+            t_timeout Timeout;
+            timeout_init(&Timeout, 0, -1);
+            struct addrinfo Hints = {};
+            Hints.ai_family = AF_UNSPEC;
+            Hints.ai_socktype = SOCK_STREAM;
+            int Family = AF_UNSPEC;
+            const int32 SocketId = Request.SocketId;
+            const FTCHARToUTF8 Host(*Request.Host);
+            const FTCHARToUTF8 Service(*FString::FromInt(Request.Port));
+
+            // name resolution still blocks, but only this thread
+            Socket = new FSocketState();
+            const char* Error = inet_tryconnect(&Socket->Fd, &Family, Host.Get(), Service.Get(), &Timeout, &Hints);
+            if (!Error)
+            {
+                Complete(Request, IO_DONE, nullptr);
+            }
+            else if (FCStringAnsi::Strcmp(Error, socket_strerror(IO_TIMEOUT)) == 0)
+            {
+                Socket->bConnecting = true;
+                Socket->ConnectRequest = MoveTemp(Request);
+            }
+            else
+            {
+                Complete(Request, IO_UNKNOWN, Error);
+                socket_destroy(&Socket->Fd);
+                delete Socket;
+                return;
+            }
+            Sockets.Add(SocketId, Socket);
+            break;
+        }
+    case EOp::Send:
+    case EOp::Receive:
+        if (!Socket || (Request.Op == EOp::Send && Socket->PeerError != IO_DONE))
+        {
+            Complete(Request, IO_CLOSED, socket_strerror(IO_CLOSED));
+            break;
+        }
+        (Request.Op == EOp::Send ? Socket->Sends : Socket->Receives).Add(MoveTemp(Request));
+        Socket->bDirty = true;
+        break;
+    case EOp::Close:
+        if (Socket)
+        {
+            if (Socket->bConnecting)
+            {
+                Complete(Socket->ConnectRequest, IO_CLOSED, socket_strerror(IO_CLOSED));
+                Socket->bConnecting = false;
+            }
+            FailAll(*Socket, IO_CLOSED, socket_strerror(IO_CLOSED));
+            socket_destroy(&Socket->Fd);
+            delete Socket;
+            Sockets.Remove(Request.SocketId);
+        }
+        Complete(Request, IO_DONE, nullptr);
+        break;
+    }
+}
+
+void FAsyncSocketWorker::Progress(FSocketState& Socket, double Now)
+{
+    const bool bExpired = (Socket.bConnecting && IsExpired(Socket.ConnectRequest.Deadline, Now))
+        || (Socket.Sends.Num() > 0 && IsExpired(Socket.Sends[0].Deadline, Now))
+        || (Socket.Receives.Num() > 0 && IsExpired(Socket.Receives[0].Deadline, Now));
+    if (!Socket.bDirty && !bExpired)
+        return;
+    Socket.bDirty = false;
+
+    t_timeout Timeout;
+    timeout_init(&Timeout, 0, -1);
+
+    if (Socket.bConnecting)
+    {
+        if (Socket.Revents & (POLLOUT | POLLERR | POLLHUP))
+        {
+            int Error = 0;
+            socklen_t Length = sizeof(Error);
+            if (getsockopt(Socket.Fd, SOL_SOCKET, SO_ERROR, (char*)&Error, &Length) != 0)
+                Error = IO_UNKNOWN;
+            Socket.bConnecting = false;
+            Socket.bFailed = Error != 0;
+            Complete(Socket.ConnectRequest, Error, Error ? socket_strerror(Error) : nullptr);
+        }
+        else if (bExpired)
+        {
+            Socket.bConnecting = false;
+            Socket.bFailed = true;
+            Complete(Socket.ConnectRequest, IO_TIMEOUT, socket_strerror(IO_TIMEOUT));
+        }
+        Socket.Revents = 0;
+        return;
+    }
+    Socket.Revents = 0;
+
+    while (Socket.Sends.Num() > 0)
+    {
+        const FRequest& Send = Socket.Sends[0];
+        size_t Sent = 0;
+        const int Error = socket_send(&Socket.Fd, (const char*)Send.Data.GetData() + Socket.SendOffset, Send.Data.Num() - Socket.SendOffset, &Sent, &Timeout);
+        Socket.SendOffset += Sent;
+        if (Error == IO_DONE)
+        {
+            if (Socket.SendOffset < Send.Data.Num())
+                continue;
+            Complete(Send, IO_DONE, nullptr, Socket.SendOffset);
+        }
+        else if (Error == IO_TIMEOUT)
+        {
+            if (!IsExpired(Send.Deadline, Now))
+                break;
+            Complete(Send, IO_TIMEOUT, socket_strerror(IO_TIMEOUT), Socket.SendOffset);
+        }
+        else
+        {
+            Complete(Send, Error, socket_strerror(Error), Socket.SendOffset);
+            Socket.Sends.RemoveAt(0);
+            for (const FRequest& Pending : Socket.Sends)
+                Complete(Pending, Error, socket_strerror(Error));
+            Socket.Sends.Reset();
+            Socket.SendOffset = 0;
+            break;
+        }
+        Socket.Sends.RemoveAt(0);
+        Socket.SendOffset = 0;
+    }
+
+    if (Socket.Receives.Num() == 0)
+        return;
+
+    while (Socket.PeerError == IO_DONE)
+    {
+        size_t Got = 0;
+        const int Error = socket_recv(&Socket.Fd, (char*)RecvChunk.GetData(), RecvChunk.Num(), &Got, &Timeout);
+        Socket.Inbox.Append(RecvChunk.GetData(), Got);
+        if (Error == IO_TIMEOUT || (Error == IO_DONE && Got < (size_t)RecvChunk.Num()))
+            break;
+        if (Error != IO_DONE)
+            Socket.PeerError = Error;
+    }
+
+    while (Socket.Receives.Num() > 0)
+    {
+        const FRequest& Receive = Socket.Receives[0];
+        const uint8* Begin = Socket.Inbox.GetData() + Socket.InboxOffset;
+        const int32 Available = Socket.Inbox.Num() - Socket.InboxOffset;
+        int32 Take = -1;
+        int32 Skip = 0;
+        switch (Receive.Pattern)
+        {
+        case EPattern::Size:
+            if (Available >= Receive.Size)
+                Take = (int32)Receive.Size;
+            break;
+        case EPattern::Line:
+            if (const uint8* End = (const uint8*)memchr(Begin, '\n', Available))
+            {
+                Take = End - Begin;
+                Skip = 1;
+            }
+            break;
+        case EPattern::All:
+            if (Socket.PeerError != IO_DONE)
+                Take = Available;
+            break;
+        }
+
+        int32 Error = IO_DONE;
+        if (Take < 0)
+        {
+            // like the blocking receive, the partial result is consumed
+            if (Socket.PeerError != IO_DONE)
+                Error = Socket.PeerError;
+            else if (IsExpired(Receive.Deadline, Now))
+                Error = IO_TIMEOUT;
+            else
+                break;
+            Take = Available;
+        }
+
+        TArray<uint8> Data(Begin, Take);
+        if (Receive.Pattern == EPattern::Line)
+        {
+            // same as receive("*l") of the blocking tcp object, every CR is dropped, not only the one before the LF
+            Data.RemoveAll([](const uint8 Byte) { return Byte == '\r'; });
+        }
+        Complete(Receive, Error, Error == IO_DONE ? nullptr : socket_strerror(Error), Data.Num(), MoveTemp(Data));
+        Socket.Receives.RemoveAt(0);
+        Socket.InboxOffset += Take + Skip;
+        if (Socket.InboxOffset == Socket.Inbox.Num())
+        {
+            Socket.Inbox.Reset();
+            Socket.InboxOffset = 0;
+        }
+    }
+
+    if (Socket.InboxOffset > RecvChunkSize && Socket.InboxOffset * 2 > Socket.Inbox.Num())
+    {
+        Socket.Inbox.RemoveAt(0, Socket.InboxOffset, false);
+        Socket.InboxOffset = 0;
+    }
+}
+
+void FAsyncSocketWorker::Complete(const FRequest& Request, int32 Error, const char* ErrorMessage, int64 Bytes, TArray<uint8>&& Data)
+{
+    FCompletion Completion;
+    Completion.Op = Request.Op;
+    Completion.SocketId = Request.SocketId;
+    Completion.ThreadRef = Request.ThreadRef;
+    Completion.Error = Error;
+    Completion.ErrorMessage = ErrorMessage;
+    Completion.Bytes = Bytes;
+    Completion.Data = MoveTemp(Data);
+    Completions.Enqueue(MoveTemp(Completion));
+}
+
+void FAsyncSocketWorker::FailAll(FSocketState& Socket, int32 Error, const char* ErrorMessage)
+{
+    for (const FRequest& Send : Socket.Sends)
+        Complete(Send, Error, ErrorMessage);
+    for (const FRequest& Receive : Socket.Receives)
+        Complete(Receive, Error, ErrorMessage);
+    Socket.Sends.Reset();
+    Socket.Receives.Reset();
+    Socket.SendOffset = 0;
+}
+
+bool FAsyncSocketWorker::Tick(float DeltaTime)
+{
+    FCompletion Completion;
+    while (Completions.Dequeue(Completion))
+    {
+        UnLua::FLuaEnv* Env = SocketOwners.FindRef(Completion.SocketId);
+        if (!Env)
+            continue; // closed by Lua or its env is gone
+
+        if (Completion.Op == EOp::Close || (Completion.Op == EOp::Connect && Completion.Error != IO_DONE))
+            SocketOwners.Remove(Completion.SocketId);
+
+        if (Completion.ThreadRef == LUA_NOREF)
+            continue;
+
+        Env->ResumeThread(Completion.ThreadRef, [&Completion](lua_State* L)
+        {
+            if (Completion.Error == IO_DONE)
+            {
+                switch (Completion.Op)
+                {
+                case EOp::Connect:
+                    {
+                        auto Connection = (FAsyncSocketConnection*)lua_newuserdata(L, sizeof(FAsyncSocketConnection));
+                        Connection->SocketId = Completion.SocketId;
+                        Connection->bClosed = false;
+                        luaL_setmetatable(L, ConnectionMetatableName);
+                        return 1;
+                    }
+                case EOp::Send:
+                    lua_pushinteger(L, Completion.Bytes);
+                    return 1;
+                case EOp::Receive:
+                    lua_pushlstring(L, (const char*)Completion.Data.GetData(), Completion.Data.Num());
+                    return 1;
+                default:
+                    lua_pushboolean(L, true);
+                    return 1;
+                }
+            }
+
+            lua_pushnil(L);
+            lua_pushstring(L, Completion.ErrorMessage);
+            if (Completion.Op == EOp::Send)
+            {
+                lua_pushinteger(L, Completion.Bytes);
+                return 3;
+            }
+            if (Completion.Op == EOp::Receive)
+            {
+                lua_pushlstring(L, (const char*)Completion.Data.GetData(), Completion.Data.Num());
+                return 3;
+            }
+            return 2;
+        });
+    }
+    return true;
+}
+
+void FAsyncSocketWorker::OnLuaEnvDestroyed(UnLua::FLuaEnv& Env)
+{
+    for (auto It = SocketOwners.CreateIterator(); It; ++It)
+    {
+        if (It.Value() != &Env)
+            continue;
+        FRequest Request;
+        Request.Op = EOp::Close;
+        Request.SocketId = It.Key();
+        Submit(MoveTemp(Request));
+        It.RemoveCurrent();
+    }
+}
+
+int FAsyncSocketWorker::Submit(lua_State* L, FRequest&& Request, int32 Index)
+{
+    if (!lua_isyieldable(L))
+        return luaL_error(L, "socket.async operations must be called from a coroutine");
+
+    UnLua::FLuaEnv& Env = UnLua::FLuaEnv::FindEnvChecked(L);
+    const double Timeout = luaL_optnumber(L, Index, -1);
+    Request.Deadline = Timeout < 0 ? -1 : timeout_gettime() + Timeout;
+    Request.ThreadRef = Env.FindOrAddThread(L);
+
+    FAsyncSocketWorker& Worker = Get();
+    if (Request.Op == EOp::Connect)
+    {
+        Request.SocketId = ++LastSocketId;
+        Worker.SocketOwners.Add(Request.SocketId, &Env);
+    }
+    Worker.Submit(MoveTemp(Request));
+    return lua_yield(L, 0);
+}
+
+int FAsyncSocketWorker::Connect(lua_State* L)
+{
+    const char* Host = luaL_checkstring(L, 1);
+    FRequest Request;
+    Request.Op = EOp::Connect;
+    Request.Host = FString(UTF8_TO_TCHAR(Host));
+    Request.Port = (int32)luaL_checkinteger(L, 2);
+    return Submit(L, MoveTemp(Request), 3);
+}
+
+int FAsyncSocketWorker::Send(lua_State* L)
+{
+    auto Connection = (FAsyncSocketConnection*)luaL_checkudata(L, 1, ConnectionMetatableName);
+    size_t Length;
+    const char* Data = luaL_checklstring(L, 2, &Length);
+    if (Connection->bClosed)
+    {
+        lua_pushnil(L);
+        lua_pushstring(L, socket_strerror(IO_CLOSED));
+        lua_pushinteger(L, 0);
+        return 3;
+    }
+
+    FRequest Request;
+    Request.Op = EOp::Send;
+    Request.SocketId = Connection->SocketId;
+    Request.Data.Append((const uint8*)Data, Length);
+    return Submit(L, MoveTemp(Request), 3);
+}
+
+int FAsyncSocketWorker::Receive(lua_State* L)
+{
+    auto Connection = (FAsyncSocketConnection*)luaL_checkudata(L, 1, ConnectionMetatableName);
+    FRequest Request;
+    Request.Op = EOp::Receive;
+    Request.SocketId = Connection->SocketId;
+    if (lua_isnumber(L, 2))
+    {
+        Request.Pattern = EPattern::Size;
+        Request.Size = (int64)lua_tointeger(L, 2);
+        luaL_argcheck(L, Request.Size >= 0, 2, "invalid receive size");
+    }
+    else
+    {
+        const char* Pattern = luaL_optstring(L, 2, "*l");
+        if (Pattern[0] == '*')
+            ++Pattern;
+        if (Pattern[0] == 'l')
+            Request.Pattern = EPattern::Line;
+        else if (Pattern[0] == 'a')
+            Request.Pattern = EPattern::All;
+        else
+            return luaL_argerror(L, 2, "invalid receive pattern");
+    }
+
+    if (Connection->bClosed)
+    {
+        lua_pushnil(L);
+        lua_pushstring(L, socket_strerror(IO_CLOSED));
+        lua_pushliteral(L, "");
+        return 3;
+    }
+    return Submit(L, MoveTemp(Request), 3);
+}
+
+int FAsyncSocketWorker::Close(lua_State* L)
+{
+    auto Connection = (FAsyncSocketConnection*)luaL_checkudata(L, 1, ConnectionMetatableName);
+    if (Connection->bClosed)
+        return 0;
+    Connection->bClosed = true;
+
+    if (Instance)
+    {
+        FRequest Request;
+        Request.Op = EOp::Close;
+        Request.SocketId = Connection->SocketId;
+        Instance->Submit(MoveTemp(Request));
+    }
+    return 0;
+}
+
+int FAsyncSocketWorker::ToString(lua_State* L)
+{
+    auto Connection = (FAsyncSocketConnection*)luaL_checkudata(L, 1, ConnectionMetatableName);
+    lua_pushfstring(L, "async connection{%d}%s", Connection->SocketId, Connection->bClosed ? " (closed)" : "");
+    return 1;
+}
+
+int FAsyncSocketWorker::OpenLib(lua_State* L)
+{
+    static const luaL_Reg ConnectionMethods[] =
+    {
+        {"send", Send},
+        {"receive", Receive},
+        {"close", Close},
+        {"__gc", Close},
+        {"__tostring", ToString},
+        {nullptr, nullptr}
+    };
+    static const luaL_Reg Functions[] =
+    {
+        {"connect", Connect},
+        {nullptr, nullptr}
+    };
+
+    if (luaL_newmetatable(L, ConnectionMetatableName))
+    {
+        luaL_setfuncs(L, ConnectionMethods, 0);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -2, "__index");
+    }
+    lua_pop(L, 1);
+
+    luaL_newlib(L, Functions);
+    return 1;
+}
+
+EXTENSION_NAMESPACE_END
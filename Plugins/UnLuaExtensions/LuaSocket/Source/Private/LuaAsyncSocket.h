@@ -0,0 +1,154 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "LuaEnv.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#endif
+#include "socket.h"
+#if PLATFORM_WINDOWS
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
+
+EXTENSION_NAMESPACE_BEGIN
+
+/**
+ * Background I/O thread behind the 'socket.async' module.
+ *
+ * Lua coroutines submit requests from the game thread and yield, the worker thread runs the
+ * non-blocking socket calls, and the completions are drained once per tick on the game thread,
+ * where the waiting coroutines are resumed with the results. Both queues are single producer,
+ * single consumer, so the game thread never takes a lock to talk to the worker.
+ */
+class FAsyncSocketWorker final : public FRunnable
+{
+public:
+    enum class EOp : uint8
+    {
+        Connect,
+        Send,
+        Receive,
+        Close,
+    };
+
+    enum class EPattern : uint8
+    {
+        Size, // exactly Size bytes
+        Line, // one line without the LF, CRs are dropped like receive("*l") does
+        All,  // everything until the peer closes the connection
+    };
+
+    struct FRequest
+    {
+        EOp Op = EOp::Close;
+        EPattern Pattern = EPattern::Line;
+        int32 SocketId = 0;
+        int32 ThreadRef = LUA_NOREF;
+        int64 Size = 0;
+        double Deadline = -1; // absolute, in timeout_gettime() seconds, negative for none
+        FString Host;
+        int32 Port = 0;
+        TArray<uint8> Data;
+    };
+
+    struct FCompletion
+    {
+        EOp Op = EOp::Close;
+        int32 SocketId = 0;
+        int32 ThreadRef = LUA_NOREF;
+        int32 Error = 0; // IO_DONE or a socket error code
+        const char* ErrorMessage = nullptr;
+        int64 Bytes = 0;
+        TArray<uint8> Data;
+    };
+
+    static FAsyncSocketWorker& Get();
+
+    static void Shutdown();
+
+    /** Open the 'socket.async' module, see LuaAsyncSocket.cpp for the Lua API. */
+    static int OpenLib(lua_State* L);
+
+    virtual uint32 Run() override;
+
+    virtual void Stop() override;
+
+private:
+    struct FSocketState;
+
+    FAsyncSocketWorker();
+
+    virtual ~FAsyncSocketWorker() override;
+
+    void Submit(FRequest&& Request);
+
+    void Wake();
+
+    bool Tick(float DeltaTime);
+
+    void OnLuaEnvDestroyed(UnLua::FLuaEnv& Env);
+
+    void Accept(FRequest&& Request);
+
+    void Progress(FSocketState& Socket, double Now);
+
+    void Complete(const FRequest& Request, int32 Error, const char* ErrorMessage, int64 Bytes = 0, TArray<uint8>&& Data = TArray<uint8>());
+
+    void FailAll(FSocketState& Socket, int32 Error, const char* ErrorMessage);
+
+    static int Connect(lua_State* L);
+
+    static int Send(lua_State* L);
+
+    static int Receive(lua_State* L);
+
+    static int Close(lua_State* L);
+
+    static int ToString(lua_State* L);
+
+    static int Submit(lua_State* L, FRequest&& Request, int32 Index);
+
+    static FAsyncSocketWorker* Instance;
+    static int32 LastSocketId; // kept across restarts, a connection collected after a restart must not close a new one
+
+    // game thread
+    TMap<int32, UnLua::FLuaEnv*> SocketOwners;
+    FDelegateHandle OnLuaEnvDestroyedHandle;
+#if ENGINE_MAJOR_VERSION >= 5
+    FTSTicker::FDelegateHandle TickerHandle;
+#else
+    FDelegateHandle TickerHandle;
+#endif
+
+    // worker thread
+    TMap<int32, FSocketState*> Sockets;
+    TArray<uint8> RecvChunk;
+
+    TQueue<FRequest, EQueueMode::Spsc> Requests;
+    TQueue<FCompletion, EQueueMode::Spsc> Completions;
+    t_socket WakeSocket; // loopback datagram socket the worker polls along with the connections
+    FRunnableThread* Thread;
+    FThreadSafeBool bRunning;
+    FThreadSafeBool bPolling;
+};
+
+EXTENSION_NAMESPACE_END
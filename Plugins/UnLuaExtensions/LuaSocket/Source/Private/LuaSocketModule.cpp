@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and limitations under the License.
 
 #include "LuaSocketModule.h"
+#include "LuaAsyncSocket.h"
 #include "LuaEnv.h"
 #include "luasocket.h"
 #include "mime.h"
@@ -25,6 +26,7 @@ void FLuaSocketModule::StartupModule()
 void FLuaSocketModule::ShutdownModule()
 {
     UnLua::FLuaEnv::OnCreated.RemoveAll(this);
+    UnLuaExtensions::LuaSocket::FAsyncSocketWorker::Shutdown();
 }
 
 void FLuaSocketModule::OnLuaEnvCreated(UnLua::FLuaEnv& Env)
@@ -33,6 +35,7 @@ void FLuaSocketModule::OnLuaEnvCreated(UnLua::FLuaEnv& Env)
     Env.AddBuiltInLoader(TEXT("socket"), luaopen_socket_core);
     Env.AddBuiltInLoader(TEXT("socket.core"), luaopen_socket_core);
     Env.AddBuiltInLoader(TEXT("mime.core"), luaopen_mime_core);
+    Env.AddBuiltInLoader(TEXT("socket.async"), FAsyncSocketWorker::OpenLib);
     Env.DoString("UnLua.PackagePath = UnLua.PackagePath .. ';/Plugins/UnLuaExtensions/LuaSocket/Content/Script/?.lua'");
 }
 
@@ -4,6 +4,16 @@
 \*=========================================================================*/
 #include "luasocket.h"
 #include "buffer.h"
+#include "slice.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* bytes received into a slice block so far */
+typedef struct t_sliceacc_ {
+    p_sliceblock block;
+    size_t len;
+} t_sliceacc;
 
 /*=========================================================================*\
 * Internal function prototypes
@@ -14,6 +24,10 @@ static int recvall(p_buffer buf, luaL_Buffer *b);
 static int buffer_get(p_buffer buf, const char **data, size_t *count);
 static void buffer_skip(p_buffer buf, size_t count);
 static int sendraw(p_buffer buf, const char *data, size_t count, size_t *sent);
+static int sliceadd(t_sliceacc *acc, const char *data, size_t count);
+static int srecvraw(p_buffer buf, size_t wanted, t_sliceacc *acc);
+static int srecvline(p_buffer buf, t_sliceacc *acc);
+static int srecvall(p_buffer buf, t_sliceacc *acc);
 
 /* min and max macros */
 #ifndef MIN
@@ -39,12 +53,60 @@ int buffer_open(lua_State *L) {
 \*-------------------------------------------------------------------------*/
 void buffer_init(p_buffer buf, p_io io, p_timeout tm) {
     buf->first = buf->last = 0;
+    buf->size = BUF_SIZE;
+    buf->data = buf->local;
     buf->io = io;
     buf->tm = tm;
     buf->received = buf->sent = 0;
     buf->birthday = timeout_gettime();
 }
 
+/*-------------------------------------------------------------------------*\
+* Releases storage allocated by buffer_setsize, dropping buffered data
+\*-------------------------------------------------------------------------*/
+void buffer_destroy(p_buffer buf) {
+    if (buf->data != buf->local) free(buf->data);
+    buf->data = buf->local;
+    buf->size = BUF_SIZE;
+    buf->first = buf->last = 0;
+}
+
+/*-------------------------------------------------------------------------*\
+* Changes the size of the input buffer, keeping buffered data. Sizes up to
+* BUF_SIZE use the default storage. Returns 0 on failure
+\*-------------------------------------------------------------------------*/
+int buffer_setsize(p_buffer buf, size_t size) {
+    size_t pending = buf->last - buf->first;
+    char *data;
+    if (size < BUF_SIZE) size = BUF_SIZE;
+    if (pending > size) return 0;
+    if (size == buf->size) return 1;
+    data = size == BUF_SIZE ? buf->local : (char *) malloc(size);
+    if (!data) return 0;
+    memmove(data, buf->data + buf->first, pending);
+    if (buf->data != buf->local) free(buf->data);
+    buf->data = data;
+    buf->size = size;
+    buf->first = 0;
+    buf->last = pending;
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* object:setbuffersize() interface
+\*-------------------------------------------------------------------------*/
+int buffer_meth_setbuffersize(lua_State *L, p_buffer buf) {
+    lua_Number size = luaL_checknumber(L, 2);
+    luaL_argcheck(L, size > 0, 2, "invalid buffer size");
+    if (!buffer_setsize(buf, (size_t) size)) {
+        lua_pushnil(L);
+        lua_pushstring(L, "cannot resize buffer");
+        return 2;
+    }
+    lua_pushnumber(L, 1);
+    return 1;
+}
+
 /*-------------------------------------------------------------------------*\
 * object:getstats() interface
 \*-------------------------------------------------------------------------*/
@@ -151,6 +213,63 @@ int buffer_meth_receive(lua_State *L, p_buffer buf) {
     return lua_gettop(L) - top;
 }
 
+/*-------------------------------------------------------------------------*\
+* object:receiveslice() interface, same patterns and prefix as receive()
+* but the data comes back as slices (see slice.h). The prefix may be a
+* string or a slice, and on errors the partial result is a slice too
+\*-------------------------------------------------------------------------*/
+int buffer_meth_receiveslice(lua_State *L, p_buffer buf) {
+    int err = IO_DONE, top;
+    t_sliceacc acc = { NULL, 0 };
+    size_t size;
+    const char *part;
+    p_slice prefix = (p_slice) luaL_testudata(L, 3, SLICE_CLASS);
+    if (prefix) {
+        luaL_argcheck(L, prefix->block != NULL, 3, "slice was released");
+        part = prefix->data;
+        size = prefix->len;
+    } else part = luaL_optlstring(L, 3, "", &size);
+    /* validate the pattern before anything is allocated */
+    if (!lua_isnumber(L, 2)) {
+        const char *p = luaL_optstring(L, 2, "*l");
+        luaL_argcheck(L, p[0] == '*' && (p[1] == 'l' || p[1] == 'a'), 2,
+            "invalid receive pattern");
+    } else luaL_argcheck(L, lua_tonumber(L, 2) >= 0, 2, "invalid receive pattern");
+    timeout_markstart(buf->tm);
+    lua_settop(L, 3);
+    top = lua_gettop(L);
+    /* start with the optional prefix, like receive() */
+    if (size > 0 && sliceadd(&acc, part, size) != IO_DONE) err = IO_UNKNOWN;
+    else if (!lua_isnumber(L, 2)) {
+        const char *p = luaL_optstring(L, 2, "*l");
+        if (p[1] == 'l') err = srecvline(buf, &acc);
+        else err = srecvall(buf, &acc);
+    /* get a fixed number of bytes (minus what was already partially
+     * received) */
+    } else {
+        size_t wanted = (size_t) lua_tonumber(L, 2);
+        if (size == 0 || wanted > size)
+            err = srecvraw(buf, wanted-size, &acc);
+    }
+    if (!acc.block) acc.block = slice_alloc(0);
+    if (!acc.block) return luaL_error(L, "not enough memory");
+    if (err != IO_DONE) {
+        lua_pushnil(L);
+        lua_pushstring(L, buf->io->error(buf->io->ctx, err));
+        slice_push(L, acc.block, 0, acc.len);
+    } else {
+        slice_push(L, acc.block, 0, acc.len);
+        lua_pushnil(L);
+        lua_pushnil(L);
+    }
+    slice_unref(acc.block);
+#ifdef LUASOCKET_DEBUG
+    /* push time elapsed during operation as the last return value */
+    lua_pushnumber(L, timeout_gettime() - timeout_getstart(buf->tm));
+#endif
+    return lua_gettop(L) - top;
+}
+
 /*-------------------------------------------------------------------------*\
 * Determines if there is any data in the read buffer
 \*-------------------------------------------------------------------------*/
@@ -242,6 +361,92 @@ static int recvline(p_buffer buf, luaL_Buffer *b) {
     return err;
 }
 
+/*-------------------------------------------------------------------------*\
+* Appends to a slice block, growing it geometrically
+\*-------------------------------------------------------------------------*/
+static int sliceadd(t_sliceacc *acc, const char *data, size_t count) {
+    size_t needed = acc->len + count;
+    if (!acc->block || acc->block->capacity < needed) {
+        size_t capacity = acc->block ? acc->block->capacity : SLICE_MINBLOCK;
+        while (capacity < needed) capacity <<= 1;
+        acc->block = slice_grow(acc->block, acc->len, capacity);
+        if (!acc->block) return IO_UNKNOWN;
+    }
+    memcpy(acc->block->data + acc->len, data, count);
+    acc->len = needed;
+    return IO_DONE;
+}
+
+/*-------------------------------------------------------------------------*\
+* Reads a fixed number of bytes into a slice. Once the buffered bytes are
+* consumed, the transport writes straight into the slice block
+\*-------------------------------------------------------------------------*/
+static int srecvraw(p_buffer buf, size_t wanted, t_sliceacc *acc) {
+    int err = IO_DONE;
+    size_t total = 0;
+    acc->block = slice_grow(acc->block, acc->len, acc->len + wanted);
+    if (!acc->block) return IO_UNKNOWN;
+    while (total < wanted && err == IO_DONE) {
+        size_t count;
+        if (buffer_isempty(buf)) {
+            p_io io = buf->io;
+            err = io->recv(io->ctx, acc->block->data + acc->len, wanted - total, &count, buf->tm);
+            buf->received += count;
+        } else {
+            count = MIN(buf->last - buf->first, wanted - total);
+            memcpy(acc->block->data + acc->len, buf->data + buf->first, count);
+            buffer_skip(buf, count);
+        }
+        acc->len += count;
+        total += count;
+    }
+    return err;
+}
+
+/*-------------------------------------------------------------------------*\
+* Reads everything until the connection is closed into a slice
+\*-------------------------------------------------------------------------*/
+static int srecvall(p_buffer buf, t_sliceacc *acc) {
+    int err = IO_DONE;
+    size_t total = 0;
+    while (err == IO_DONE) {
+        const char *data; size_t count;
+        err = buffer_get(buf, &data, &count);
+        if (sliceadd(acc, data, count) != IO_DONE) return IO_UNKNOWN;
+        total += count;
+        buffer_skip(buf, count);
+    }
+    if (err == IO_CLOSED) {
+        if (total > 0) return IO_DONE;
+        else return IO_CLOSED;
+    } else return err;
+}
+
+/*-------------------------------------------------------------------------*\
+* Reads a line into a slice, with the rules of recvline
+\*-------------------------------------------------------------------------*/
+static int srecvline(p_buffer buf, t_sliceacc *acc) {
+    int err = IO_DONE;
+    while (err == IO_DONE) {
+        size_t count, pos, start = acc->len, i, j;
+        const char *data, *eol;
+        err = buffer_get(buf, &data, &count);
+        eol = (const char *) memchr(data, '\n', count);
+        pos = eol ? (size_t) (eol - data) : count;
+        if (sliceadd(acc, data, pos) != IO_DONE) return IO_UNKNOWN;
+        /* we ignore all \r's */
+        for (i = j = start; i < acc->len; i++)
+            if (acc->block->data[i] != '\r') acc->block->data[j++] = acc->block->data[i];
+        acc->len = j;
+        if (eol) { /* found '\n' */
+            buffer_skip(buf, pos+1); /* skip '\n' too */
+            break; /* we are done */
+        } else /* reached the end of the buffer */
+            buffer_skip(buf, pos);
+    }
+    return err;
+}
+
 /*-------------------------------------------------------------------------*\
 * Skips a given number of bytes from read buffer. No data is read from the
 * transport layer
@@ -263,7 +468,7 @@ static int buffer_get(p_buffer buf, const char **data, size_t *count) {
     p_timeout tm = buf->tm;
     if (buffer_isempty(buf)) {
         size_t got;
-        err = io->recv(io->ctx, buf->data, BUF_SIZE, &got, tm);
+        err = io->recv(io->ctx, buf->data, buf->size, &got, tm);
         buf->first = 0;
         buf->last = got;
     }
@@ -14,12 +14,16 @@
 *
 * The module is built on top of the I/O abstraction defined in io.h and the
 * timeout management is done with the timeout.h interface.
+*
+* The input buffer starts as BUF_SIZE bytes stored in the object itself and
+* can be enlarged at run time with buffer_setsize(). Data can be received
+* into slices (see slice.h) instead of Lua strings.
 \*=========================================================================*/
 #include "luasocket.h"
 #include "io.h"
 #include "timeout.h"
 
-/* buffer size in bytes */
+/* default buffer size in bytes */
 #define BUF_SIZE 8192
 
 /* buffer control structure */
@@ -29,7 +33,9 @@ typedef struct t_buffer_ {
     p_io io;                /* IO driver used for this buffer */
     p_timeout tm;           /* timeout management for this buffer */
     size_t first, last;     /* index of first and last bytes of stored data */
-    char data[BUF_SIZE];    /* storage space for buffer data */
+    size_t size;            /* size of the storage pointed by data */
+    char *data;             /* storage space for buffer data */
+    char local[BUF_SIZE];   /* default storage */
 } t_buffer;
 typedef t_buffer *p_buffer;
 
@@ -39,10 +45,14 @@ typedef t_buffer *p_buffer;
 
 int buffer_open(lua_State *L);
 void buffer_init(p_buffer buf, p_io io, p_timeout tm);
+void buffer_destroy(p_buffer buf);
+int buffer_setsize(p_buffer buf, size_t size);
 int buffer_meth_getstats(lua_State *L, p_buffer buf);
 int buffer_meth_setstats(lua_State *L, p_buffer buf);
 int buffer_meth_send(lua_State *L, p_buffer buf);
 int buffer_meth_receive(lua_State *L, p_buffer buf);
+int buffer_meth_receiveslice(lua_State *L, p_buffer buf);
+int buffer_meth_setbuffersize(lua_State *L, p_buffer buf);
 int buffer_isempty(p_buffer buf);
 
 #ifndef _WIN32
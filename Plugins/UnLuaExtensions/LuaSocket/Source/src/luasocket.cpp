@@ -21,6 +21,8 @@
 #include "tcp.h"
 #include "udp.h"
 #include "select.h"
+#include "poller.h"
+#include "slice.h"
 
 /*-------------------------------------------------------------------------*\
 * Internal function prototypes
@@ -41,6 +43,8 @@ static const luaL_Reg mod[] = {
     {"tcp", tcp_open},
     {"udp", udp_open},
     {"select", select_open},
+    {"poller", poller_open},
+    {"slice", slice_open},
     {NULL, NULL}
 };
 
@@ -0,0 +1,675 @@
+/*=========================================================================*\
+* Poller object
+* LuaSocket toolkit
+\*=========================================================================*/
+#include "luasocket.h"
+
+#include "auxiliar.h"
+#include "socket.h"
+#include "timeout.h"
+#include "tcp.h"
+#include "poller.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* indices into the uservalue table of a poller */
+#define POLLER_SOCKETS      1   /* descriptor -> registered object */
+#define POLLER_CALLBACKS    2   /* descriptor -> dispatch callback */
+#define POLLER_RESULTS      3   /* reusable result table of wait() */
+#define POLLER_REVENTS      4   /* reusable revents table of wait() */
+
+/*=========================================================================*\
+* Internal function prototypes
+\*=========================================================================*/
+static int global_create(lua_State *L);
+static int meth_add(lua_State *L);
+static int meth_modify(lua_State *L);
+static int meth_remove(lua_State *L);
+static int meth_wait(lua_State *L);
+static int meth_dispatch(lua_State *L);
+static int meth_count(lua_State *L);
+static int meth_close(lua_State *L);
+
+/* poller object methods */
+static luaL_Reg poller_methods[] = {
+    {"__gc",        meth_close},
+    {"__tostring",  auxiliar_tostring},
+    {"add",         meth_add},
+    {"close",       meth_close},
+    {"count",       meth_count},
+    {"dispatch",    meth_dispatch},
+    {"modify",      meth_modify},
+    {"remove",      meth_remove},
+    {"wait",        meth_wait},
+    {NULL,          NULL}
+};
+
+/* functions in library namespace */
+static luaL_Reg func[] = {
+    {"poller", global_create},
+    {NULL, NULL}
+};
+
+/*-------------------------------------------------------------------------*\
+* Initializes module
+\*-------------------------------------------------------------------------*/
+int poller_open(lua_State *L) {
+    auxiliar_newclass(L, "poller{}", poller_methods);
+    lua_pushstring(L, "POLLREAD");
+    lua_pushinteger(L, POLLER_READ);
+    lua_rawset(L, -3);
+    lua_pushstring(L, "POLLWRITE");
+    lua_pushinteger(L, POLLER_WRITE);
+    lua_rawset(L, -3);
+    lua_pushstring(L, "POLLERROR");
+    lua_pushinteger(L, POLLER_ERROR);
+    lua_rawset(L, -3);
+    luaL_setfuncs(L, func, 0);
+    return 0;
+}
+
+/*=========================================================================*\
+* Internal functions
+\*=========================================================================*/
+/* lasterror() reports WSA codes on Windows, which have their own EINTR */
+#ifdef _WIN32
+#define POLLER_EINTR WSAEINTR
+#else
+#define POLLER_EINTR EINTR
+#endif
+
+static int lasterror(void) {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+static t_socket getfd(lua_State *L, int idx) {
+    t_socket fd = SOCKET_INVALID;
+    lua_getfield(L, idx, "getfd");
+    if (!lua_isnil(L, -1)) {
+        lua_pushvalue(L, idx);
+        lua_call(L, 1, 1);
+        if (lua_isnumber(L, -1)) {
+            double numfd = lua_tonumber(L, -1);
+            fd = (numfd >= 0.0)? (t_socket) numfd: SOCKET_INVALID;
+        }
+    }
+    lua_pop(L, 1);
+    return fd;
+}
+
+static int checkevents(lua_State *L, int idx) {
+    const char *s = luaL_optstring(L, idx, "r");
+    int events = 0;
+    for (; *s; s++) {
+        if (*s == 'r') events |= POLLER_READ;
+        else if (*s == 'w') events |= POLLER_WRITE;
+        else luaL_argerror(L, idx, "invalid events, use 'r', 'w' or 'rw'");
+    }
+    return events;
+}
+
+static int checkmode(lua_State *L, int idx) {
+    static const char *const modes[] = {"level", "edge", NULL};
+    return luaL_checkoption(L, idx, "level", modes);
+}
+
+/*-------------------------------------------------------------------------*\
+* Descriptor to entry lookup
+\*-------------------------------------------------------------------------*/
+#ifdef _WIN32
+static size_t slot_hash(t_socket fd, int nslots) {
+    /* socket handles are multiples of 4 */
+    return (size_t) ((fd >> 2)*2654435761u) & (size_t) (nslots - 1);
+}
+
+static int slot_get(p_poller p, t_socket fd) {
+    size_t i, mask = (size_t) (p->nslots - 1);
+    if (p->nslots == 0) return -1;
+    for (i = slot_hash(fd, p->nslots); p->slots[i].fd != SOCKET_INVALID; i = (i + 1) & mask)
+        if (p->slots[i].fd == fd) return p->slots[i].slot;
+    return -1;
+}
+
+static void slot_insert(t_pollslot *slots, int nslots, t_socket fd, int slot) {
+    size_t i, mask = (size_t) (nslots - 1);
+    for (i = slot_hash(fd, nslots); slots[i].fd != SOCKET_INVALID && slots[i].fd != fd; i = (i + 1) & mask) {}
+    slots[i].fd = fd;
+    slots[i].slot = slot;
+}
+
+static void slot_delete(p_poller p, t_socket fd) {
+    size_t i, j, k, mask = (size_t) (p->nslots - 1);
+    if (p->nslots == 0) return;
+    for (i = slot_hash(fd, p->nslots); p->slots[i].fd != fd; i = (i + 1) & mask)
+        if (p->slots[i].fd == SOCKET_INVALID) return;
+    /* shift later entries of the probe sequence back into the hole */
+    for (j = (i + 1) & mask; p->slots[j].fd != SOCKET_INVALID; j = (j + 1) & mask) {
+        k = slot_hash(p->slots[j].fd, p->nslots);
+        if (i < j? (k <= i || k > j): (k <= i && k > j)) {
+            p->slots[i] = p->slots[j];
+            i = j;
+        }
+    }
+    p->slots[i].fd = SOCKET_INVALID;
+}
+
+/* returns 0 when out of memory, removing or updating never allocates */
+static int slot_set(p_poller p, t_socket fd, int slot) {
+    if (slot < 0) {
+        slot_delete(p, fd);
+        return 1;
+    }
+    /* keep the load factor at most one half */
+    if (slot_get(p, fd) < 0 && (p->count + 1)*2 > p->nslots) {
+        int i, n = p->nslots > 0? p->nslots*2: 128;
+        t_pollslot *slots = (t_pollslot *) malloc(n*sizeof(t_pollslot));
+        if (!slots) return 0;
+        for (i = 0; i < n; i++) slots[i].fd = SOCKET_INVALID;
+        for (i = 0; i < p->nslots; i++)
+            if (p->slots[i].fd != SOCKET_INVALID)
+                slot_insert(slots, n, p->slots[i].fd, p->slots[i].slot);
+        free(p->slots);
+        p->slots = slots;
+        p->nslots = n;
+    }
+    slot_insert(p->slots, p->nslots, fd, slot);
+    return 1;
+}
+#else
+static int slot_get(p_poller p, t_socket fd) {
+    if (fd < 0 || fd >= p->nslots) return -1;
+    return p->slots[fd];
+}
+
+/* returns 0 when out of memory, removing or updating never allocates */
+static int slot_set(p_poller p, t_socket fd, int slot) {
+    if (fd >= p->nslots) {
+        int i, n = p->nslots > 0? p->nslots: 64;
+        int *slots;
+        if (slot < 0) return 1;
+        while (n <= fd) n *= 2;
+        slots = (int *) realloc(p->slots, n*sizeof(int));
+        if (!slots) return 0;
+        for (i = p->nslots; i < n; i++) slots[i] = -1;
+        p->slots = slots;
+        p->nslots = n;
+    }
+    p->slots[fd] = slot;
+    return 1;
+}
+#endif
+
+/*-------------------------------------------------------------------------*\
+* Ready queue. Sockets are queued once, later events are merged in place.
+* Returns 0 when out of memory.
+\*-------------------------------------------------------------------------*/
+static int ready_push(p_poller p, int slot, int revents) {
+    t_pollentry *e = &p->entries[slot];
+    if (e->qindex >= 0) {
+        p->ready[e->qindex].revents |= revents;
+        return 1;
+    }
+    if (p->rlast == p->rcapacity) {
+        if (p->rfirst > 0) {
+            /* compact the queue and fix up the positions stored in entries */
+            int i, n = p->rlast - p->rfirst;
+            memmove(p->ready, p->ready + p->rfirst, n*sizeof(t_pollready));
+            p->rfirst = 0;
+            p->rlast = n;
+            for (i = 0; i < n; i++)
+                if (p->ready[i].slot >= 0) p->entries[p->ready[i].slot].qindex = i;
+        } else {
+            int capacity = p->rcapacity > 0? p->rcapacity*2: 64;
+            t_pollready *ready = (t_pollready *) realloc(p->ready,
+                capacity*sizeof(t_pollready));
+            if (!ready) return 0;
+            p->ready = ready;
+            p->rcapacity = capacity;
+        }
+    }
+    e->qindex = p->rlast;
+    p->ready[p->rlast].fd = e->fd;
+    p->ready[p->rlast].slot = slot;
+    p->ready[p->rlast].revents = revents;
+    p->rlast++;
+    return 1;
+}
+
+static int ready_pop(p_poller p, t_pollready *item) {
+    while (p->rfirst < p->rlast) {
+        *item = p->ready[p->rfirst++];
+        if (p->rfirst == p->rlast) p->rfirst = p->rlast = 0;
+        /* removed while it was waiting in the queue */
+        if (item->slot < 0) continue;
+        p->entries[item->slot].qindex = -1;
+        return 1;
+    }
+    return 0;
+}
+
+/*-------------------------------------------------------------------------*\
+* Backend specific registration
+\*-------------------------------------------------------------------------*/
+#ifdef POLLER_EPOLL
+static int backend_ctl(p_poller p, int op, t_pollentry *e) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    if (e->events & POLLER_READ) ev.events |= EPOLLIN | EPOLLRDHUP;
+    if (e->events & POLLER_WRITE) ev.events |= EPOLLOUT;
+    if (e->edge) ev.events |= EPOLLET;
+    ev.data.fd = e->fd;
+    return epoll_ctl(p->epfd, op, e->fd, &ev) == 0? IO_DONE: errno;
+}
+
+static int backend_revents(unsigned int events) {
+    int revents = 0;
+    if (events & (EPOLLIN | EPOLLRDHUP)) revents |= POLLER_READ;
+    if (events & EPOLLOUT) revents |= POLLER_WRITE;
+    /* report errors as readable too, so receive() returns the reason */
+    if (events & (EPOLLERR | EPOLLHUP)) revents |= POLLER_ERROR | POLLER_READ;
+    return revents;
+}
+#else
+static short backend_events(int events) {
+    short pevents = 0;
+    if (events & POLLER_READ) pevents |= POLLIN;
+    if (events & POLLER_WRITE) pevents |= POLLOUT;
+    return pevents;
+}
+
+static int backend_revents(short pevents) {
+    int revents = 0;
+    if (pevents & POLLIN) revents |= POLLER_READ;
+    if (pevents & POLLOUT) revents |= POLLER_WRITE;
+    if (pevents & (POLLERR | POLLHUP | POLLNVAL))
+        revents |= POLLER_ERROR | POLLER_READ;
+    return revents;
+}
+#endif
+
+/*-------------------------------------------------------------------------*\
+* Waits for the kernel and moves ready sockets into the ready queue
+\*-------------------------------------------------------------------------*/
+static int poller_collect(p_poller p, double t) {
+    int i, n, ms, ndirty = 0;
+    /* buffered input is ready without asking the kernel */
+    for (i = 0; i < p->count; i++) {
+        t_pollentry *e = &p->entries[i];
+        if ((e->events & POLLER_READ) && e->buf && !buffer_isempty(e->buf)) {
+            if (!ready_push(p, i, POLLER_READ)) return ENOMEM;
+            ndirty++;
+        }
+    }
+    /* nothing to wait for, never block the caller */
+    if (p->count == 0) return IO_DONE;
+    if (ndirty > 0) t = 0.0;
+    /* clamp long timeouts instead of overflowing the milliseconds */
+    if (t < 0.0) ms = -1;
+    else if (t*1.0e3 >= (double) INT_MAX) ms = INT_MAX;
+    else ms = (int) ceil(t*1.0e3);
+#ifdef POLLER_EPOLL
+    do {
+        n = epoll_wait(p->epfd, p->evs, p->maxevents, ms);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) return errno;
+    for (i = 0; i < n; i++) {
+        int slot = slot_get(p, p->evs[i].data.fd);
+        if (slot < 0) continue;
+        if (!ready_push(p, slot, backend_revents(p->evs[i].events))) return ENOMEM;
+    }
+#else
+    do {
+#ifdef _WIN32
+        n = WSAPoll(p->pfds, (ULONG) p->count, ms);
+#else
+        n = poll(p->pfds, (nfds_t) p->count, ms);
+#endif
+    } while (n < 0 && lasterror() == POLLER_EINTR);
+    if (n < 0) return lasterror();
+    for (i = 0; i < p->count && n > 0; i++) {
+        if (p->pfds[i].revents == 0) continue;
+        if (!ready_push(p, i, backend_revents(p->pfds[i].revents))) return ENOMEM;
+        p->pfds[i].revents = 0;
+        n--;
+    }
+#endif
+    return IO_DONE;
+}
+
+static void poller_destroy(p_poller p) {
+#ifdef POLLER_EPOLL
+    if (p->epfd >= 0) close(p->epfd);
+    p->epfd = -1;
+    free(p->evs);
+    p->evs = NULL;
+#else
+    free(p->pfds);
+    p->pfds = NULL;
+#endif
+    free(p->entries);
+    p->entries = NULL;
+    p->count = p->capacity = 0;
+    free(p->slots);
+    p->slots = NULL;
+    p->nslots = 0;
+    free(p->ready);
+    p->ready = NULL;
+    p->rfirst = p->rlast = p->rcapacity = 0;
+}
+
+static p_poller checkpoller(lua_State *L) {
+    p_poller p = (p_poller) auxiliar_checkclass(L, "poller{}", 1);
+    if (p->maxevents == 0) luaL_error(L, "attempt to use a closed poller");
+    return p;
+}
+
+/*=========================================================================*\
+* Lua methods
+\*=========================================================================*/
+/*-------------------------------------------------------------------------*\
+* Registers an object: poller:add(sock, [events], [callback], [mode])
+\*-------------------------------------------------------------------------*/
+static int meth_add(lua_State *L) {
+    p_poller p = checkpoller(L);
+    int events = checkevents(L, 3);
+    int edge = checkmode(L, 5);
+    t_socket fd;
+    t_pollentry *e;
+    p_tcp tcp;
+    int err;
+    luaL_checkany(L, 2);
+    if (!lua_isnoneornil(L, 4)) luaL_checktype(L, 4, LUA_TFUNCTION);
+    fd = getfd(L, 2);
+    if (fd == SOCKET_INVALID) luaL_argerror(L, 2, "object has no valid descriptor");
+    if (slot_get(p, fd) >= 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, "already registered");
+        return 2;
+    }
+    if (p->count == p->capacity) {
+        int capacity = p->capacity > 0? p->capacity*2: 64;
+        t_pollentry *entries = (t_pollentry *) realloc(p->entries,
+            capacity*sizeof(t_pollentry));
+        if (!entries) {
+            lua_pushnil(L);
+            lua_pushliteral(L, "out of memory");
+            return 2;
+        }
+        p->entries = entries;
+#ifndef POLLER_EPOLL
+        {
+            struct pollfd *pfds = (struct pollfd *) realloc(p->pfds,
+                capacity*sizeof(struct pollfd));
+            if (!pfds) {
+                lua_pushnil(L);
+                lua_pushliteral(L, "out of memory");
+                return 2;
+            }
+            p->pfds = pfds;
+        }
+#endif
+        p->capacity = capacity;
+    }
+    if (!slot_set(p, fd, p->count)) {
+        lua_pushnil(L);
+        lua_pushliteral(L, "out of memory");
+        return 2;
+    }
+    e = &p->entries[p->count];
+    e->fd = fd;
+    e->events = events;
+    e->edge = edge;
+    e->qindex = -1;
+    tcp = (p_tcp) auxiliar_getgroupudata(L, "tcp{any}", 2);
+    e->buf = tcp? &tcp->buf: NULL;
+#ifdef POLLER_EPOLL
+    err = backend_ctl(p, EPOLL_CTL_ADD, e);
+    if (err != IO_DONE) {
+        slot_set(p, fd, -1);
+        lua_pushnil(L);
+        lua_pushstring(L, socket_strerror(err));
+        return 2;
+    }
+#else
+    err = IO_DONE;
+    p->pfds[p->count].fd = fd;
+    p->pfds[p->count].events = backend_events(events);
+    p->pfds[p->count].revents = 0;
+#endif
+    p->count++;
+    /* keep the object alive while it is registered */
+    lua_getuservalue(L, 1);
+    lua_rawgeti(L, -1, POLLER_SOCKETS);
+    lua_pushvalue(L, 2);
+    lua_rawseti(L, -2, (lua_Integer) fd);
+    lua_rawgeti(L, -2, POLLER_CALLBACKS);
+    lua_pushvalue(L, 4);
+    lua_rawseti(L, -2, (lua_Integer) fd);
+    lua_pop(L, 3);
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* Changes registration: poller:modify(sock, events, [mode])
+\*-------------------------------------------------------------------------*/
+static int meth_modify(lua_State *L) {
+    p_poller p = checkpoller(L);
+    int events = checkevents(L, 3);
+    int edge = checkmode(L, 4);
+    t_socket fd = getfd(L, 2);
+    int slot = slot_get(p, fd);
+    t_pollentry *e;
+    if (slot < 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, "not registered");
+        return 2;
+    }
+    e = &p->entries[slot];
+    e->events = events;
+    e->edge = edge;
+#ifdef POLLER_EPOLL
+    {
+        int err = backend_ctl(p, EPOLL_CTL_MOD, e);
+        if (err != IO_DONE) {
+            lua_pushnil(L);
+            lua_pushstring(L, socket_strerror(err));
+            return 2;
+        }
+    }
+#else
+    p->pfds[slot].events = backend_events(events);
+#endif
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* Unregisters an object: poller:remove(sock)
+\*-------------------------------------------------------------------------*/
+static int meth_remove(lua_State *L) {
+    p_poller p = checkpoller(L);
+    t_socket fd = getfd(L, 2);
+    int slot = slot_get(p, fd), last;
+    t_pollentry *e;
+    if (slot < 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, "not registered");
+        return 2;
+    }
+    e = &p->entries[slot];
+#ifdef POLLER_EPOLL
+    /* the descriptor may already be closed, which removed it for us */
+    backend_ctl(p, EPOLL_CTL_DEL, e);
+#endif
+    if (e->qindex >= 0) p->ready[e->qindex].slot = -1;
+    slot_set(p, fd, -1);
+    /* keep the array dense by moving the last entry into the hole */
+    last = --p->count;
+    if (slot != last) {
+        p->entries[slot] = p->entries[last];
+#ifndef POLLER_EPOLL
+        p->pfds[slot] = p->pfds[last];
+#endif
+        slot_set(p, p->entries[slot].fd, slot);
+        if (p->entries[slot].qindex >= 0) p->ready[p->entries[slot].qindex].slot = slot;
+    }
+    lua_getuservalue(L, 1);
+    lua_rawgeti(L, -1, POLLER_SOCKETS);
+    lua_pushnil(L);
+    lua_rawseti(L, -2, (lua_Integer) fd);
+    lua_rawgeti(L, -2, POLLER_CALLBACKS);
+    lua_pushnil(L);
+    lua_rawseti(L, -2, (lua_Integer) fd);
+    lua_pop(L, 3);
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* Waits for readiness: n, ready, revents = poller:wait([timeout])
+* The returned tables are owned by the poller and reused by the next call.
+\*-------------------------------------------------------------------------*/
+static int meth_wait(lua_State *L) {
+    p_poller p = checkpoller(L);
+    double t = luaL_optnumber(L, 2, -1);
+    int i, n = 0, tsockets, tresults, trevents;
+    t_pollready item;
+    if (p->rfirst == p->rlast) {
+        int err = poller_collect(p, t);
+        if (err != IO_DONE) {
+            lua_pushnil(L);
+            lua_pushstring(L, socket_strerror(err));
+            return 2;
+        }
+    }
+    lua_settop(L, 1);
+    lua_getuservalue(L, 1);
+    lua_rawgeti(L, 2, POLLER_SOCKETS); tsockets = lua_gettop(L);
+    lua_rawgeti(L, 2, POLLER_RESULTS); tresults = lua_gettop(L);
+    lua_rawgeti(L, 2, POLLER_REVENTS); trevents = lua_gettop(L);
+    while (ready_pop(p, &item)) {
+        n++;
+        lua_rawgeti(L, tsockets, (lua_Integer) item.fd);
+        lua_rawseti(L, tresults, n);
+        lua_pushinteger(L, item.revents);
+        lua_rawseti(L, trevents, n);
+    }
+    /* clear what is left over from the previous call */
+    for (i = n + 1; i <= p->nresults; i++) {
+        lua_pushnil(L);
+        lua_rawseti(L, tresults, i);
+        lua_pushnil(L);
+        lua_rawseti(L, trevents, i);
+    }
+    p->nresults = n;
+    lua_pushinteger(L, n);
+    lua_pushvalue(L, tresults);
+    lua_pushvalue(L, trevents);
+    return 3;
+}
+
+/*-------------------------------------------------------------------------*\
+* Calls callback(sock, revents) for ready sockets without blocking, until
+* the time budget in seconds runs out: n = poller:dispatch([budget])
+\*-------------------------------------------------------------------------*/
+static int meth_dispatch(lua_State *L) {
+    p_poller p = checkpoller(L);
+    double budget = luaL_optnumber(L, 2, -1);
+    double deadline = budget >= 0.0? timeout_gettime() + budget: -1.0;
+    int n = 0, tsockets, tcallbacks;
+    t_pollready item;
+    if (p->rfirst == p->rlast) {
+        int err = poller_collect(p, 0.0);
+        if (err != IO_DONE) {
+            lua_pushnil(L);
+            lua_pushstring(L, socket_strerror(err));
+            return 2;
+        }
+    }
+    lua_settop(L, 1);
+    lua_getuservalue(L, 1);
+    lua_rawgeti(L, 2, POLLER_SOCKETS); tsockets = lua_gettop(L);
+    lua_rawgeti(L, 2, POLLER_CALLBACKS); tcallbacks = lua_gettop(L);
+    /* always make progress, even with an exhausted budget */
+    while ((n == 0 || deadline < 0.0 || timeout_gettime() < deadline)
+            && ready_pop(p, &item)) {
+        if (lua_rawgeti(L, tcallbacks, (lua_Integer) item.fd) != LUA_TFUNCTION) {
+            lua_pop(L, 1);
+            continue;
+        }
+        lua_rawgeti(L, tsockets, (lua_Integer) item.fd);
+        lua_pushinteger(L, item.revents);
+        lua_call(L, 2, 0);
+        n++;
+    }
+    lua_pushinteger(L, n);
+    lua_pushinteger(L, p->rlast - p->rfirst);
+    return 2;
+}
+
+/*-------------------------------------------------------------------------*\
+* Returns the number of registered objects
+\*-------------------------------------------------------------------------*/
+static int meth_count(lua_State *L) {
+    p_poller p = checkpoller(L);
+    lua_pushinteger(L, p->count);
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* Releases the poller and its registrations
+\*-------------------------------------------------------------------------*/
+static int meth_close(lua_State *L) {
+    p_poller p = (p_poller) auxiliar_checkclass(L, "poller{}", 1);
+    poller_destroy(p);
+    p->maxevents = 0;
+    lua_pushnil(L);
+    lua_setuservalue(L, 1);
+    lua_pushnumber(L, 1);
+    return 1;
+}
+
+/*=========================================================================*\
+* Library functions
+\*=========================================================================*/
+/*-------------------------------------------------------------------------*\
+* Creates a new poller: socket.poller([maxevents])
+\*-------------------------------------------------------------------------*/
+static int global_create(lua_State *L) {
+    int maxevents = (int) luaL_optinteger(L, 1, POLLER_MAXEVENTS);
+    p_poller p = (p_poller) lua_newuserdata(L, sizeof(t_poller));
+    memset(p, 0, sizeof(t_poller));
+    p->maxevents = maxevents > 0? maxevents: POLLER_MAXEVENTS;
+#ifdef POLLER_EPOLL
+    p->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (p->epfd < 0) {
+        int err = errno;
+        lua_pushnil(L);
+        lua_pushstring(L, socket_strerror(err));
+        return 2;
+    }
+    p->evs = (struct epoll_event *) malloc(p->maxevents*sizeof(struct epoll_event));
+#endif
+    auxiliar_setclass(L, "poller{}", -1);
+    /* registered objects, callbacks and the reusable result tables */
+    lua_createtable(L, 4, 0);
+    lua_newtable(L);
+    lua_rawseti(L, -2, POLLER_SOCKETS);
+    lua_newtable(L);
+    lua_rawseti(L, -2, POLLER_CALLBACKS);
+    lua_createtable(L, p->maxevents, 0);
+    lua_rawseti(L, -2, POLLER_RESULTS);
+    lua_createtable(L, p->maxevents, 0);
+    lua_rawseti(L, -2, POLLER_REVENTS);
+    lua_setuservalue(L, -2);
+    return 1;
+}
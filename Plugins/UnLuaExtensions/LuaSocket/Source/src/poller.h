@@ -0,0 +1,97 @@
+#ifndef POLLER_H
+#define POLLER_H
+/*=========================================================================*\
+* Poller object
+* LuaSocket toolkit
+*
+* A poller keeps a persistent set of registered sockets, so waiting for
+* readiness neither rebuilds descriptor sets nor calls back into Lua for
+* every socket like select() does, and it is not capped by FD_SETSIZE.
+* It is backed by epoll on Linux and by poll()/WSAPoll() elsewhere.
+*
+* Objects registered with a poller have to export method getfd(), which
+* is called once at registration time. Buffered tcp objects that still
+* have data in their input buffer are reported readable without waiting.
+*
+* The poller is meant to be driven from the game thread tick: dispatch()
+* invokes the registered callbacks until a time budget is exhausted and
+* keeps the remaining ready sockets queued for the next call.
+\*=========================================================================*/
+#include "luasocket.h"
+
+#include "buffer.h"
+#include "socket.h"
+
+#if defined(__linux__) && !defined(POLLER_NO_EPOLL)
+#define POLLER_EPOLL
+#include <sys/epoll.h>
+#elif !defined(_WIN32)
+#include <poll.h>
+#endif
+
+/* readiness flags seen by Lua */
+#define POLLER_READ     1
+#define POLLER_WRITE    2
+#define POLLER_ERROR    4
+
+/* default number of events fetched from the kernel per wait */
+#define POLLER_MAXEVENTS 256
+
+/* registered socket */
+typedef struct t_pollentry_ {
+    t_socket fd;
+    int events;             /* POLLER_READ and/or POLLER_WRITE */
+    int edge;               /* edge triggered (honoured by epoll only) */
+    int qindex;             /* position in the ready queue, or -1 */
+    p_buffer buf;           /* input buffer of tcp objects, or NULL */
+} t_pollentry;
+
+/* ready socket waiting to be reported */
+typedef struct t_pollready_ {
+    t_socket fd;
+    int slot;               /* index into entries, -1 once removed */
+    int revents;
+} t_pollready;
+
+#ifdef _WIN32
+/* descriptor -> index into entries, socket handles are not small integers */
+typedef struct t_pollslot_ {
+    t_socket fd;            /* SOCKET_INVALID when free */
+    int slot;
+} t_pollslot;
+#endif
+
+/* poller control structure */
+typedef struct t_poller_ {
+#ifdef POLLER_EPOLL
+    int epfd;
+    struct epoll_event *evs;    /* epoll_wait output, maxevents long */
+#else
+    struct pollfd *pfds;        /* parallel to entries */
+#endif
+    t_pollentry *entries;       /* dense array of registered sockets */
+    int count, capacity;
+#ifdef _WIN32
+    t_pollslot *slots;          /* open addressing hash, nslots is a power of 2 */
+#else
+    int *slots;                 /* descriptor -> index into entries */
+#endif
+    int nslots;
+    t_pollready *ready;         /* ready queue, [rfirst, rlast) is pending */
+    int rfirst, rlast, rcapacity;
+    int maxevents;
+    int nresults;               /* size of the result tables after last wait */
+} t_poller;
+typedef t_poller *p_poller;
+
+#ifndef _WIN32
+#pragma GCC visibility push(hidden)
+#endif
+
+int poller_open(lua_State *L);
+
+#ifndef _WIN32
+#pragma GCC visibility pop
+#endif
+
+#endif /* POLLER_H */
@@ -0,0 +1,246 @@
+/*=========================================================================*\
+* Byte slices
+* LuaSocket toolkit
+\*=========================================================================*/
+#include "luasocket.h"
+
+#include "auxiliar.h"
+#include "slice.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* number of pooled size classes, SLICE_MINBLOCK << (SLICE_CLASSES-1) is
+ * the largest pooled block */
+#define SLICE_CLASSES 16
+
+/* default limit of memory kept in the pool */
+#define SLICE_MAXCACHED (4*1024*1024)
+
+/*=========================================================================*\
+* Internal function prototypes
+\*=========================================================================*/
+static int global_slicepool(lua_State *L);
+static int meth_release(lua_State *L);
+static int meth_len(lua_State *L);
+static int meth_tostring(lua_State *L);
+static int meth_sub(lua_State *L);
+static int meth_byte(lua_State *L);
+static int meth_pointer(lua_State *L);
+
+/* slice object methods */
+static luaL_Reg slice_methods[] = {
+    {"__gc",        meth_release},
+    {"__len",       meth_len},
+    {"__tostring",  auxiliar_tostring},
+    {"byte",        meth_byte},
+    {"len",         meth_len},
+    {"pointer",     meth_pointer},
+    {"release",     meth_release},
+    {"sub",         meth_sub},
+    {"tostring",    meth_tostring},
+    {NULL,          NULL}
+};
+
+/* functions in library namespace */
+static luaL_Reg func[] = {
+    {"slicepool", global_slicepool},
+    {NULL, NULL}
+};
+
+/* free blocks by size class */
+static p_sliceblock pool[SLICE_CLASSES];
+static size_t pooled = 0;
+static size_t maxpooled = SLICE_MAXCACHED;
+
+/*-------------------------------------------------------------------------*\
+* Initializes module
+\*-------------------------------------------------------------------------*/
+int slice_open(lua_State *L) {
+    auxiliar_newclass(L, SLICE_CLASS, slice_methods);
+    luaL_setfuncs(L, func, 0);
+    return 0;
+}
+
+/*=========================================================================*\
+* Internal functions
+\*=========================================================================*/
+static int sizeclass(size_t capacity) {
+    int c = 0;
+    size_t size = SLICE_MINBLOCK;
+    while (size < capacity && c < SLICE_CLASSES) {
+        size <<= 1;
+        c++;
+    }
+    return c;
+}
+
+static void trim(size_t limit) {
+    int c;
+    for (c = SLICE_CLASSES-1; c >= 0 && pooled > limit; c--) {
+        while (pool[c] && pooled > limit) {
+            p_sliceblock block = pool[c];
+            pool[c] = block->next;
+            pooled -= block->capacity;
+            free(block);
+        }
+    }
+}
+
+static p_slice checkslice(lua_State *L, int idx) {
+    p_slice slice = (p_slice) auxiliar_checkclass(L, SLICE_CLASS, idx);
+    if (!slice->block) luaL_argerror(L, idx, "slice has been released");
+    return slice;
+}
+
+/*-------------------------------------------------------------------------*\
+* Returns a block of at least capacity bytes holding one reference
+\*-------------------------------------------------------------------------*/
+p_sliceblock slice_alloc(size_t capacity) {
+    int c = sizeclass(capacity);
+    p_sliceblock block;
+    if (c < SLICE_CLASSES && pool[c]) {
+        block = pool[c];
+        pool[c] = block->next;
+        pooled -= block->capacity;
+    } else {
+        /* unpooled sizes are allocated exactly */
+        size_t size = c < SLICE_CLASSES ? (size_t) SLICE_MINBLOCK << c : capacity;
+        block = (p_sliceblock) malloc(offsetof(t_sliceblock, data) + size);
+        if (!block) return NULL;
+        block->capacity = size;
+    }
+    block->next = NULL;
+    block->refs = 1;
+    return block;
+}
+
+/*-------------------------------------------------------------------------*\
+* Makes room for capacity bytes in a block only referenced by the caller,
+* keeping the first used bytes
+\*-------------------------------------------------------------------------*/
+p_sliceblock slice_grow(p_sliceblock block, size_t used, size_t capacity) {
+    p_sliceblock grown;
+    if (block && block->capacity >= capacity) return block;
+    grown = slice_alloc(capacity);
+    if (!grown) return NULL;
+    if (block) {
+        memcpy(grown->data, block->data, used);
+        slice_unref(block);
+    }
+    return grown;
+}
+
+/*-------------------------------------------------------------------------*\
+* Drops a reference, the last one returns the block to the pool
+\*-------------------------------------------------------------------------*/
+void slice_unref(p_sliceblock block) {
+    int c;
+    if (--block->refs > 0) return;
+    c = sizeclass(block->capacity);
+    if (c < SLICE_CLASSES && pooled + block->capacity <= maxpooled) {
+        block->next = pool[c];
+        pool[c] = block;
+        pooled += block->capacity;
+    } else free(block);
+}
+
+/*-------------------------------------------------------------------------*\
+* Pushes a slice over [offset, offset+len) of block, taking a new reference
+\*-------------------------------------------------------------------------*/
+p_slice slice_push(lua_State *L, p_sliceblock block, size_t offset, size_t len) {
+    p_slice slice = (p_slice) lua_newuserdata(L, sizeof(t_slice));
+    slice->data = block->data + offset;
+    slice->len = len;
+    slice->block = block;
+    block->refs++;
+    auxiliar_setclass(L, SLICE_CLASS, -1);
+    return slice;
+}
+
+/*=========================================================================*\
+* Lua methods
+\*=========================================================================*/
+/*-------------------------------------------------------------------------*\
+* socket.slicepool([maxbytes]) sets the pool limit and returns the pooled
+* bytes and the limit
+\*-------------------------------------------------------------------------*/
+static int global_slicepool(lua_State *L) {
+    if (!lua_isnoneornil(L, 1)) {
+        lua_Number limit = luaL_checknumber(L, 1);
+        luaL_argcheck(L, limit >= 0, 1, "invalid pool size");
+        maxpooled = (size_t) limit;
+        trim(maxpooled);
+    }
+    lua_pushnumber(L, (lua_Number) pooled);
+    lua_pushnumber(L, (lua_Number) maxpooled);
+    return 2;
+}
+
+/*-------------------------------------------------------------------------*\
+* Drops the reference of the slice, also used as __gc
+\*-------------------------------------------------------------------------*/
+static int meth_release(lua_State *L) {
+    p_slice slice = (p_slice) auxiliar_checkclass(L, SLICE_CLASS, 1);
+    if (slice->block) {
+        slice_unref(slice->block);
+        slice->block = NULL;
+        slice->data = NULL;
+        slice->len = 0;
+    }
+    return 0;
+}
+
+static int meth_len(lua_State *L) {
+    p_slice slice = (p_slice) auxiliar_checkclass(L, SLICE_CLASS, 1);
+    lua_pushinteger(L, (lua_Integer) slice->len);
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* Copies the slice into a Lua string
+\*-------------------------------------------------------------------------*/
+static int meth_tostring(lua_State *L) {
+    p_slice slice = checkslice(L, 1);
+    lua_pushlstring(L, slice->data, slice->len);
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* Slice of a slice, with the index rules of string.sub, sharing the block
+\*-------------------------------------------------------------------------*/
+static int meth_sub(lua_State *L) {
+    p_slice slice = checkslice(L, 1);
+    lua_Integer len = (lua_Integer) slice->len;
+    lua_Integer i = luaL_checkinteger(L, 2);
+    lua_Integer j = luaL_optinteger(L, 3, -1);
+    if (i < 0) i = len + i + 1;
+    if (j < 0) j = len + j + 1;
+    if (i < 1) i = 1;
+    if (j > len) j = len;
+    if (i > j) i = 1, j = 0;
+    slice_push(L, slice->block, (size_t) (slice->data - slice->block->data) + (size_t) (i - 1),
+        (size_t) (j - i + 1));
+    return 1;
+}
+
+static int meth_byte(lua_State *L) {
+    p_slice slice = checkslice(L, 1);
+    lua_Integer i = luaL_optinteger(L, 2, 1);
+    if (i < 0) i = (lua_Integer) slice->len + i + 1;
+    if (i < 1 || i > (lua_Integer) slice->len) return 0;
+    lua_pushinteger(L, (unsigned char) slice->data[i-1]);
+    return 1;
+}
+
+/*-------------------------------------------------------------------------*\
+* Returns a light userdata to the bytes and their count, the way
+* rapidjson.decode() accepts memory. Valid while the slice is alive
+\*-------------------------------------------------------------------------*/
+static int meth_pointer(lua_State *L) {
+    p_slice slice = checkslice(L, 1);
+    lua_pushlightuserdata(L, (void *) slice->data);
+    lua_pushinteger(L, (lua_Integer) slice->len);
+    return 2;
+}
@@ -0,0 +1,58 @@
+#ifndef SLICE_H
+#define SLICE_H
+/*=========================================================================*\
+* Byte slices
+* LuaSocket toolkit
+*
+* A slice is a read-only view into a reference counted block of memory.
+* Receiving into slices avoids interning every message as a Lua string,
+* and sub-slices share the block of their parent instead of copying.
+*
+* Blocks come from a pool of power of two size classes, so steady traffic
+* stops allocating once the pool is warm. A block returns to the pool when
+* its last slice is released, explicitly with release() or by the GC.
+*
+* Other modules can read slices without linking against LuaSocket: the
+* userdata is registered under SLICE_CLASS and starts with the data pointer
+* and the length, in this order. A released slice has a NULL data pointer.
+* The pool is not thread safe, slices belong to the game thread.
+\*=========================================================================*/
+#include "luasocket.h"
+
+#define SLICE_CLASS "slice{}"
+
+/* smallest block handed out by the pool */
+#define SLICE_MINBLOCK 4096
+
+/* reference counted storage shared by slices */
+typedef struct t_sliceblock_ {
+    struct t_sliceblock_ *next; /* free list link while pooled */
+    size_t capacity;
+    int refs;
+    char data[1];
+} t_sliceblock;
+typedef t_sliceblock *p_sliceblock;
+
+/* slice userdata */
+typedef struct t_slice_ {
+    const char *data;
+    size_t len;
+    p_sliceblock block;         /* NULL once released */
+} t_slice;
+typedef t_slice *p_slice;
+
+#ifndef _WIN32
+#pragma GCC visibility push(hidden)
+#endif
+
+int slice_open(lua_State *L);
+p_sliceblock slice_alloc(size_t capacity);
+p_sliceblock slice_grow(p_sliceblock block, size_t used, size_t capacity);
+void slice_unref(p_sliceblock block);
+p_slice slice_push(lua_State *L, p_sliceblock block, size_t offset, size_t len);
+
+#ifndef _WIN32
+#pragma GCC visibility pop
+#endif
+
+#endif /* SLICE_H */
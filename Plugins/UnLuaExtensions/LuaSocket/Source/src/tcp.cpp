@@ -30,6 +30,8 @@ static int meth_getsockname(lua_State *L);
 static int meth_getpeername(lua_State *L);
 static int meth_shutdown(lua_State *L);
 static int meth_receive(lua_State *L);
+static int meth_receiveslice(lua_State *L);
+static int meth_setbuffersize(lua_State *L);
 static int meth_accept(lua_State *L);
 static int meth_close(lua_State *L);
 static int meth_getoption(lua_State *L);
@@ -58,7 +60,9 @@ static luaL_Reg tcp_methods[] = {
     {"setstats",    meth_setstats},
     {"listen",      meth_listen},
     {"receive",     meth_receive},
+    {"receiveslice", meth_receiveslice},
     {"send",        meth_send},
+    {"setbuffersize", meth_setbuffersize},
     {"setfd",       meth_setfd},
     {"setoption",   meth_setoption},
     {"setpeername", meth_connect},
@@ -155,6 +159,16 @@ static int meth_receive(lua_State *L) {
     return buffer_meth_receive(L, &tcp->buf);
 }
 
+static int meth_receiveslice(lua_State *L) {
+    p_tcp tcp = (p_tcp) auxiliar_checkclass(L, "tcp{client}", 1);
+    return buffer_meth_receiveslice(L, &tcp->buf);
+}
+
+static int meth_setbuffersize(lua_State *L) {
+    p_tcp tcp = (p_tcp) auxiliar_checkgroup(L, "tcp{any}", 1);
+    return buffer_meth_setbuffersize(L, &tcp->buf);
+}
+
 static int meth_getstats(lua_State *L) {
     p_tcp tcp = (p_tcp) auxiliar_checkclass(L, "tcp{client}", 1);
     return buffer_meth_getstats(L, &tcp->buf);
@@ -293,6 +307,7 @@ static int meth_close(lua_State *L)
 {
     p_tcp tcp = (p_tcp) auxiliar_checkgroup(L, "tcp{any}", 1);
     socket_destroy(&tcp->sock);
+    buffer_destroy(&tcp->buf);
     lua_pushnumber(L, 1);
     return 1;
 }
@@ -15,6 +15,16 @@
 #include "Perfs/UnLuaBenchmarkFunctionLibrary.h"
 #include "Misc/DateTime.h"
 #include "Misc/FileHelper.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "LuaEnv.h"
+#include "LuaEnvSnapshot.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "LuaScriptArchive.h"
+#include "LuaSharedData.h"
+#include "UnLuaSettings.h"
+#include "UnLuaModule.h"
 
 double UUnLuaBenchmarkFunctionLibrary::StartTime;
 FString UUnLuaBenchmarkFunctionLibrary::StartTitle;
@@ -43,6 +53,281 @@ void UUnLuaBenchmarkFunctionLibrary::StopTimer()
     Messages.Add(Message);
 }
 
+void UUnLuaBenchmarkFunctionLibrary::Record(const FString& Title, const float Value)
+{
+    const auto Message = FString::Printf(TEXT("%s ; %f"), *Title, Value);
+    Messages.Add(Message);
+}
+
+void UUnLuaBenchmarkFunctionLibrary::SpawnActors(UObject* WorldContextObject, TSubclassOf<AActor> Class, const int32 N, TArray<AActor*>& OutActors)
+{
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    if (!World)
+        return;
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    OutActors.Reserve(OutActors.Num() + N);
+    for (int32 i = 0; i < N; i++)
+        OutActors.Add(World->SpawnActor<AActor>(Class, FTransform::Identity, SpawnParameters));
+}
+
+void UUnLuaBenchmarkFunctionLibrary::DestroyActors(const TArray<AActor*>& Actors)
+{
+    for (AActor* Actor : Actors)
+    {
+        if (Actor)
+            Actor->Destroy();
+    }
+}
+
+void UUnLuaBenchmarkFunctionLibrary::TickActors(const TArray<AActor*>& Actors, const int32 NumFrames)
+{
+    struct FReceiveTickParams
+    {
+        float DeltaSeconds;
+    };
+    FReceiveTickParams Params{1.0f / 60};
+
+    UFunction* ReceiveTick = nullptr;
+    const UClass* ReceiveTickClass = nullptr;
+    for (int32 Frame = 0; Frame < NumFrames; Frame++)
+    {
+        for (AActor* Actor : Actors)
+        {
+            if (!Actor)
+                continue;
+            if (Actor->GetClass() != ReceiveTickClass)
+            {
+                ReceiveTickClass = Actor->GetClass();
+                ReceiveTick = Actor->FindFunctionChecked(TEXT("ReceiveTick"));
+            }
+            Actor->ProcessEvent(ReceiveTick, &Params);
+        }
+    }
+}
+
+void UUnLuaBenchmarkFunctionLibrary::TickActorsBatched(UObject* WorldContextObject, const int32 NumFrames)
+{
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    UnLua::FLuaEnv* Env = IUnLuaModule::Get().GetEnv(WorldContextObject);
+    if (!World || !Env)
+        return;
+
+    const auto TickRegistry = Env->GetTickRegistry();
+    for (int32 Frame = 0; Frame < NumFrames; Frame++)
+        TickRegistry->Tick(World, TG_PrePhysics, 1.0f / 60);
+
+    TArray<UnLua::FTickRegistry::FModuleStats> Stats;
+    TickRegistry->GetStats(Stats);
+    for (const auto& ModuleStats : Stats)
+    {
+        Record(FString::Printf(TEXT("%s ticks"), *ModuleStats.ModuleName), (float)ModuleStats.NumTicks);
+        Record(FString::Printf(TEXT("%s ms"), *ModuleStats.ModuleName), (float)(ModuleStats.Seconds * 1000));
+    }
+}
+
+void UUnLuaBenchmarkFunctionLibrary::TickCoroutines(UObject* WorldContextObject, const int32 NumFrames, const float DeltaSeconds)
+{
+    UnLua::FLuaEnv* Env = IUnLuaModule::Get().GetEnv(WorldContextObject);
+    if (!Env)
+        return;
+
+    const auto Scheduler = Env->GetCoroutineScheduler();
+    for (int32 Frame = 0; Frame < NumFrames; Frame++)
+        Scheduler->Tick(DeltaSeconds);
+}
+
+void UUnLuaBenchmarkFunctionLibrary::RecordCoroutinePool(UObject* WorldContextObject)
+{
+    UnLua::FLuaEnv* Env = IUnLuaModule::Get().GetEnv(WorldContextObject);
+    if (!Env)
+        return;
+
+    const auto Pool = Env->GetCoroutinePool();
+    const int64 NumSpawns = Pool->GetNumHits() + Pool->GetNumMisses();
+    Record(TEXT("pool hits"), (float)Pool->GetNumHits());
+    Record(TEXT("pool misses"), (float)Pool->GetNumMisses());
+    Record(TEXT("pool hit rate"), NumSpawns > 0 ? (float)Pool->GetNumHits() / NumSpawns : 0.0f);
+}
+
+void UUnLuaBenchmarkFunctionLibrary::TickPropertyWatchers(UObject* WorldContextObject, const int32 NumFrames)
+{
+    UnLua::FLuaEnv* Env = IUnLuaModule::Get().GetEnv(WorldContextObject);
+    if (!Env)
+        return;
+
+    const auto Watcher = Env->GetPropertyWatcher();
+    for (int32 Frame = 0; Frame < NumFrames; Frame++)
+        Watcher->Tick();
+}
+
+void UUnLuaBenchmarkFunctionLibrary::TickLatentActions(UObject* WorldContextObject, const int32 NumFrames, const float DeltaSeconds)
+{
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    if (!World)
+        return;
+
+    auto& LatentActionManager = World->GetLatentActionManager();
+    for (int32 Frame = 0; Frame < NumFrames; Frame++)
+    {
+        LatentActionManager.BeginFrame();
+        LatentActionManager.ProcessLatentActions(nullptr, DeltaSeconds);
+    }
+}
+
+void UUnLuaBenchmarkFunctionLibrary::RequireInEnvs(const FString& ModuleName, const int32 NumEnvs, const bool bSharedData)
+{
+    auto& SharedDataModules = GetMutableDefault<UUnLuaSettings>()->SharedDataModules;
+    const bool bWasShared = SharedDataModules.Contains(ModuleName);
+    if (bSharedData)
+        SharedDataModules.AddUnique(ModuleName);
+    else
+        SharedDataModules.Remove(ModuleName);
+
+    const auto Title = FString::Printf(TEXT("require x%d envs%s"), NumEnvs, bSharedData ? TEXT(" shared") : TEXT(""));
+    const auto Chunk = FString::Printf(TEXT("require('%s')"), *ModuleName);
+    TArray<TUniquePtr<UnLua::FLuaEnv>> Envs;
+    int32 LuaKB = 0;
+    double Seconds = 0;
+    for (int32 i = 0; i < NumEnvs; i++)
+    {
+        const auto& Env = Envs.Add_GetRef(MakeUnique<UnLua::FLuaEnv>());
+        const auto L = Env->GetMainState();
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        const int32 Before = lua_gc(L, LUA_GCCOUNT, 0);
+        const double Start = FPlatformTime::Seconds();
+        Env->DoString(Chunk);
+        Seconds += FPlatformTime::Seconds() - Start;
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        LuaKB += lua_gc(L, LUA_GCCOUNT, 0) - Before;
+    }
+
+    Record(Title + TEXT(" ms"), (float)(Seconds * 1000));
+    Record(Title + TEXT(" lua memory KB"), LuaKB);
+    Record(Title + TEXT(" shared memory KB"), UnLua::FLuaSharedData::GetAllocatedSize() / 1024.0f);
+    Envs.Empty();
+
+    if (bWasShared)
+        SharedDataModules.AddUnique(ModuleName);
+    else
+        SharedDataModules.Remove(ModuleName);
+}
+
+void UUnLuaBenchmarkFunctionLibrary::StartEnvs(const FString& StartupModuleName, const int32 NumEnvs)
+{
+    const auto FilePath = FPaths::ProjectSavedDir() / TEXT("Benchmark/StartupSnapshot.bin");
+    {
+        UnLua::FLuaEnv Env;
+        if (!UnLua::FLuaEnvSnapshot::Save(Env, StartupModuleName, {}, FilePath))
+            return;
+    }
+
+    double ColdSeconds = 0;
+    double SnapshotSeconds = 0;
+    for (int32 i = 0; i < NumEnvs; i++)
+    {
+        double Start = FPlatformTime::Seconds();
+        {
+            UnLua::FLuaEnv Env;
+            Env.Start(StartupModuleName, {});
+            ColdSeconds += FPlatformTime::Seconds() - Start;
+        }
+
+        Start = FPlatformTime::Seconds();
+        {
+            UnLua::FLuaEnv Env;
+            UnLua::FLuaEnvSnapshot::Load(Env, FilePath);
+            SnapshotSeconds += FPlatformTime::Seconds() - Start;
+        }
+    }
+
+    Record(FString::Printf(TEXT("cold start x%d ms"), NumEnvs), (float)(ColdSeconds * 1000));
+    Record(FString::Printf(TEXT("snapshot start x%d ms"), NumEnvs), (float)(SnapshotSeconds * 1000));
+    Record(TEXT("snapshot KB"), IFileManager::Get().FileSize(*FilePath) / 1024.0f);
+    IFileManager::Get().Delete(*FilePath);
+}
+
+TArray<FString> UUnLuaBenchmarkFunctionLibrary::GenerateModules(const FString& PackageDir, const int32 NumModules)
+{
+    TArray<FString> ModuleNames;
+    for (int32 i = 0; i < NumModules; i++)
+    {
+        const auto ModuleName = FString::Printf(TEXT("Module%d"), i);
+        const auto FilePath = FPaths::ProjectDir() / PackageDir / ModuleName + TEXT(".lua");
+        if (!IFileManager::Get().FileExists(*FilePath))
+        {
+            FString Content = TEXT("local M = {}\n\n");
+            for (int32 j = 0; j < 20; j++)
+                Content += FString::Printf(TEXT("function M:Func%d(A, B)\n\tlocal T = { A, B, %d, \"%s\" }\n\tfor i = 1, #T do\n\t\tA = A + i\n\tend\n\treturn A * B + #T\nend\n\n"), j, j, *ModuleName);
+            Content += TEXT("return M\n");
+            FFileHelper::SaveStringToFile(Content, *FilePath);
+        }
+        ModuleNames.Add(ModuleName);
+    }
+    return ModuleNames;
+}
+
+void UUnLuaBenchmarkFunctionLibrary::RequireModules(const int32 NumModules, const bool bPreload)
+{
+    const FString PackageDir = TEXT("Saved/Benchmark/PreloadModules");
+    const auto ModuleNames = GenerateModules(PackageDir, NumModules);
+
+    auto& PreloadModules = GetMutableDefault<UUnLuaSettings>()->PreloadModules;
+    const auto OldPreloadModules = PreloadModules;
+    PreloadModules = bPreload ? ModuleNames : TArray<FString>();
+
+    const auto Chunk = FString::Printf(TEXT("for i = 0, %d do require('Module' .. i) end"), NumModules - 1);
+    const double Start = FPlatformTime::Seconds();
+    {
+        UnLua::FLuaEnv Env;
+        Env.DoString(FString::Printf(TEXT("UnLua.PackagePath = '%s/?.lua'"), *PackageDir));
+        Env.Start(TEXT(""), {});
+        Env.DoString(Chunk);
+    }
+    const double Seconds = FPlatformTime::Seconds() - Start;
+    PreloadModules = OldPreloadModules;
+
+    Record(FString::Printf(TEXT("start and require %d modules%s ms"), NumModules, bPreload ? TEXT(" preloaded") : TEXT("")), (float)(Seconds * 1000));
+}
+
+void UUnLuaBenchmarkFunctionLibrary::RequireModulesFromArchive(const int32 NumModules, const bool bCompress)
+{
+    const FString PackageDir = TEXT("Saved/Benchmark/PreloadModules");
+    const auto ModuleNames = GenerateModules(PackageDir, NumModules);
+
+    TArray<UnLua::FLuaScriptArchive::FModule> Modules;
+    for (const auto& ModuleName : ModuleNames)
+    {
+        const auto FilePath = FPaths::ProjectDir() / PackageDir / ModuleName + TEXT(".lua");
+        TArray<uint8> Source;
+        FString Error;
+        auto& Module = Modules.AddDefaulted_GetRef();
+        Module.Name = ModuleName;
+        FFileHelper::LoadFileToArray(Source, *FilePath);
+        UnLua::FLuaScriptArchive::Compile(Source, FilePath, false, Module.Data, Error);
+    }
+
+    const auto ArchivePath = FPaths::ProjectSavedDir() / TEXT("Benchmark/PreloadModules.ulsa");
+    if (!UnLua::FLuaScriptArchive::Write(ArchivePath, MoveTemp(Modules), bCompress))
+        return;
+
+    const auto Chunk = FString::Printf(TEXT("for i = 0, %d do require('Module' .. i) end"), NumModules - 1);
+    const double Start = FPlatformTime::Seconds();
+    {
+        UnLua::FLuaEnv Env;
+        Env.AddArchive(UnLua::FLuaScriptArchive::Mount(ArchivePath));
+        Env.DoString(TEXT("UnLua.PackagePath = ''"));
+        Env.Start(TEXT(""), {});
+        Env.DoString(Chunk);
+    }
+    const double Seconds = FPlatformTime::Seconds() - Start;
+
+    Record(FString::Printf(TEXT("start and require %d modules from %sarchive ms"), NumModules, bCompress ? TEXT("compressed ") : TEXT("")), (float)(Seconds * 1000));
+    Record(FString::Printf(TEXT("%sarchive KB"), bCompress ? TEXT("compressed ") : TEXT("")), IFileManager::Get().FileSize(*ArchivePath) / 1024.0f);
+    IFileManager::Get().Delete(*ArchivePath);
+}
+
 void UUnLuaBenchmarkFunctionLibrary::Stop()
 {
     const auto Message = FString::Join(Messages, TEXT("\n"));
@@ -15,13 +15,33 @@
 #include "UnLuaBase.h"
 #include "UnLuaTemplate.h"
 #include "UnLuaTestHelpers.h"
+#include "UnLuaSettings.h"
+#include "UnLuaDelegates.h"
+#include "LuaEnvSnapshot.h"
+#include "LuaScriptArchive.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 #include "Misc/AutomationTest.h"
+#include "Misc/Crc.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
 
 
 BEGIN_DEFINE_SPEC(FLuaEnvSpec, "UnLua.API.FLuaEnv", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
     TSharedPtr<UnLua::FLuaEnv> Env;
+    UUnLuaTestModuleLocator* Locator;
+    TSubclassOf<ULuaModuleLocator> SavedLocatorClass;
+
+    bool IsInObjectMap(const UObject* Object) const
+    {
+        const auto L = Env->GetMainState();
+        lua_getfield(L, LUA_REGISTRYINDEX, "UnLua_ObjectMap");
+        lua_pushlightuserdata(L, (void*)Object);
+        const bool bFound = lua_rawget(L, -2) != LUA_TNIL;
+        lua_pop(L, 2);
+        return bFound;
+    }
 END_DEFINE_SPEC(FLuaEnvSpec)
 
 void FLuaEnvSpec::Define()
@@ -62,6 +82,395 @@ void FLuaEnvSpec::Define()
         });
     });
 
+    Describe(TEXT("启动快照"), [this]()
+    {
+        It(TEXT("从快照启动的环境和执行启动模块的结果一致"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto FilePath = FPaths::ProjectSavedDir() / TEXT("Automation/LuaEnvSnapshot.bin");
+            {
+                UnLua::FLuaEnv Env1;
+                TEST_TRUE(UnLua::FLuaEnvSnapshot::Save(Env1, TEXT("Tests.Specs.LuaEnv.Snapshot"), {}, FilePath));
+                TEST_TRUE(Env1.IsStarted());
+            }
+
+            UnLua::FLuaEnv Env2;
+            TEST_TRUE(UnLua::FLuaEnvSnapshot::Load(Env2, FilePath));
+            TEST_TRUE(Env2.IsStarted());
+
+            const auto L = Env2.GetMainState();
+            Env2.DoString(R"(
+            local T = SnapshotTest
+            T.Inc()
+            return T.Get(), T.Node.Self == T.Node, T.Lazy.x, T.ActorClass == UE.AActor, T.Print == print, package.loaded["Tests.Specs.LuaEnv.Snapshot"] == T
+            )");
+            TEST_EQUAL(lua_tointeger(L, -6), 1LL);
+            TEST_TRUE(!!lua_toboolean(L, -5));
+            TEST_EQUAL(lua_tostring(L, -4), "x!");
+            TEST_TRUE(!!lua_toboolean(L, -3));
+            TEST_TRUE(!!lua_toboolean(L, -2));
+            TEST_TRUE(!!lua_toboolean(L, -1));
+
+            IFileManager::Get().Delete(*FilePath);
+        });
+    });
+
+    Describe(TEXT("预加载模块"), [this]()
+    {
+        It(TEXT("require预加载的模块和直接require的结果一致"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            Env->PreloadModules({TEXT("Tests.Specs.LuaEnv.Preload"), TEXT("Tests.Specs.LuaEnv.NotExists")});
+
+            const auto L = Env->GetMainState();
+            Env->DoString(R"(
+            local M = require("Tests.Specs.LuaEnv.Preload")
+            M.Inc()
+            return M.Inc(), debug.getinfo(M.Inc, "S").source:find("Preload.lua", 1, true) ~= nil, (pcall(require, "Tests.Specs.LuaEnv.NotExists"))
+            )");
+            TEST_EQUAL(lua_tointeger(L, -3), 2LL);
+            TEST_TRUE(!!lua_toboolean(L, -2));
+            TEST_FALSE(lua_toboolean(L, -1));
+        });
+    });
+
+    Describe(TEXT("模块文件索引"), [this]()
+    {
+        It(TEXT("新增的脚本文件在重置索引之后才能require到"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Dir = FPaths::ProjectSavedDir() / TEXT("Automation/LuaEnvModuleIndex");
+            IFileManager::Get().DeleteDirectory(*Dir, false, true);
+
+            const auto L = Env->GetMainState();
+            Env->DoString("UnLua.PackagePath = 'Saved/Automation/LuaEnvModuleIndex/?.lua'");
+            Env->DoString("return (pcall(require, 'Sub.Added'))");
+            TEST_FALSE(lua_toboolean(L, -1));
+
+            FFileHelper::SaveStringToFile(TEXT("return 42"), *(Dir / TEXT("Sub/Added.lua")));
+            Env->DoString("return (pcall(require, 'Sub.Added'))");
+            TEST_FALSE(lua_toboolean(L, -1));
+
+            Env->ResetModuleFileIndex();
+            Env->DoString("return require('Sub.Added')");
+            TEST_EQUAL(lua_tointeger(L, -1), 42LL);
+
+            IFileManager::Get().DeleteDirectory(*Dir, false, true);
+        });
+    });
+
+    Describe(TEXT("脚本归档"), [this]()
+    {
+        It(TEXT("从归档加载源码、字节码和压缩的模块"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto FilePath = FPaths::ProjectSavedDir() / TEXT("Automation/LuaEnvScriptArchive.ulsa");
+            const FString Source = TEXT("return { Value = 1 }");
+            const FTCHARToUTF8 SourceUTF8(*Source);
+
+            // A is still read after B and C are added
+            TArray<UnLua::FLuaScriptArchive::FModule> Modules;
+            Modules.Reserve(3);
+            auto& A = Modules.AddDefaulted_GetRef();
+            A.Name = TEXT("Archived.Source");
+            A.Data.Append((const uint8*)SourceUTF8.Get(), SourceUTF8.Length());
+            auto& B = Modules.AddDefaulted_GetRef();
+            B.Name = TEXT("Archived.Bytecode");
+            FString Error;
+            TEST_TRUE(UnLua::FLuaScriptArchive::Compile(A.Data, TEXT("Archived/Bytecode.lua"), false, B.Data, Error));
+            auto& C = Modules.AddDefaulted_GetRef();
+            C.Name = TEXT("Archived.Compressed");
+            for (int32 i = 0; i < 100; i++)
+                C.Data.Append((const uint8*)"-------\n", 8);
+            C.Data.Append(A.Data);
+            const auto Hash = FCrc::MemCrc32(C.Data.GetData(), C.Data.Num());
+            TEST_TRUE(UnLua::FLuaScriptArchive::Write(FilePath, Modules, true));
+
+            {
+                const auto Archive = UnLua::FLuaScriptArchive::Mount(FilePath);
+                TEST_TRUE(Archive.IsValid());
+                TEST_EQUAL(Archive->Num(), 3);
+                TEST_EQUAL(Archive->GetHash("Archived.Compressed"), Hash);
+                TEST_FALSE(Archive->Contains("Archived"));
+
+                Env->AddArchive(Archive);
+                Env->DoString(R"(
+                return require("Archived.Source").Value + require("Archived.Bytecode").Value + require("Archived.Compressed").Value, (pcall(require, "Archived.None"))
+                )");
+                const auto L = Env->GetMainState();
+                TEST_EQUAL(lua_tointeger(L, -2), 3LL);
+                TEST_FALSE(lua_toboolean(L, -1));
+            }
+
+            Env.Reset();
+            IFileManager::Get().Delete(*FilePath);
+        });
+
+        It(TEXT("绑定了旧版CustomLoadLuaFile时仍从归档加载"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto FilePath = FPaths::ProjectSavedDir() / TEXT("Automation/LuaEnvLegacyLoader.ulsa");
+            const FTCHARToUTF8 SourceUTF8(TEXT("return { Value = 7 }"));
+
+            TArray<UnLua::FLuaScriptArchive::FModule> Modules;
+            auto& Module = Modules.AddDefaulted_GetRef();
+            Module.Name = TEXT("Archived.Legacy");
+            Module.Data.Append((const uint8*)SourceUTF8.Get(), SourceUTF8.Length());
+            TEST_TRUE(UnLua::FLuaScriptArchive::Write(FilePath, Modules, false));
+
+            int32 NumCalls = 0;
+            FUnLuaDelegates::CustomLoadLuaFile.BindLambda([&NumCalls](UnLua::FLuaEnv&, const FString&, TArray<uint8>&, FString&)
+            {
+                NumCalls++;
+                return false;
+            });
+
+            {
+                const auto Archive = UnLua::FLuaScriptArchive::Mount(FilePath);
+                TEST_TRUE(Archive.IsValid());
+                Env->AddArchive(Archive);
+                Env->DoString("return require('Archived.Legacy').Value");
+                TEST_EQUAL(lua_tointeger(Env->GetMainState(), -1), 7LL);
+                TEST_TRUE(NumCalls > 0);
+            }
+
+            FUnLuaDelegates::CustomLoadLuaFile.Unbind();
+            Env.Reset();
+            IFileManager::Get().Delete(*FilePath);
+        });
+    });
+
+    Describe(TEXT("共享数据模块"), [this]()
+    {
+        BeforeEach([this]
+        {
+            GetMutableDefault<UUnLuaSettings>()->SharedDataModules.Add(TEXT("Tests.Specs.LuaEnv.SharedData"));
+        });
+
+        It(TEXT("多个Lua环境读取同一份只读数据"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UnLua::FLuaEnv Env1;
+            UnLua::FLuaEnv Env2;
+
+            const auto Chunk = TEXT(R"(
+            local Data = require("Tests.Specs.LuaEnv.SharedData")
+            local Count = 0
+            for _ in pairs(Data) do Count = Count + 1 end
+            return type(Data), Data.Name, #Data.List, Data.List[2].Name, Data.ById[1001] == Data.List[2], Count, (pcall(function() Data.Name = "" end))
+            )");
+            for (const auto LuaEnv : {&Env1, &Env2})
+            {
+                LuaEnv->DoString(Chunk);
+                const auto L = LuaEnv->GetMainState();
+                TEST_EQUAL(lua_tostring(L, -7), "userdata");
+                TEST_EQUAL(lua_tostring(L, -6), "Items");
+                TEST_EQUAL(lua_tointeger(L, -5), 2LL);
+                TEST_EQUAL(lua_tostring(L, -4), "Sword");
+                TEST_TRUE(!!lua_toboolean(L, -3));
+                TEST_EQUAL(lua_tointeger(L, -2), 5LL);
+                TEST_FALSE(lua_toboolean(L, -1));
+            }
+        });
+
+        AfterEach([this]
+        {
+            GetMutableDefault<UUnLuaSettings>()->SharedDataModules.Remove(TEXT("Tests.Specs.LuaEnv.SharedData"));
+        });
+    });
+
+    Describe(TEXT("对象删除通知"), [this]()
+    {
+        It(TEXT("压入过Lua的对象删除后从注册表移除"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto L = Env->GetMainState();
+            const auto Stub = NewObject<UUnLuaTestStub>();
+            UnLua::PushUObject(L, Stub);
+            lua_setglobal(L, "Stub");
+
+            const int32 Index = GUObjectArray.ObjectToIndex(Stub);
+            TEST_TRUE(Env->IsObjectTracked(Index));
+            TEST_TRUE(IsInObjectMap(Stub));
+
+#if ENGINE_MAJOR_VERSION >= 5
+            Stub->MarkAsGarbage();
+#else
+            Stub->MarkPendingKill();
+#endif
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+            TEST_FALSE(Env->IsObjectTracked(Index));
+            TEST_FALSE(IsInObjectMap(Stub));
+        });
+
+        It(TEXT("绑定过的类删除后从注册表移除"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto L = Env->GetMainState();
+            const auto Stub = NewObject<UUnLuaTestStub>();
+            UClass* Class = Stub->GetClass();
+            TEST_TRUE(Env->GetManager()->Bind(Stub, TEXT("Tests.Specs.LuaEnv.TrackedStub")));
+
+            const int32 Index = GUObjectArray.ObjectToIndex(Class);
+            TEST_TRUE(Env->IsObjectTracked(Index));
+            TEST_TRUE(Env->GetManager()->GetBoundRef(Class) != LUA_NOREF);
+            TEST_EQUAL(luaL_getmetatable(L, "UUnLuaTestStub"), LUA_TTABLE);
+            lua_pop(L, 1);
+
+            // a native class is never freed, deliver what GUObjectArray sends when a blueprint class goes away
+            Env->NotifyUObjectDeleted(Class, Index);
+            TEST_FALSE(Env->IsObjectTracked(Index));
+            TEST_EQUAL(Env->GetManager()->GetBoundRef(Class), LUA_NOREF);
+            TEST_EQUAL(luaL_getmetatable(L, "UUnLuaTestStub"), LUA_TNIL);
+            lua_pop(L, 1);
+        });
+
+        It(TEXT("Lua没有接触过的对象删除时跳过注册表"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto L = Env->GetMainState();
+            const auto Touched = NewObject<UUnLuaTestStub>();
+            Touched->AddToRoot();
+            UnLua::PushUObject(L, Touched);
+            lua_setglobal(L, "Touched");
+
+            const auto Untouched = NewObject<UUnLuaTestStub>();
+            const int32 Index = GUObjectArray.ObjectToIndex(Untouched);
+            TEST_FALSE(Env->IsObjectTracked(Index));
+            TEST_FALSE(IsInObjectMap(Untouched));
+
+#if ENGINE_MAJOR_VERSION >= 5
+            Untouched->MarkAsGarbage();
+#else
+            Untouched->MarkPendingKill();
+#endif
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+            TEST_FALSE(Env->IsObjectTracked(Index));
+            TEST_TRUE(Env->IsObjectTracked(GUObjectArray.ObjectToIndex(Touched)));
+            TEST_TRUE(IsInObjectMap(Touched));
+            Touched->RemoveFromRoot();
+        });
+    });
+
+    Describe(TEXT("类的绑定决定缓存"), [this]()
+    {
+        BeforeEach([this]
+        {
+            SavedLocatorClass = GetDefault<UUnLuaSettings>()->ModuleLocatorClass;
+            GetMutableDefault<UUnLuaSettings>()->ModuleLocatorClass = UUnLuaTestModuleLocator::StaticClass();
+            Locator = GetMutableDefault<UUnLuaTestModuleLocator>();
+            Locator->ModuleName.Reset();
+            Locator->NumLocates = 0;
+            Locator->bClassBased = true;
+            Env = MakeShared<UnLua::FLuaEnv>();
+        });
+
+        It(TEXT("类删除后缓存的不绑定决定失效"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UClass* Class = UUnLuaTestBindStub::StaticClass();
+            TEST_FALSE(Env->TryBind(NewObject<UUnLuaTestBindStub>()));
+            TEST_FALSE(Env->TryBind(NewObject<UUnLuaTestBindStub>()));
+            TEST_EQUAL(Locator->NumLocates, 1);
+
+            // the cached decision would keep saying no, the class going away has to drop it
+            Locator->ModuleName = TEXT("Tests.Specs.LuaEnv.TrackedStub");
+            Env->NotifyUObjectDeleted(Class, GUObjectArray.ObjectToIndex(Class));
+            TEST_TRUE(Env->TryBind(NewObject<UUnLuaTestBindStub>()));
+            TEST_EQUAL(Locator->NumLocates, 2);
+        });
+
+        It(TEXT("不按类定位模块时每次绑定都询问"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            Locator->bClassBased = false;
+            for (int32 i = 0; i < 3; i++)
+                TEST_FALSE(Env->TryBind(NewObject<UUnLuaTestBindStub>()));
+            TEST_EQUAL(Locator->NumLocates, 3);
+
+            Locator->ModuleName = TEXT("Tests.Specs.LuaEnv.TrackedStub");
+            TEST_TRUE(Env->TryBind(NewObject<UUnLuaTestBindStub>()));
+            TEST_EQUAL(Locator->NumLocates, 4);
+        });
+
+        AfterEach([this]
+        {
+            Env.Reset();
+            GetMutableDefault<UUnLuaSettings>()->ModuleLocatorClass = SavedLocatorClass;
+        });
+    });
+
+    Describe(TEXT("延迟绑定实例"), [this]()
+    {
+        It(TEXT("延迟绑定的实例在Lua首次访问时绑定模块"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto L = Env->GetMainState();
+            const auto Stub = NewObject<UUnLuaTestBindStub>();
+            TEST_TRUE(Env->GetManager()->Bind(Stub, TEXT("Tests.Specs.LuaEnv.LazyStub")));
+            TEST_FALSE(IsInObjectMap(Stub));
+            Env->DoString("return NumInitialized");
+            TEST_TRUE(lua_isnil(L, -1));
+            lua_pop(L, 1);
+
+            UnLua::PushUObject(L, Stub);
+            lua_setglobal(L, "Stub");
+            TEST_TRUE(IsInObjectMap(Stub));
+            Env->DoString("return type(Stub), Stub:GetAnswer(), NumInitialized");
+            TEST_EQUAL(lua_tostring(L, -3), "table");
+            TEST_EQUAL(lua_tointeger(L, -2), 42LL);
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+        });
+
+        It(TEXT("没有开启延迟绑定的类仍然立即绑定"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto L = Env->GetMainState();
+            const auto Stub = NewObject<UUnLuaTestBindStub>();
+            TEST_TRUE(Env->GetManager()->Bind(Stub, TEXT("Tests.Specs.LuaEnv.EagerStub")));
+            TEST_TRUE(IsInObjectMap(Stub));
+            Env->DoString("return NumInitialized");
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+            lua_pop(L, 1);
+
+            UnLua::PushUObject(L, Stub);
+            lua_setglobal(L, "Stub");
+            Env->DoString("return Stub:GetAnswer(), NumInitialized");
+            TEST_EQUAL(lua_tointeger(L, -2), 42LL);
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+        });
+    });
+
+    Describe(TEXT("绑定记录"), [this]()
+    {
+        It(TEXT("对象回收后复用同一索引的新对象调用到自己的实例"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto L = Env->GetMainState();
+            const auto Bind = [this, L](UUnLuaTestBindStub* Stub, const int32 Id)
+            {
+                Env->GetManager()->Bind(Stub, TEXT("Tests.Specs.LuaEnv.RebindStub"));
+                UnLua::PushUObject(L, Stub);
+                lua_pushinteger(L, Id);
+                lua_setfield(L, -2, "Id");
+                lua_pop(L, 1);
+            };
+
+            const auto First = NewObject<UUnLuaTestBindStub>();
+            Bind(First, 1);
+            TEST_EQUAL(First->GetId(), 1);
+
+            const int32 Index = GUObjectArray.ObjectToIndex(First);
+#if ENGINE_MAJOR_VERSION >= 5
+            First->MarkAsGarbage();
+#else
+            First->MarkPendingKill();
+#endif
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+            // freed indices are handed out again, the spares stay unreachable until the next collection
+            UUnLuaTestBindStub* Second = nullptr;
+            for (int32 i = 0; i < 1024 && !Second; i++)
+            {
+                const auto Stub = NewObject<UUnLuaTestBindStub>();
+                if (GUObjectArray.ObjectToIndex(Stub) == Index)
+                    Second = Stub;
+            }
+            TEST_TRUE(Second != nullptr);
+            if (!Second)
+                return;
+
+            Bind(Second, 2);
+            TEST_EQUAL(Second->GetId(), 2);
+        });
+    });
+
     AfterEach([this]
     {
         Env.Reset();
@@ -725,6 +725,45 @@ void FUnLuaLibArraySpec::Define()
             TEST_EQUAL(Result2, 2);
         });
     });
+
+    Describe(TEXT("基础类型元素"), [this]
+    {
+        It(TEXT("读写整数、浮点数和布尔值"), EAsyncExecution::TaskGraphMainThread, [this]
+        {
+            const auto Chunk = R"(
+            local Ints = UE.TArray(0)
+            local Floats = UE.TArray(0.5)
+            local Bools = UE.TArray(true)
+            Ints:Add(-1)
+            Ints:Set(1, -2147483648)
+            Floats:Add(1.5)
+            Bools:Add(false)
+            Bools:Set(1, true)
+            local Sum = 0
+            for _, v in pairs(Ints) do Sum = Sum + v end
+            return Ints:Get(1), Sum, Floats[1], Bools:Get(1)
+            )";
+            TEST_TRUE(Env->DoString(Chunk));
+            TEST_EQUAL(lua_tointeger(L, -4), -2147483648LL);
+            TEST_EQUAL(lua_tointeger(L, -3), -2147483648LL);
+            TEST_EQUAL(lua_tonumber(L, -2), 1.5);
+            TEST_TRUE(!!lua_toboolean(L, -1));
+        });
+
+        It(TEXT("读写对象"), EAsyncExecution::TaskGraphMainThread, [this]
+        {
+            const auto Chunk = R"(
+            local Array = UE.TArray(UE.UUnLuaTestStub)
+            local Stub = NewObject(UE.UUnLuaTestStub)
+            Array:Add(nil)
+            Array:Set(1, Stub)
+            return Array:Get(1) == Stub, Array:Find(Stub)
+            )";
+            TEST_TRUE(Env->DoString(Chunk));
+            TEST_TRUE(!!lua_toboolean(L, -2));
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+        });
+    });
 }
 
 #endif
@@ -16,6 +16,7 @@
 #include "UnLuaTemplate.h"
 #include "Misc/AutomationTest.h"
 #include "UnLuaTestHelpers.h"
+#include "Engine/DataTable.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
 
@@ -59,6 +60,95 @@ void FUnLuaLibDataTableSpec::Define()
         });
     });
 
+    Describe(TEXT("FindRow"), [this]()
+    {
+        It(TEXT("行引用直接读取表中的数据"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Chunk = R"(
+            local DataTable = UE.UObject.Load('/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest')
+            local Row = DataTable:FindRow('Row_1')
+            return Row.Title, Row == DataTable:FindRow('Row_1'), DataTable:FindRow('Missing')
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tostring(L, -3), "Hello");
+            TEST_TRUE(!!lua_toboolean(L, -2));
+            TEST_TRUE(lua_isnil(L, -1));
+        });
+
+        It(TEXT("行引用只读"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            AddExpectedError(TEXT("read-only"));
+            UnLua::RunChunk(L, "UE.UObject.Load('/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest'):FindRow('Row_1').Title = 'A'");
+        });
+
+        It(TEXT("表变化后行引用失效"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto DataTable = LoadObject<UDataTable>(nullptr, TEXT("/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest"));
+            UnLua::PushUObject(L, DataTable);
+            lua_setglobal(L, "DataTable");
+            UnLua::RunChunk(L, "Row = DataTable:FindRow('Row_1')");
+            DataTable->OnDataTableChanged().Broadcast();
+            AddExpectedError(TEXT("changed or unloaded data table"));
+            UnLua::RunChunk(L, "return Row.Title");
+            UnLua::RunChunk(L, "return DataTable:FindRow('Row_1').Title");
+            TEST_EQUAL(lua_tostring(L, -1), "Hello");
+        });
+    });
+
+    Describe(TEXT("Rows"), [this]()
+    {
+        It(TEXT("遍历所有行的引用"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Chunk = R"(
+            local DataTable = UE.UObject.Load('/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest')
+            local Count, Found = 0, false
+            for Name, Row in DataTable:Rows() do
+                Count = Count + 1
+                Found = Found or (Name == 'Row_1' and Row == DataTable:FindRow(Name))
+            end
+            return Count, Found
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_tointeger(L, -2) > 0);
+            TEST_TRUE(!!lua_toboolean(L, -1));
+        });
+    });
+
+    Describe(TEXT("Column"), [this]()
+    {
+        It(TEXT("按列名取出所有行的值"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Chunk = R"(
+            local DataTable = UE.UObject.Load('/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest')
+            local Titles = DataTable:Column('Title')
+            return Titles.Row_1, Titles == DataTable:Column('Title')
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tostring(L, -2), "Hello");
+            TEST_TRUE(!!lua_toboolean(L, -1));
+        });
+
+        It(TEXT("先通过行引用读取过的列"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Chunk = R"(
+            local DataTable = UE.UObject.Load('/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest')
+            local Row = DataTable:FindRow('Row_1')
+            local Title = Row.Title
+            return DataTable:Column('Title').Row_1, Title, Row.Title
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tostring(L, -3), "Hello");
+            TEST_EQUAL(lua_tostring(L, -2), "Hello");
+            TEST_EQUAL(lua_tostring(L, -1), "Hello");
+        });
+
+        It(TEXT("列不存在时报错"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            AddExpectedError(TEXT("can't find column"));
+            UnLua::RunChunk(L, "UE.UObject.Load('/UnLuaTestSuite/Tests/Misc/DataTable_CppTest.DataTable_CppTest'):Column('Missing')");
+        });
+    });
+
     AfterEach([this]
     {
         UnLua::Shutdown();
@@ -0,0 +1,157 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "UnLuaBase.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "UnLuaTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FUnLuaLibFileSpec, "UnLua.API.File", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+    FString FilePath;
+    FString AsyncDir;
+
+    void RunChunk(const FString& Open, const char* Body)
+    {
+        const auto Chunk = FString::Printf(TEXT("local File = UE.File()\nassert(File:%s(\"%s\"%s))\nFile:SetBufferSize(64)\n%s"),
+                                           *Open, *FilePath, Open == TEXT("Open") ? TEXT(", \"rb\"") : TEXT(""), UTF8_TO_TCHAR(Body));
+        UnLua::RunChunk(L, TCHAR_TO_UTF8(*Chunk));
+    }
+
+    FDoneDelegate AsyncDone;
+
+    static int OnAsyncDone(lua_State* L)
+    {
+        auto Spec = (FUnLuaLibFileSpec*)lua_touserdata(L, lua_upvalueindex(1));
+        Spec->TestEqual(TEXT("Count"), (int32)lua_tointeger(L, 1), 100);
+        Spec->TestEqual(TEXT("Bytes"), (int32)lua_tointeger(L, 2), 5050);
+        Spec->AsyncDone.Execute();
+        return 0;
+    }
+END_DEFINE_SPEC(FUnLuaLibFileSpec)
+
+void FUnLuaLibFileSpec::Define()
+{
+    BeforeEach([this]
+    {
+        UnLua::Startup();
+        L = UnLua::GetState();
+
+        // one line longer than the 64 bytes read buffer
+        FilePath = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("Automation/LuaLib_File.txt"));
+        FilePath.ReplaceInline(TEXT("\\"), TEXT("/"));
+        AsyncDir = FPaths::GetPath(FilePath) / TEXT("LuaLib_File_Async");
+        const FString Content = FString(TEXT("first\n")) + FString::ChrN(100, TEXT('x')) + TEXT("\n\nlast");
+        FFileHelper::SaveStringToFile(Content, *FilePath);
+    });
+
+    for (const auto Open : {TEXT("Open"), TEXT("OpenMapped")})
+    {
+        Describe(Open, [this, Open]()
+        {
+            It(TEXT("按行读取"), EAsyncExecution::TaskGraphMainThread, [this, Open]()
+            {
+                RunChunk(Open, "return File:Read('l'), #File:Read('l'), File:Read('L'), File:Read('l'), File:Read('l')");
+                TEST_EQUAL(lua_tostring(L, -5), "first");
+                TEST_EQUAL(lua_tointeger(L, -4), 100LL);
+                TEST_EQUAL(lua_tostring(L, -3), "\n");
+                TEST_EQUAL(lua_tostring(L, -2), "last");
+                TEST_TRUE(lua_isnil(L, -1));
+            });
+
+            It(TEXT("Lines遍历所有行"), EAsyncExecution::TaskGraphMainThread, [this, Open]()
+            {
+                RunChunk(Open, "local Count = 0 for Line in File:Lines() do Count = Count + #Line end return Count");
+                TEST_EQUAL(lua_tointeger(L, -1), 109LL);
+            });
+
+            It(TEXT("按字节数和全部读取"), EAsyncExecution::TaskGraphMainThread, [this, Open]()
+            {
+                RunChunk(Open, "return File:Read(3), File:Read('l'), #File:Read('a'), File:Read('a'), File:Read(1)");
+                TEST_EQUAL(lua_tostring(L, -5), "fir");
+                TEST_EQUAL(lua_tostring(L, -4), "st");
+                TEST_EQUAL(lua_tointeger(L, -3), 106LL);
+                TEST_EQUAL(lua_tostring(L, -2), "");
+                TEST_TRUE(lua_isnil(L, -1));
+            });
+
+            It(TEXT("Seek之后读取"), EAsyncExecution::TaskGraphMainThread, [this, Open]()
+            {
+                RunChunk(Open, "File:Read('l') File:Seek('cur', 98) local A = File:Read('l') File:Seek('end', 4) return A, File:Read('a')");
+                TEST_EQUAL(lua_tostring(L, -2), "xx");
+                TEST_EQUAL(lua_tostring(L, -1), "last");
+            });
+        });
+    }
+
+    Describe(TEXT("ReadAsync"), [this]()
+    {
+        LatentIt(TEXT("并发读取100个文件"), FTimespan::FromSeconds(10), EAsyncExecution::TaskGraphMainThread, [this](const FDoneDelegate& Done)
+        {
+            AsyncDone = Done;
+            for (int32 i = 1; i <= 100; i++)
+                FFileHelper::SaveStringToFile(FString::ChrN(i, TEXT('x')), *FString::Printf(TEXT("%s/%d.txt"), *AsyncDir, i));
+            lua_pushlightuserdata(L, this);
+            lua_pushcclosure(L, OnAsyncDone, 1);
+            lua_setglobal(L, "OnAsyncDone");
+
+            const auto Chunk = FString::Printf(TEXT(R"(
+                local Requests = {}
+                for i = 1, 100 do
+                    Requests[i] = UE.File.ReadAsync(string.format("%s/%%d.txt", i))
+                end
+                local Count, Bytes = 0, 0
+                for i = 1, 100 do
+                    coroutine.wrap(function()
+                        local Data = assert(Requests[i]:Await())
+                        Count = Count + 1
+                        Bytes = Bytes + #Data
+                        if Count == 100 then
+                            OnAsyncDone(Count, Bytes)
+                        end
+                    end)()
+                end
+            )"), *AsyncDir);
+            UnLua::RunChunk(L, TCHAR_TO_UTF8(*Chunk));
+        });
+
+        It(TEXT("取消之后返回cancelled"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Chunk = FString::Printf(TEXT(R"(
+                local Request = UE.File.ReadAsync("%s")
+                local Result = {}
+                coroutine.wrap(function() Result = { Request:Await() } end)()
+                Request:Cancel()
+                return Request:IsDone(), Result[1], Result[2]
+            )"), *FilePath);
+            UnLua::RunChunk(L, TCHAR_TO_UTF8(*Chunk));
+            TEST_TRUE(!!lua_toboolean(L, -3));
+            TEST_TRUE(lua_isnil(L, -2));
+            TEST_EQUAL(lua_tostring(L, -1), "cancelled");
+        });
+    });
+
+    AfterEach([this]
+    {
+        UnLua::Shutdown();
+        IFileManager::Get().Delete(*FilePath);
+        IFileManager::Get().DeleteDirectory(*AsyncDir, false, true);
+    });
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,265 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "UnLuaBase.h"
+#include "UnLuaTestHelpers.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FLuaSocketSpec, "UnLua.Extensions.LuaSocket", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+
+    void Start()
+    {
+        UnLua::Startup();
+        L = UnLua::GetState();
+        const char* Chunk = R"(
+        local socket = require("socket")
+        local Server = assert(socket.bind("127.0.0.1", 0))
+        local _, Port = Server:getsockname()
+        Client = assert(socket.connect("127.0.0.1", Port))
+        Peer = assert(Server:accept())
+        Peer:settimeout(1)
+        Server:close()
+        )";
+        UnLua::RunChunk(L, Chunk);
+    }
+
+    FDoneDelegate AsyncDone;
+
+    static int OnAsyncDone(lua_State* L)
+    {
+        auto Spec = (FLuaSocketSpec*)lua_touserdata(L, lua_upvalueindex(1));
+        Spec->TestEqual(TEXT("Sent"), (int32)lua_tointeger(L, 1), 5);
+        Spec->TestEqual(TEXT("Echo"), FString(UTF8_TO_TCHAR(lua_tostring(L, 2))), TEXT("ping"));
+        Spec->TestEqual(TEXT("Line"), FString(UTF8_TO_TCHAR(lua_tostring(L, 3))), TEXT("hello"));
+        Spec->TestEqual(TEXT("Line with CR"), FString(UTF8_TO_TCHAR(lua_tostring(L, 4))), TEXT("world"));
+        Spec->TestEqual(TEXT("Size"), FString(UTF8_TO_TCHAR(lua_tostring(L, 5))), TEXT("end"));
+        Spec->AsyncDone.Execute();
+        return 0;
+    }
+
+    /** Connect, send and receive through socket.async, OnAsyncDone checks the results once the coroutine gets them */
+    void StartRoundTrip(const FDoneDelegate& Done)
+    {
+        AsyncDone = Done;
+        lua_pushlightuserdata(L, this);
+        lua_pushcclosure(L, OnAsyncDone, 1);
+        lua_setglobal(L, "OnAsyncDone");
+
+        const char* Chunk = R"(
+        local socket = require("socket")
+        local async = require("socket.async")
+        local Server = assert(socket.bind("127.0.0.1", 0))
+        local _, Port = Server:getsockname()
+        coroutine.wrap(function()
+            local Conn = assert(async.connect("127.0.0.1", Port, 5))
+            local Sent = Conn:send("ping\n", 5)
+            local Echo = AsyncPeer:receive()
+            local Line, WithCR, Size = Conn:receive("*l", 5), Conn:receive("*l", 5), Conn:receive(3, 5)
+            Conn:close()
+            OnAsyncDone(Sent, Echo, Line, WithCR, Size)
+        end)()
+        -- the worker thread connects while this blocks
+        Server:settimeout(5)
+        AsyncPeer = assert(Server:accept())
+        AsyncPeer:settimeout(5)
+        Server:close()
+        AsyncPeer:send("hello\r\nwor\rld\r\nend")
+        )";
+        UnLua::RunChunk(L, Chunk);
+    }
+END_DEFINE_SPEC(FLuaSocketSpec)
+
+void FLuaSocketSpec::Define()
+{
+    BeforeEach([this]
+    {
+        Start();
+    });
+
+    Describe(TEXT("receiveslice"), [this]()
+    {
+        It(TEXT("按行和按长度接收"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            Client:send("hello\r\nworld")
+            local Line = Peer:receiveslice()
+            local Word = Peer:receiveslice(5)
+            return Line:tostring(), Word:tostring()
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tostring(L, -2), "hello");
+            TEST_EQUAL(lua_tostring(L, -1), "world");
+        });
+
+        It(TEXT("支持字符串和slice作为前缀"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            Client:send("defghi")
+            local First = Peer:receiveslice(6, "abc")
+            local Second = Peer:receiveslice(6, First:sub(4, 6))
+            return First:tostring(), Second:tostring()
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tostring(L, -2), "abcdef");
+            TEST_EQUAL(lua_tostring(L, -1), "defghi");
+        });
+
+        It(TEXT("超时返回部分数据的slice"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            Peer:settimeout(0.1)
+            Client:send("xy")
+            local Slice, Err, Partial = Peer:receiveslice(4, "w")
+            return Slice, Err, Partial:tostring()
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_isnil(L, -3));
+            TEST_EQUAL(lua_tostring(L, -2), "timeout");
+            TEST_EQUAL(lua_tostring(L, -1), "wxy");
+        });
+    });
+
+    Describe(TEXT("poller"), [this]()
+    {
+        It(TEXT("注册、修改和移除socket"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            local socket = require("socket")
+            local Poller = socket.poller()
+            assert(Poller:add(Peer, "r"))
+            local _, Duplicated = Poller:add(Peer, "r")
+            local Idle = Poller:wait(0)
+            Client:send("x")
+            local Readable, Ready, Revents = Poller:wait(1)
+            assert(Ready[1] == Peer and Revents[1] == socket.POLLREAD)
+            Peer:receive(1)
+            assert(Poller:modify(Peer, "w"))
+            local Writable, _, WriteRevents = Poller:wait(1)
+            assert(WriteRevents[1] == socket.POLLWRITE)
+            assert(Poller:remove(Peer))
+            local _, Removed = Poller:remove(Peer)
+            return Duplicated, Idle, Readable, Writable, Poller:count(), Removed
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tostring(L, -6), "already registered");
+            TEST_EQUAL(lua_tointeger(L, -5), 0LL);
+            TEST_EQUAL(lua_tointeger(L, -4), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -3), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 0LL);
+            TEST_EQUAL(lua_tostring(L, -1), "not registered");
+        });
+
+        It(TEXT("水平触发重复报告，边沿触发只报告一次"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            local socket = require("socket")
+            local Poller = socket.poller()
+            Poller:add(Peer, "r", nil, "level")
+            Client:send("y")
+            local Level1, Level2 = Poller:wait(1), Poller:wait(0.1)
+            Poller:modify(Peer, "r", "edge")
+            local Edge1, Edge2 = Poller:wait(1), Poller:wait(0.1)
+            return Level1, Level2, Edge1, Edge2
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -4), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -3), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 1LL);
+#if PLATFORM_LINUX
+            TEST_EQUAL(lua_tointeger(L, -1), 0LL);
+#else
+            // only epoll honours edge triggering, poll() keeps reporting
+            TEST_EQUAL(lua_tointeger(L, -1), 1LL);
+#endif
+        });
+
+        It(TEXT("移除在就绪队列里的socket后不再回调"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            local socket = require("socket")
+            local Poller = socket.poller()
+            local Pairs, Calls = {}, {}
+            for i = 1, 3 do
+                local Server = assert(socket.bind("127.0.0.1", 0))
+                local _, Port = Server:getsockname()
+                local Sender = assert(socket.connect("127.0.0.1", Port))
+                local Receiver = assert(Server:accept())
+                Server:close()
+                Pairs[i] = { Sender, Receiver }
+                Poller:add(Receiver, "r", function()
+                    Calls[#Calls + 1] = i
+                    if i == 1 then Poller:remove(Pairs[2][2]) end
+                end)
+                Sender:send("z")
+            end
+            socket.sleep(0.1)
+            local First, Queued = Poller:dispatch(0)
+            local Second, Left = Poller:dispatch()
+            for _, Pair in ipairs(Pairs) do
+                Pair[1]:close()
+                Pair[2]:close()
+            end
+            return First, Queued, Second, Left, #Calls, Poller:count()
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -6), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -5), 2LL);
+            TEST_EQUAL(lua_tointeger(L, -4), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -3), 0LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 2LL);
+            TEST_EQUAL(lua_tointeger(L, -1), 2LL);
+        });
+    });
+
+    Describe(TEXT("socket.async"), [this]()
+    {
+        LatentIt(TEXT("通过后台线程连接、发送和接收"), FTimespan::FromSeconds(10), EAsyncExecution::TaskGraphMainThread, [this](const FDoneDelegate& Done)
+        {
+            StartRoundTrip(Done);
+        });
+
+        LatentIt(TEXT("环境关闭时丢弃未完成的请求"), FTimespan::FromSeconds(10), EAsyncExecution::TaskGraphMainThread, [this](const FDoneDelegate& Done)
+        {
+            const char* Chunk = R"(
+            local socket = require("socket")
+            local async = require("socket.async")
+            PendingServer = assert(socket.bind("127.0.0.1", 0))
+            local _, Port = PendingServer:getsockname()
+            coroutine.wrap(function()
+                local Conn = async.connect("127.0.0.1", Port)
+                Conn:receive("*l")
+                error("resumed after the env was closed")
+            end)()
+            )";
+            UnLua::RunChunk(L, Chunk);
+
+            // the connect is still in flight, its completion has to be dropped instead of resuming a dead coroutine
+            UnLua::RunChunk(L, "Client:close() Peer:close()");
+            UnLua::Shutdown();
+            Start();
+            StartRoundTrip(Done);
+        });
+    });
+
+    AfterEach([this]
+    {
+        UnLua::RunChunk(L, "Client:close() Peer:close()");
+        UnLua::Shutdown();
+    });
+}
+
+#endif
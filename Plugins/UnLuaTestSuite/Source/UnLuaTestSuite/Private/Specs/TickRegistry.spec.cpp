@@ -0,0 +1,149 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+//
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License");
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "UnLuaBase.h"
+#include "LuaEnv.h"
+#include "Engine.h"
+#include "UnLuaTestHelpers.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FTickRegistrySpec, "UnLua.API.BatchTick", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+    UWorld* World;
+
+    void Tick(const int32 NumFrames, const float DeltaSeconds)
+    {
+        const auto TickRegistry = UnLua::FLuaEnv::FindEnvChecked(L).GetTickRegistry();
+        for (int32 i = 0; i < NumFrames; i++)
+            TickRegistry->Tick(World, TG_PrePhysics, DeltaSeconds);
+    }
+
+    int64 GetTickCount()
+    {
+        UnLua::RunChunk(L, "return TickCount or 0");
+        const int64 Count = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+        return Count;
+    }
+
+    int32 GetNumInstances()
+    {
+        TArray<UnLua::FTickRegistry::FModuleStats> Stats;
+        UnLua::FLuaEnv::FindEnvChecked(L).GetTickRegistry()->GetStats(Stats);
+        int32 NumInstances = 0;
+        for (const auto& ModuleStats : Stats)
+            NumInstances += ModuleStats.NumInstances;
+        return NumInstances;
+    }
+END_DEFINE_SPEC(FTickRegistrySpec)
+
+void FTickRegistrySpec::Define()
+{
+    BeforeEach([this]
+    {
+        UnLua::Startup();
+        L = UnLua::GetState();
+
+        World = UWorld::CreateWorld(EWorldType::Game, false, "UnLuaTest");
+        FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+        WorldContext.SetCurrentWorld(World);
+
+        const FURL URL;
+        World->InitializeActorsForPlay(URL);
+        World->BeginPlay();
+    });
+
+    Describe(TEXT("__TickGroup"), [this]()
+    {
+        It(TEXT("每帧对所有实例调用BatchTick"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            for (int32 i = 0; i < 3; i++)
+                World->SpawnActor<AUnLuaTestBatchTickActor>();
+
+            Tick(2, 0.1f);
+            TEST_EQUAL(GetTickCount(), 6LL);
+            TEST_EQUAL(GetNumInstances(), 3);
+        });
+
+        It(TEXT("按__TickInterval间隔调用并传入累计的DeltaSeconds"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            World->SpawnActor<AUnLuaTestIntervalTickActor>();
+
+            Tick(2, 0.1f);
+            TEST_EQUAL(GetTickCount(), 0LL);
+
+            Tick(7, 0.1f);
+            TEST_EQUAL(GetTickCount(), 3LL);
+
+            UnLua::RunChunk(L, "return LastDeltaSeconds");
+            TEST_TRUE(FMath::IsNearlyEqual((float)lua_tonumber(L, -1), 0.3f, KINDA_SMALL_NUMBER));
+        });
+
+        It(TEXT("BatchTick里销毁的实例之后不再Tick"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            TArray<AActor*> Actors;
+            for (int32 i = 0; i < 3; i++)
+                Actors.Add(World->SpawnActor<AUnLuaTestBatchTickActor>());
+
+            // destroying the one in the middle moves the last one into its slot
+            UnLua::PushUObject(L, Actors[1]);
+            lua_setglobal(L, "Victim");
+            Tick(1, 0.1f);
+            TEST_EQUAL(GetTickCount(), 3LL);
+
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+            TEST_EQUAL(GetNumInstances(), 2);
+
+            Tick(2, 0.1f);
+            TEST_EQUAL(GetTickCount(), 7LL);
+        });
+
+        It(TEXT("世界清理时移除登记的实例"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            for (int32 i = 0; i < 2; i++)
+                World->SpawnActor<AUnLuaTestBatchTickActor>();
+
+            Tick(1, 0.1f);
+            TEST_EQUAL(GetTickCount(), 2LL);
+
+            FWorldDelegates::OnWorldCleanup.Broadcast(World, true, true);
+            TEST_EQUAL(GetNumInstances(), 0);
+
+            Tick(1, 0.1f);
+            TEST_EQUAL(GetTickCount(), 2LL);
+        });
+
+        It(TEXT("延迟绑定的模块在Lua访问实例前也会Tick"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            // never pushed to lua, so a lazily bound instance would not exist yet
+            for (int32 i = 0; i < 2; i++)
+                World->SpawnActor<AUnLuaTestLazyTickActor>();
+
+            Tick(1, 0.1f);
+            TEST_EQUAL(GetTickCount(), 2LL);
+            TEST_EQUAL(GetNumInstances(), 2);
+        });
+    });
+
+    AfterEach([this]
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+        UnLua::Shutdown();
+    });
+}
+
+#endif
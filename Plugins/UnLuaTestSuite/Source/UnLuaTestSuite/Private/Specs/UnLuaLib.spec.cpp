@@ -0,0 +1,294 @@
+// Tencent is pleased to support the open source community by making UnLua available.
+// 
+// Copyright (C) 2019 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); 
+// you may not use this file except in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, 
+// software distributed under the License is distributed on an "AS IS" BASIS, 
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. 
+// See the License for the specific language governing permissions and limitations under the License.
+
+#include "UnLuaBase.h"
+#include "LuaEnv.h"
+#include "UnLuaTestHelpers.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FUnLuaLibSpec, "UnLua.API.UnLua", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::ApplicationContextMask)
+    lua_State* L;
+
+    void Tick(const int32 NumFrames, const float DeltaSeconds)
+    {
+        const auto Scheduler = UnLua::FLuaEnv::FindEnvChecked(L).GetCoroutineScheduler();
+        for (int32 i = 0; i < NumFrames; i++)
+            Scheduler->Tick(DeltaSeconds);
+    }
+
+    void TickWatchers()
+    {
+        UnLua::FLuaEnv::FindEnvChecked(L).GetPropertyWatcher()->Tick();
+    }
+END_DEFINE_SPEC(FUnLuaLibSpec)
+
+void FUnLuaLibSpec::Define()
+{
+    BeforeEach([this]
+    {
+        UnLua::Startup();
+        L = UnLua::GetState();
+    });
+
+    Describe(TEXT("Recycle"), [this]()
+    {
+        It(TEXT("回收后实例table恢复为模块默认值"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            local Stub = NewObject(UE.UUnLuaTestStub, nil, nil, "Tests.Specs.UnLuaLib.RecycleTestStub", { Count = 3 })
+            Stub.Temp = {}
+            local Object = rawget(Stub, "Object")
+            local Ok = UnLua.Recycle(Stub)
+            return Ok, RecycledCount, Stub.Count, Stub.Temp, rawget(Stub, "Object") == Object
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(!!lua_toboolean(L, -5));
+            TEST_EQUAL(lua_tointeger(L, -4), 3LL);
+            TEST_EQUAL(lua_tointeger(L, -3), 0LL);
+            TEST_TRUE(lua_isnil(L, -2));
+            TEST_TRUE(!!lua_toboolean(L, -1));
+        });
+
+        It(TEXT("未绑定的对象返回false"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UnLua::RunChunk(L, "return UnLua.Recycle(NewObject(UE.UUnLuaTestStub))");
+            TEST_FALSE(lua_toboolean(L, -1));
+        });
+    });
+
+    Describe(TEXT("Reuse"), [this]()
+    {
+        It(TEXT("复用时调用Initialize和OnReuse"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            local Stub = NewObject(UE.UUnLuaTestStub, nil, nil, "Tests.Specs.UnLuaLib.RecycleTestStub")
+            UnLua.Recycle(Stub)
+            local Ok = UnLua.Reuse(Stub, { Count = 5 })
+            return Ok, Stub.Count, Stub.Reused
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(!!lua_toboolean(L, -3));
+            TEST_EQUAL(lua_tointeger(L, -2), 5LL);
+            TEST_TRUE(!!lua_toboolean(L, -1));
+        });
+    });
+
+    Describe(TEXT("Sleep"), [this]()
+    {
+        It(TEXT("到时间后恢复协程"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UnLua::RunChunk(L, "Woken = {} for i = 1, 3 do coroutine.wrap(function() Woken[i] = UnLua.Sleep(i * 0.1) end)() end");
+            Tick(9, 0.025f);
+            UnLua::RunChunk(L, "return Woken[1], Woken[2], Woken[3]");
+            TEST_TRUE(!!lua_toboolean(L, -3));
+            TEST_TRUE(!!lua_toboolean(L, -2));
+            TEST_TRUE(lua_isnil(L, -1));
+        });
+
+        It(TEXT("Owner销毁后不再恢复"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Owner = NewObject<UUnLuaTestStub>();
+            UnLua::PushUObject(L, Owner);
+            lua_setglobal(L, "Owner");
+            UnLua::RunChunk(L, "coroutine.wrap(function() UnLua.Sleep(0.1, Owner) Woken = true end)()");
+#if ENGINE_MAJOR_VERSION >= 5
+            Owner->MarkAsGarbage();
+#else
+            Owner->MarkPendingKill();
+#endif
+            Tick(10, 0.1f);
+            UnLua::RunChunk(L, "return Woken");
+            TEST_TRUE(lua_isnil(L, -1));
+            TEST_EQUAL(UnLua::FLuaEnv::FindEnvChecked(L).GetCoroutineScheduler()->GetNumWaiting(), 0);
+        });
+
+        It(TEXT("协程外调用报错"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            AddExpectedError(TEXT("can only wait in a coroutine"));
+            UnLua::RunChunk(L, "UnLua.Sleep(1)");
+        });
+    });
+
+    Describe(TEXT("WaitFrames"), [this]()
+    {
+        It(TEXT("等待指定帧数"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UnLua::RunChunk(L, "Frames = 0 coroutine.wrap(function() for i = 1, 3 do UnLua.WaitFrames(2) Frames = Frames + 1 end end)()");
+            Tick(5, 0);
+            UnLua::RunChunk(L, "return Frames");
+            TEST_EQUAL(lua_tointeger(L, -1), 2LL);
+        });
+
+        // due exactly when an outer level of the time wheel cascades
+        for (const int32 NumFrames : {64, 4096})
+        {
+            It(FString::Printf(TEXT("等待%d帧在第%d帧恢复"), NumFrames, NumFrames), EAsyncExecution::TaskGraphMainThread, [this, NumFrames]()
+            {
+                UnLua::RunChunk(L, TCHAR_TO_UTF8(*FString::Printf(TEXT("Done = false coroutine.wrap(function() UnLua.WaitFrames(%d) Done = true end)()"), NumFrames)));
+                Tick(NumFrames - 1, 0);
+                UnLua::RunChunk(L, "return Done");
+                TEST_FALSE(!!lua_toboolean(L, -1));
+                Tick(1, 0);
+                UnLua::RunChunk(L, "return Done");
+                TEST_TRUE(!!lua_toboolean(L, -1));
+            });
+        }
+    });
+
+    Describe(TEXT("WaitEvent"), [this]()
+    {
+        It(TEXT("Signal的参数在下一帧传给协程"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            Results = {}
+            for i = 1, 2 do
+                coroutine.wrap(function() Results[i] = { UnLua.WaitEvent("Hit") } end)()
+            end
+            return UnLua.Signal("Hit", 10, nil, "A"), UnLua.Signal("Hit"), #Results
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_EQUAL(lua_tointeger(L, -3), 2LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 0LL);
+            TEST_EQUAL(lua_tointeger(L, -1), 0LL);
+            Tick(1, 0);
+            UnLua::RunChunk(L, "return Results[2][1], Results[2][2], Results[2][3]");
+            TEST_EQUAL(lua_tointeger(L, -3), 10LL);
+            TEST_TRUE(lua_isnil(L, -2));
+            TEST_EQUAL(lua_tostring(L, -1), "A");
+        });
+
+        It(TEXT("Cancel之后不再恢复"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            local Co = coroutine.create(function() UnLua.WaitEvent("Hit") Woken = true end)
+            coroutine.resume(Co)
+            return UnLua.Cancel(Co), UnLua.Signal("Hit"), UnLua.Cancel(Co)
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(!!lua_toboolean(L, -3));
+            TEST_EQUAL(lua_tointeger(L, -2), 0LL);
+            TEST_FALSE(lua_toboolean(L, -1));
+        });
+    });
+
+    Describe(TEXT("Spawn"), [this]()
+    {
+        It(TEXT("函数返回后协程回到池里复用"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            local Threads = {}
+            local First = UnLua.Spawn(function(A, B) Threads[1] = coroutine.running() Sum = A + B end, 1, 2)
+            UnLua.Spawn(function() Threads[2] = coroutine.running() end)
+            return First, Sum, Threads[1] == Threads[2]
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(lua_isnil(L, -3));
+            TEST_EQUAL(lua_tointeger(L, -2), 3LL);
+            TEST_TRUE(!!lua_toboolean(L, -1));
+            TEST_TRUE(UnLua::FLuaEnv::FindEnvChecked(L).GetCoroutinePool()->GetNumHits() > 0);
+        });
+
+        It(TEXT("挂起的协程恢复结束后回到池里"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            UnLua::RunChunk(L, "Co = UnLua.Spawn(function() UnLua.WaitFrames(1) end) return Co");
+            TEST_TRUE(lua_isthread(L, -1));
+            const auto Pool = UnLua::FLuaEnv::FindEnvChecked(L).GetCoroutinePool();
+            const auto NumFree = Pool->GetNumFree();
+            Tick(1, 0);
+            TEST_EQUAL(Pool->GetNumFree(), NumFree + 1);
+        });
+
+        It(TEXT("出错的协程重置后复用"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            AddExpectedError(TEXT("spawn error"));
+            UnLua::RunChunk(L, "UnLua.Spawn(function() error('spawn error') end) return UnLua.Spawn(function() coroutine.yield() end)");
+            TEST_TRUE(lua_isthread(L, -1));
+            TEST_TRUE(UnLua::FLuaEnv::FindEnvChecked(L).GetCoroutinePool()->GetNumHits() > 0);
+        });
+    });
+
+    Describe(TEXT("Watch"), [this]()
+    {
+        It(TEXT("属性变化后下一帧回调新值"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            Stub = NewObject(UE.UUnLuaTestStub)
+            Values = {}
+            UnLua.Watch(Stub, "Counter", function(Object, Value) Values[#Values + 1] = Object == Stub and Value end)
+            UnLua.Watch(Stub, "MapForIssue407", function(Object, Value) MapLength = Value:Length() end)
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TickWatchers();
+            UnLua::RunChunk(L, "Stub:AddCount() Stub.MapForIssue407:Add(3, 3)");
+            TickWatchers();
+            TickWatchers();
+            UnLua::RunChunk(L, "return #Values, Values[1], MapLength");
+            TEST_EQUAL(lua_tointeger(L, -3), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -2), 1LL);
+            TEST_EQUAL(lua_tointeger(L, -1), 3LL);
+        });
+
+        It(TEXT("Unwatch之后不再回调"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const char* Chunk = R"(
+            Stub = NewObject(UE.UUnLuaTestStub)
+            local Id = UnLua.Watch(Stub, "Counter", function() Called = true end)
+            Stub:AddCount()
+            return UnLua.Unwatch(Id), UnLua.Unwatch(Id)
+            )";
+            UnLua::RunChunk(L, Chunk);
+            TEST_TRUE(!!lua_toboolean(L, -2));
+            TEST_FALSE(lua_toboolean(L, -1));
+            TickWatchers();
+            UnLua::RunChunk(L, "return Called");
+            TEST_TRUE(lua_isnil(L, -1));
+        });
+
+        It(TEXT("对象销毁后移除监听"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            const auto Stub = NewObject<UUnLuaTestStub>();
+            UnLua::PushUObject(L, Stub);
+            lua_setglobal(L, "Stub");
+            UnLua::RunChunk(L, "UnLua.Watch(Stub, 'Counter', function() Called = true end)");
+            const auto Watcher = UnLua::FLuaEnv::FindEnvChecked(L).GetPropertyWatcher();
+            TEST_EQUAL(Watcher->GetNumWatches(), 1);
+            Stub->Counter++;
+#if ENGINE_MAJOR_VERSION >= 5
+            Stub->MarkAsGarbage();
+#else
+            Stub->MarkPendingKill();
+#endif
+            TickWatchers();
+            UnLua::RunChunk(L, "return Called");
+            TEST_TRUE(lua_isnil(L, -1));
+            Watcher->NotifyUObjectDeleted(Stub);
+            TEST_EQUAL(Watcher->GetNumWatches(), 0);
+        });
+
+        It(TEXT("属性不存在时报错"), EAsyncExecution::TaskGraphMainThread, [this]()
+        {
+            AddExpectedError(TEXT("can't find property"));
+            UnLua::RunChunk(L, "UnLua.Watch(NewObject(UE.UUnLuaTestStub), 'Missing', print)");
+        });
+    });
+
+    AfterEach([this]
+    {
+        UnLua::Shutdown();
+    });
+}
+
+#endif
@@ -36,7 +36,60 @@ public:
     UFUNCTION(BlueprintCallable)
     static void Stop();
 
+    /** Add a measured value (memory, counts...) next to the timings */
+    UFUNCTION(BlueprintCallable)
+    static void Record(const FString& Title, const float Value);
+
+    /** Spawn actors from C++, lua only sees them when it reads OutActors */
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+    static void SpawnActors(UObject* WorldContextObject, TSubclassOf<AActor> Class, const int32 N, TArray<AActor*>& OutActors);
+
+    UFUNCTION(BlueprintCallable)
+    static void DestroyActors(const TArray<AActor*>& Actors);
+
+    /** Call ReceiveTick on every actor NumFrames times from C++, the way the engine ticks them */
+    UFUNCTION(BlueprintCallable)
+    static void TickActors(const TArray<AActor*>& Actors, const int32 NumFrames);
+
+    /** Run the batched PrePhysics tick of the world NumFrames times, recording the time spent per module */
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+    static void TickActorsBatched(UObject* WorldContextObject, const int32 NumFrames);
+
+    /** Run the coroutine scheduler of the lua env NumFrames times, the way the core ticker does */
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+    static void TickCoroutines(UObject* WorldContextObject, const int32 NumFrames, const float DeltaSeconds);
+
+    /** Record the hits and misses of the coroutine pool of the lua env */
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+    static void RecordCoroutinePool(UObject* WorldContextObject);
+
+    /** Compare the watched properties of the lua env NumFrames times, the way the core ticker does */
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+    static void TickPropertyWatchers(UObject* WorldContextObject, const int32 NumFrames);
+
+    /** Run the latent actions of the world NumFrames times, the way the world tick does */
+    UFUNCTION(BlueprintCallable, meta=(WorldContext="WorldContextObject"))
+    static void TickLatentActions(UObject* WorldContextObject, const int32 NumFrames, const float DeltaSeconds);
+
+    /** Require a module in NumEnvs new lua envs, timing it and recording the memory they use together */
+    UFUNCTION(BlueprintCallable)
+    static void RequireInEnvs(const FString& ModuleName, const int32 NumEnvs, const bool bSharedData);
+
+    /** Start NumEnvs new lua envs by running the startup module, then from a snapshot of it */
+    UFUNCTION(BlueprintCallable)
+    static void StartEnvs(const FString& StartupModuleName, const int32 NumEnvs);
+
+    /** Start a new lua env and require NumModules generated modules from the file system, with or without preloading them */
+    UFUNCTION(BlueprintCallable)
+    static void RequireModules(const int32 NumModules, const bool bPreload);
+
+    /** Start a new lua env and require NumModules generated modules packed into a script archive */
+    UFUNCTION(BlueprintCallable)
+    static void RequireModulesFromArchive(const int32 NumModules, const bool bCompress);
+
 private:
+    static TArray<FString> GenerateModules(const FString& PackageDir, const int32 NumModules);
+
     static TArray<FString> Messages;
     static double StartTime;
     static FString StartTitle;
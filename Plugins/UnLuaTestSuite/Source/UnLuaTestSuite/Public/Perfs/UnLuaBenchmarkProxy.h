@@ -15,6 +15,7 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+#include "UnLuaInterface.h"
 #include "UnLuaBenchmarkProxy.generated.h"
 
 UCLASS()
@@ -83,3 +84,54 @@ public:
     UPROPERTY(BlueprintReadWrite)
     TArray<FVector> PredictedPositions;
 };
+
+UCLASS()
+class AUnLuaBenchmarkBoundProxy : public AUnLuaBenchmarkProxy, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override
+    {
+        return TEXT("Tests.Benchmark.SpawnBindBenchmarkActor");
+    }
+};
+
+/** Bound to a module with '__LazyBind' to compare with eager binding */
+UCLASS()
+class AUnLuaBenchmarkLazyProxy : public AUnLuaBenchmarkProxy, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override
+    {
+        return TEXT("Tests.Benchmark.SpawnBindBenchmarkLazyActor");
+    }
+};
+
+/** Bound to a module overriding ReceiveTick */
+UCLASS()
+class AUnLuaBenchmarkTickProxy : public AUnLuaBenchmarkProxy, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override
+    {
+        return TEXT("Tests.Benchmark.TickBenchmarkActor");
+    }
+};
+
+/** Bound to a module declaring '__TickGroup', ticked in batches instead of through ReceiveTick */
+UCLASS()
+class AUnLuaBenchmarkBatchTickProxy : public AUnLuaBenchmarkProxy, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override
+    {
+        return TEXT("Tests.Benchmark.TickBenchmarkBatchActor");
+    }
+};
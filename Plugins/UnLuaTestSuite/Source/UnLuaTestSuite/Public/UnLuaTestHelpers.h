@@ -21,6 +21,7 @@
 #include "GameFramework/Character.h"
 #include "UnLua.h"
 #include "UnLuaInterface.h"
+#include "LuaModuleLocator.h"
 #include "UnLuaTestHelpers.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FUnLuaTestSimpleEvent);
@@ -151,6 +152,72 @@ public:
     TSubclassOf<UUserWidget> TestForIssue445(int32 Index);
 };
 
+UCLASS()
+class UNLUATESTSUITE_API AUnLuaTestBatchTickActor : public AActor, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override
+    {
+        return TEXT("Tests.Specs.TickRegistry.BatchTickActor");
+    }
+};
+
+UCLASS()
+class UNLUATESTSUITE_API AUnLuaTestIntervalTickActor : public AActor, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override
+    {
+        return TEXT("Tests.Specs.TickRegistry.IntervalTickActor");
+    }
+};
+
+UCLASS()
+class UNLUATESTSUITE_API AUnLuaTestLazyTickActor : public AActor, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString GetModuleName_Implementation() const override
+    {
+        return TEXT("Tests.Specs.TickRegistry.LazyTickActor");
+    }
+};
+
+UCLASS()
+class UNLUATESTSUITE_API UUnLuaTestBindStub : public UObject, public IUnLuaInterface
+{
+    GENERATED_BODY()
+
+public:
+    UFUNCTION(BlueprintImplementableEvent)
+    int32 GetId();
+};
+
+/** Answers with ModuleName and counts the calls, the env asks the CDO of the configured locator class */
+UCLASS()
+class UNLUATESTSUITE_API UUnLuaTestModuleLocator : public ULuaModuleLocator
+{
+    GENERATED_BODY()
+
+public:
+    virtual FString Locate(const UObject* Object) override
+    {
+        NumLocates++;
+        return ModuleName;
+    }
+
+    virtual bool IsClassBased() const override { return bClassBased; }
+
+    FString ModuleName;
+    int32 NumLocates = 0;
+    bool bClassBased = true;
+};
+
 USTRUCT(BlueprintType)
 struct UNLUATESTSUITE_API FUnLuaTestTableRow : public FTableRowBase
 {